@@ -0,0 +1,62 @@
+#include <chrono>
+#include <iostream>
+#include <vector>
+#include "../include/linear_algebra/batched.hpp"
+
+using namespace linear_algebra;
+
+template<typename Func>
+double best_seconds(int repetitions, Func&& func) {
+    double best = 1e30;
+    for (int r = 0; r < repetitions; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        func();
+        auto stop = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(stop - start).count());
+    }
+    return best;
+}
+
+template<int N>
+void run(std::size_t count) {
+    std::vector<Matrix<double, N, N>> objects(count);
+    MatrixBatch<double, N, N> batch(count);
+    for (std::size_t b = 0; b < count; ++b) {
+        for (int i = 0; i < N; ++i) {
+            for (int j = 0; j < N; ++j) {
+                objects[b](i, j) = (i == j ? 4.0 : 0.0) + 0.01 * static_cast<double>((b + 3 * i + 7 * j) % 11);
+            }
+        }
+        batch.set(b, objects[b]);
+    }
+
+    // Both sides allocate their results inside the timed region, as the batched calls do
+    volatile double sink = 0.0;
+    double t_object_mul = best_seconds(5, [&] {
+        std::vector<Matrix<double, N, N>> object_results(count);
+        for (std::size_t b = 0; b < count; ++b) {
+            object_results[b] = objects[b] * objects[b];
+        }
+        sink = object_results[0](0, 0);
+    });
+    double t_batch_mul = best_seconds(5, [&] { sink = multiply(batch, batch)(0, 0, 0); });
+    double t_object_inv = best_seconds(5, [&] {
+        std::vector<Matrix<double, N, N>> object_results(count);
+        for (std::size_t b = 0; b < count; ++b) {
+            object_results[b] = objects[b].inverse();
+        }
+        sink = object_results[0](0, 0);
+    });
+    double t_batch_inv = best_seconds(5, [&] { sink = inverse(batch)(0, 0, 0); });
+
+    std::cout << N << "x" << N << "\t" << count << "\t" << t_object_mul * 1e3 << "\t" << t_batch_mul * 1e3 << "\t"
+              << t_object_inv * 1e3 << "\t" << t_batch_inv * 1e3 << std::endl;
+}
+
+int main() {
+    std::cout << "Batched small-matrix operations, milliseconds" << std::endl;
+    std::cout << "size\tcount\tmul\tbatch_mul\tinverse\tbatch_inverse" << std::endl;
+    run<3>(1000000);
+    run<4>(1000000);
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include "../include/linear_algebra/matrix.hpp"
+
+using namespace linear_algebra;
+
+template<typename Func>
+double best_seconds(int repetitions, Func&& func) {
+    double best = 1e30;
+    for (int r = 0; r < repetitions; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        func();
+        auto stop = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(stop - start).count());
+    }
+    return best;
+}
+
+// Compare r = a + b * 2 - c evaluated eagerly (one temporary per operator, as before)
+// against the fused expression. Bytes counted are the reads and writes each strategy performs.
+template<size_t N>
+void vector_case() {
+    auto a = std::make_unique<Vector<float, N>>();
+    auto b = std::make_unique<Vector<float, N>>();
+    auto c = std::make_unique<Vector<float, N>>();
+    auto r = std::make_unique<Vector<float, N>>();
+    auto t1 = std::make_unique<Vector<float, N>>();
+    auto t2 = std::make_unique<Vector<float, N>>();
+    for (size_t i = 0; i < N; ++i) {
+        (*a)[i] = float(i % 7);
+        (*b)[i] = float(i % 5);
+        (*c)[i] = float(i % 3);
+    }
+
+    double eager = best_seconds(20, [&] {
+        *t1 = *b * 2.0f;
+        *t2 = *a + *t1;
+        *r = *t2 - *c;
+    });
+    double fused = best_seconds(20, [&] {
+        *r = *a + *b * 2.0f - *c;
+    });
+
+    const double eager_bytes = 8.0 * N * sizeof(float);
+    const double fused_bytes = 4.0 * N * sizeof(float);
+    std::cout << "Vector<float, " << N << ">\t" << eager * 1e3 << " ms\t" << fused * 1e3 << " ms\t"
+              << eager_bytes / 1e6 << " MB\t" << fused_bytes / 1e6 << " MB\t" << eager / fused << std::endl;
+}
+
+template<int N>
+void matrix_case() {
+    auto a = std::make_unique<Matrix<float, N, N>>();
+    auto b = std::make_unique<Matrix<float, N, N>>();
+    auto c = std::make_unique<Matrix<float, N, N>>();
+    auto r = std::make_unique<Matrix<float, N, N>>();
+    auto t1 = std::make_unique<Matrix<float, N, N>>();
+    auto t2 = std::make_unique<Matrix<float, N, N>>();
+    for (int i = 0; i < N; ++i) {
+        for (int j = 0; j < N; ++j) {
+            (*a)(i, j) = float((i + j) % 7);
+            (*b)(i, j) = float((i * j) % 5);
+            (*c)(i, j) = float(i % 3);
+        }
+    }
+
+    double eager = best_seconds(20, [&] {
+        *t1 = *b * 2.0f;
+        *t2 = *a + *t1;
+        *r = *t2 - *c;
+    });
+    double fused = best_seconds(20, [&] {
+        *r = *a + *b * 2.0f - *c;
+    });
+
+    const double elements = double(N) * N;
+    const double eager_bytes = 8.0 * elements * sizeof(float);
+    const double fused_bytes = 4.0 * elements * sizeof(float);
+    std::cout << "Matrix<float, " << N << ", " << N << ">\t" << eager * 1e3 << " ms\t" << fused * 1e3 << " ms\t"
+              << eager_bytes / 1e6 << " MB\t" << fused_bytes / 1e6 << " MB\t" << eager / fused << std::endl;
+}
+
+int main() {
+    std::cout << "r = a + b * 2 - c" << std::endl;
+    std::cout << "type\teager\tfused\teager traffic\tfused traffic\tspeedup" << std::endl;
+    vector_case<1 << 12>();
+    vector_case<1 << 16>();
+    vector_case<1 << 20>();
+    vector_case<1 << 22>();
+    matrix_case<64>();
+    matrix_case<256>();
+    matrix_case<1024>();
+    matrix_case<2048>();
+    return 0;
+}
@@ -0,0 +1,123 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "../include/linear_algebra/gemm.hpp"
+
+using namespace linear_algebra;
+
+// The i-j-k loop previously used by Matrix operator*
+template<typename T>
+void naive_multiply(int n, const T* a, const T* b, T* c) {
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            for (int k = 0; k < n; ++k) {
+                c[i * n + j] += a[i * n + k] * b[k * n + j];
+            }
+        }
+    }
+}
+
+template<typename Func>
+double best_seconds(int repetitions, Func&& func) {
+    double best = 1e30;
+    for (int r = 0; r < repetitions; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        func();
+        auto stop = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(stop - start).count());
+    }
+    return best;
+}
+
+template<typename T>
+void run(const char* type_name) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<T> dist(-1, 1);
+
+    std::cout << type_name << std::endl;
+    std::cout << "size\tnaive GFLOP/s\tblocked GFLOP/s\tspeedup\tmax diff" << std::endl;
+    for (int n : {32, 64, 128, 256, 512, 1024}) {
+        std::vector<T> a(n * n), b(n * n), c_naive(n * n), c_blocked(n * n);
+        for (auto& x : a) x = dist(rng);
+        for (auto& x : b) x = dist(rng);
+
+        const int repetitions = n <= 256 ? 5 : 2;
+        const double flops = 2.0 * n * n * n;
+
+        double naive = best_seconds(repetitions, [&] {
+            std::fill(c_naive.begin(), c_naive.end(), T(0));
+            naive_multiply(n, a.data(), b.data(), c_naive.data());
+        });
+        double blocked = best_seconds(repetitions, [&] {
+            std::fill(c_blocked.begin(), c_blocked.end(), T(0));
+            detail::gemm(n, n, n, a.data(), n, b.data(), n, c_blocked.data(), n);
+        });
+
+        double max_diff = 0;
+        for (int i = 0; i < n * n; ++i) {
+            max_diff = std::max(max_diff, static_cast<double>(std::abs(c_naive[i] - c_blocked[i])));
+        }
+
+        std::cout << n << "\t" << flops / naive * 1e-9 << "\t" << flops / blocked * 1e-9
+                  << "\t" << naive / blocked << "\t" << max_diff << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+// A^T B through an explicit transpose against the flagged kernel that reads A in place,
+// and the transpose kernel itself against a plain strided loop
+template<typename T>
+void run_transposed(const char* type_name) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<T> dist(-1, 1);
+
+    std::cout << type_name << " A^T B" << std::endl;
+    std::cout << "size\ttranspose+gemm GFLOP/s\tflagged GFLOP/s\tnaive transpose GB/s\ttranspose GB/s\tmax diff" << std::endl;
+    for (int n : {64, 256, 512, 1024, 2048}) {
+        std::vector<T> a(n * n), b(n * n), at(n * n), c_explicit(n * n), c_flagged(n * n);
+        for (auto& x : a) x = dist(rng);
+        for (auto& x : b) x = dist(rng);
+
+        const int repetitions = n <= 256 ? 5 : 2;
+        const double flops = 2.0 * n * n * n;
+        const double bytes = 2.0 * n * n * sizeof(T);
+
+        double explicit_seconds = best_seconds(repetitions, [&] {
+            std::fill(c_explicit.begin(), c_explicit.end(), T(0));
+            detail::transpose(n, n, a.data(), n, at.data(), n);
+            detail::gemm(n, n, n, at.data(), n, b.data(), n, c_explicit.data(), n);
+        });
+        double flagged = best_seconds(repetitions, [&] {
+            std::fill(c_flagged.begin(), c_flagged.end(), T(0));
+            detail::gemm(Transpose::Yes, Transpose::No, n, n, n, a.data(), n, b.data(), n, c_flagged.data(), n);
+        });
+        double naive_transpose = best_seconds(repetitions, [&] {
+            for (int i = 0; i < n; ++i) {
+                for (int j = 0; j < n; ++j) {
+                    at[j * n + i] = a[i * n + j];
+                }
+            }
+        });
+        double transpose = best_seconds(repetitions, [&] {
+            detail::transpose(n, n, a.data(), n, at.data(), n);
+        });
+
+        double max_diff = 0;
+        for (int i = 0; i < n * n; ++i) {
+            max_diff = std::max(max_diff, static_cast<double>(std::abs(c_explicit[i] - c_flagged[i])));
+        }
+
+        std::cout << n << "\t" << flops / explicit_seconds * 1e-9 << "\t" << flops / flagged * 1e-9
+                  << "\t" << bytes / naive_transpose * 1e-9 << "\t" << bytes / transpose * 1e-9 << "\t" << max_diff << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+int main() {
+    run<float>("float");
+    run<double>("double");
+    run_transposed<double>("double");
+    return 0;
+}
@@ -0,0 +1,159 @@
+//Contains implementation for the microbenchmark harness shared by the benchmark suite
+
+#ifndef BENCH_HARNESS_HPP
+#define BENCH_HARNESS_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace bench {
+
+    // Keeps the compiler from discarding a result or hoisting its computation out of the timing loop
+    template<typename T>
+    inline void do_not_optimize(const T& value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    struct Options {
+        // Timed samples per benchmark; median and p99 are taken over these
+        std::size_t samples = 51;
+        // Each sample repeats the operation until it runs at least this long, so short operations
+        // are not dominated by clock resolution
+        double min_sample_seconds = 1e-3;
+        // Untimed time spent running the operation first (caches, page faults, CPU frequency)
+        double warmup_seconds = 0.02;
+        // Only run benchmarks whose name contains this string
+        std::string filter;
+    };
+
+    struct Result {
+        std::string name;
+        std::string type;
+        std::size_t size = 0;
+        std::size_t samples = 0;
+        std::size_t iterations = 0;    // operations per sample
+        double median_ns = 0.0;        // per operation
+        double p99_ns = 0.0;
+        double gflops = 0.0;           // at the median, 0 when no flop count applies
+        double gbytes = 0.0;           // GB/s of compulsory traffic at the median, 0 when not applicable
+    };
+
+    class Suite {
+    public:
+        explicit Suite(const Options& options = {}) : options(options) {}
+
+        // Times func, one call being one operation of the given flop and byte counts
+        template<typename Func>
+        void run(const std::string& name, const std::string& type, std::size_t size, double flops, double bytes, Func&& func);
+
+        const std::vector<Result>& results() const { return all; }
+
+        // Tab-separated results, one row per benchmark, '#' lines are comments
+        void write(std::ostream& os) const;
+
+        // Per-benchmark median ratios against results written earlier by write()
+        void compare(std::istream& baseline, std::ostream& os) const;
+
+    private:
+        Options options;
+        std::vector<Result> all;
+    };
+
+    template<typename Func>
+    void Suite::run(const std::string& name, const std::string& type, std::size_t size, double flops, double bytes, Func&& func) {
+        if (!options.filter.empty() && name.find(options.filter) == std::string::npos) {
+            return;
+        }
+        using clock = std::chrono::steady_clock;
+        auto seconds_since = [](clock::time_point start) { return std::chrono::duration<double>(clock::now() - start).count(); };
+
+        // Warm up, then size the samples from the average cost seen during warmup
+        std::size_t warmup_calls = 0;
+        const clock::time_point warmup_start = clock::now();
+        do {
+            func();
+            ++warmup_calls;
+        } while (seconds_since(warmup_start) < options.warmup_seconds);
+        const double per_call = seconds_since(warmup_start) / static_cast<double>(warmup_calls);
+        const std::size_t iterations = std::max<std::size_t>(1, static_cast<std::size_t>(options.min_sample_seconds / per_call));
+
+        std::vector<double> times;
+        times.reserve(options.samples);
+        for (std::size_t s = 0; s < options.samples; ++s) {
+            const clock::time_point start = clock::now();
+            for (std::size_t i = 0; i < iterations; ++i) {
+                func();
+            }
+            times.push_back(seconds_since(start) * 1e9 / static_cast<double>(iterations));
+        }
+        std::sort(times.begin(), times.end());
+
+        Result result;
+        result.name = name;
+        result.type = type;
+        result.size = size;
+        result.samples = times.size();
+        result.iterations = iterations;
+        result.median_ns = times[times.size() / 2];
+        result.p99_ns = times[std::min(times.size() - 1, (times.size() * 99) / 100)];
+        result.gflops = flops / result.median_ns;
+        result.gbytes = bytes / result.median_ns;
+        all.push_back(result);
+
+        std::cout << std::left << std::setw(20) << name << std::setw(8) << type << std::right << std::setw(8) << size
+                  << std::setw(14) << std::fixed << std::setprecision(1) << result.median_ns << " ns"
+                  << std::setw(14) << result.p99_ns << " ns" << std::setw(10) << std::setprecision(2) << result.gflops
+                  << " GFLOP/s" << std::setw(10) << result.gbytes << " GB/s" << std::endl;
+    }
+
+    inline void Suite::write(std::ostream& os) const {
+        os << "# name\ttype\tsize\tsamples\titerations\tmedian_ns\tp99_ns\tgflops\tgbytes_per_s\n";
+        for (const Result& r : all) {
+            os << r.name << '\t' << r.type << '\t' << r.size << '\t' << r.samples << '\t' << r.iterations << '\t'
+               << std::setprecision(6) << std::defaultfloat << r.median_ns << '\t' << r.p99_ns << '\t' << r.gflops
+               << '\t' << r.gbytes << '\n';
+        }
+    }
+
+    inline void Suite::compare(std::istream& baseline, std::ostream& os) const {
+        std::map<std::tuple<std::string, std::string, std::size_t>, double> previous;
+        std::string line;
+        while (std::getline(baseline, line)) {
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+            std::istringstream fields(line);
+            Result r;
+            if (fields >> r.name >> r.type >> r.size >> r.samples >> r.iterations >> r.median_ns) {
+                previous[{r.name, r.type, r.size}] = r.median_ns;
+            }
+        }
+
+        // Differences within the noise of a quiet machine are not reported as changes
+        constexpr double threshold = 0.05;
+        os << "\nComparison with baseline (old median / new median, above 1 is faster)" << std::endl;
+        for (const Result& r : all) {
+            auto it = previous.find({r.name, r.type, r.size});
+            if (it == previous.end()) {
+                continue;
+            }
+            const double speedup = it->second / r.median_ns;
+            const char* verdict = speedup < 1.0 - threshold ? "  slower" : speedup > 1.0 + threshold ? "  faster" : "";
+            os << std::left << std::setw(20) << r.name << std::setw(8) << r.type << std::right << std::setw(8) << r.size
+               << std::setw(10) << std::fixed << std::setprecision(3) << speedup << verdict << std::endl;
+        }
+    }
+
+}
+
+#endif
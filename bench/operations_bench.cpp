@@ -0,0 +1,191 @@
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../include/linear_algebra/matrix.hpp"
+#include "../include/linear_algebra/vector.hpp"
+#include "../include/linear_algebra/auto_differentiation.hpp"
+#include "../include/linear_algebra/reverse_differentiation.hpp"
+#include "harness.hpp"
+
+using namespace linear_algebra;
+
+template<typename T> const char* type_name();
+template<> const char* type_name<float>() { return "float"; }
+template<> const char* type_name<double>() { return "double"; }
+
+// Well-conditioned random matrix (diagonally dominant) so inverse and solve never hit singularity
+template<typename T, int N>
+std::unique_ptr<Matrix<T, N, N>> random_matrix(std::mt19937& rng) {
+    std::uniform_real_distribution<T> dist(-1, 1);
+    auto a = std::make_unique<Matrix<T, N, N>>();
+    for (int i = 0; i < N; ++i) {
+        for (int j = 0; j < N; ++j) {
+            (*a)(i, j) = dist(rng) / static_cast<T>(N) + (i == j ? T(2) : T(0));
+        }
+    }
+    return a;
+}
+
+// Multiply, transpose, inverse, determinant and solve for one element type and size
+template<typename T, int N>
+void matrix_operations(bench::Suite& suite, std::mt19937& rng) {
+    const auto a = random_matrix<T, N>(rng);
+    const auto b = random_matrix<T, N>(rng);
+    auto rhs = std::make_unique<Vector<T, N>>();
+    for (int i = 0; i < N; ++i) {
+        (*rhs)[i] = static_cast<T>(i % 7) - T(3);
+    }
+    const double n = N;
+    const double element = sizeof(T);
+
+    suite.run("multiply", type_name<T>(), N, 2.0 * n * n * n, 3.0 * n * n * element, [&] {
+        bench::do_not_optimize(*a * *b);
+    });
+    suite.run("transpose", type_name<T>(), N, 0.0, 2.0 * n * n * element, [&] {
+        bench::do_not_optimize(a->transpose());
+    });
+    suite.run("transpose_multiply", type_name<T>(), N, 2.0 * n * n * n, 3.0 * n * n * element, [&] {
+        bench::do_not_optimize(transpose_multiply(*a, *b));
+    });
+    suite.run("inverse", type_name<T>(), N, 2.0 * n * n * n, 2.0 * n * n * element, [&] {
+        bench::do_not_optimize(a->inverse());
+    });
+    suite.run("determinant", type_name<T>(), N, 2.0 / 3.0 * n * n * n, n * n * element, [&] {
+        bench::do_not_optimize(a->determinant());
+    });
+    // LU factorization plus the two triangular solves
+    suite.run("solve", type_name<T>(), N, 2.0 / 3.0 * n * n * n + 2.0 * n * n, (n * n + 2.0 * n) * element, [&] {
+        bench::do_not_optimize(a->solve_linear_equations(*rhs));
+    });
+}
+
+// Dot product and Euclidean norm, both memory-bound once the vectors leave cache
+template<typename T, std::size_t N>
+void vector_operations(bench::Suite& suite) {
+    auto x = std::make_unique<Vector<T, N>>();
+    auto y = std::make_unique<Vector<T, N>>();
+    for (std::size_t i = 0; i < N; ++i) {
+        (*x)[i] = static_cast<T>(1) / static_cast<T>(i + 1);
+        (*y)[i] = static_cast<T>(i % 5) - T(2);
+    }
+    const double n = static_cast<double>(N);
+    suite.run("dot", type_name<T>(), N, 2.0 * n, 2.0 * n * sizeof(T), [&] {
+        bench::do_not_optimize(x->dot(*y));
+    });
+    suite.run("norm", type_name<T>(), N, 2.0 * n, n * sizeof(T), [&] {
+        bench::do_not_optimize(x->magnitude());
+    });
+}
+
+// Forward mode: the dot product of n dual numbers carrying K tangents each. A product costs
+// 1 + 3K flops and the accumulation 1 + K.
+template<typename T, std::size_t K>
+void forward_ad(bench::Suite& suite, std::size_t n) {
+    std::vector<ADVariable<T, K>> x(n), y(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        x[i] = ADVariable<T, K>::seed(static_cast<T>(i % 11) * T(0.1), i % K);
+        y[i] = ADVariable<T, K>(static_cast<T>(i % 13) * T(0.2));
+    }
+    const std::string name = "forward_ad_" + std::to_string(K);
+    const double flops = static_cast<double>(n) * (2.0 + 4.0 * static_cast<double>(K));
+    suite.run(name, type_name<T>(), n, flops, 2.0 * static_cast<double>(n) * sizeof(ADVariable<T, K>), [&] {
+        ADVariable<T, K> sum;
+        for (std::size_t i = 0; i < n; ++i) {
+            sum += x[i] * y[i];
+        }
+        bench::do_not_optimize(sum);
+    });
+}
+
+// Reverse mode: record f(w) = sum(w_i^2) / 2 on a tape and sweep it backwards for the gradient.
+// The cost is dominated by tape bookkeeping rather than arithmetic, so no flop rate is reported.
+template<typename T>
+void reverse_ad(bench::Suite& suite, std::size_t n) {
+    Tape<T> tape;
+    suite.run("reverse_ad", type_name<T>(), n, 0.0, 0.0, [&] {
+        tape.clear();
+        std::vector<ReverseVariable<T>> w;
+        w.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            w.push_back(tape.variable(static_cast<T>(i % 17) * T(0.01)));
+        }
+        ReverseVariable<T> loss = dot(w, w) * T(0.5);
+        bench::do_not_optimize(tape.gradient(loss));
+    });
+}
+
+template<typename T>
+void run(bench::Suite& suite) {
+    std::mt19937 rng(42);
+    matrix_operations<T, 4>(suite, rng);
+    matrix_operations<T, 16>(suite, rng);
+    matrix_operations<T, 64>(suite, rng);
+    matrix_operations<T, 256>(suite, rng);
+
+    vector_operations<T, 16>(suite);
+    vector_operations<T, 1024>(suite);
+    vector_operations<T, 65536>(suite);
+
+    forward_ad<T, 1>(suite, 4096);
+    forward_ad<T, 8>(suite, 4096);
+    reverse_ad<T>(suite, 4096);
+}
+
+// Usage: operations_bench [--output FILE] [--baseline FILE] [--samples N] [--filter NAME]
+int main(int argc, char** argv) {
+    bench::Options options;
+    std::string output;
+    std::string baseline;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const std::string flag = argv[i];
+        if (flag == "--output") {
+            output = argv[i + 1];
+        } else if (flag == "--baseline") {
+            baseline = argv[i + 1];
+        } else if (flag == "--samples") {
+            options.samples = static_cast<std::size_t>(std::strtoul(argv[i + 1], nullptr, 10));
+        } else if (flag == "--filter") {
+            options.filter = argv[i + 1];
+        } else {
+            std::cerr << "Unknown option " << flag << std::endl;
+            return 1;
+        }
+    }
+    if (options.samples == 0) {
+        std::cerr << "Number of samples must be positive" << std::endl;
+        return 1;
+    }
+
+    // The baseline is read before anything is written, so --baseline and --output may name the same
+    // file: the run is compared against the previous results and then replaces them
+    std::stringstream baseline_results;
+    if (!baseline.empty()) {
+        std::ifstream file(baseline);
+        if (!file) {
+            std::cerr << "Cannot open baseline " << baseline << std::endl;
+            return 1;
+        }
+        baseline_results << file.rdbuf();
+    }
+
+    bench::Suite suite(options);
+    std::cout << "operation     type        size        median ns           p99 ns      throughput" << std::endl;
+    run<float>(suite);
+    run<double>(suite);
+
+    if (!output.empty()) {
+        std::ofstream file(output);
+        suite.write(file);
+        std::cout << "\nResults written to " << output << std::endl;
+    }
+    if (!baseline.empty()) {
+        suite.compare(baseline_results, std::cout);
+    }
+    return 0;
+}
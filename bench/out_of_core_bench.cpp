@@ -0,0 +1,52 @@
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../include/linear_algebra/out_of_core.hpp"
+
+using namespace linear_algebra;
+
+void write_matrix(const std::string& path, std::size_t n) {
+    MatrixFileWriter<double> writer(path, n, n);
+    std::vector<double> row(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            row[j] = static_cast<double>((i * 7 + j * 3) % 13) * 0.1;
+        }
+        writer.write(row.data(), n);
+    }
+    writer.close();
+}
+
+int main() {
+    const auto dir = std::filesystem::temp_directory_path();
+    const std::string a_path = (dir / "linear_algebra_ooc_bench_a.bin").string();
+    const std::string b_path = (dir / "linear_algebra_ooc_bench_b.bin").string();
+    const std::string c_path = (dir / "linear_algebra_ooc_bench_c.bin").string();
+
+    std::cout << "Out-of-core multiply, n x n doubles, seconds" << std::endl;
+    std::cout << "n\tbudget_MiB\ttile\tprefetch\ttotal\twaiting" << std::endl;
+    for (std::size_t n : {1024, 2048}) {
+        write_matrix(a_path, n);
+        write_matrix(b_path, n);
+        for (std::size_t budget_mib : {4, 32}) {
+            for (bool prefetch : {false, true}) {
+                OutOfCoreOptions options;
+                options.memory_budget = budget_mib << 20;
+                options.prefetch = prefetch;
+                options.update_checksum = false;
+                const auto start = std::chrono::steady_clock::now();
+                OutOfCoreStats stats = multiply_out_of_core<double>(a_path, b_path, c_path, options);
+                const double total = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                std::cout << n << "\t" << budget_mib << "\t" << stats.tile << "\t" << prefetch << "\t" << total << "\t"
+                          << stats.wait_seconds << std::endl;
+            }
+        }
+    }
+
+    std::filesystem::remove(a_path);
+    std::filesystem::remove(b_path);
+    std::filesystem::remove(c_path);
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include <chrono>
+#include <iostream>
+#include <vector>
+#include "../include/linear_algebra/dynamic_matrix.hpp"
+
+using namespace linear_algebra;
+
+template<typename Func>
+double best_seconds(int repetitions, Func&& func) {
+    double best = 1e30;
+    for (int r = 0; r < repetitions; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        func();
+        auto stop = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(stop - start).count());
+    }
+    return best;
+}
+
+// The serial single-accumulator loop previously used by Vector::dot
+template<typename T>
+T serial_dot(const T* a, const T* b, size_t n) {
+    T result = T();
+    for (size_t i = 0; i < n; ++i) {
+        result += a[i] * b[i];
+    }
+    return result;
+}
+
+const char* level_name(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::AVX512: return "avx512";
+        case SimdLevel::AVX2: return "avx2";
+        case SimdLevel::SSE: return "sse";
+        default: return "scalar";
+    }
+}
+
+template<typename T>
+void run(const char* type_name) {
+    const SimdLevel detected = simd_level();
+    std::cout << type_name << " dot product, GFLOP/s" << std::endl;
+    std::cout << "size\tserial";
+    for (auto level : {SimdLevel::Scalar, SimdLevel::SSE, SimdLevel::AVX2, SimdLevel::AVX512}) {
+        if (level <= detected) {
+            std::cout << "\t" << level_name(level);
+        }
+    }
+    std::cout << std::endl;
+
+    for (size_t n : {256, 4096, 65536, 1 << 20}) {
+        DynamicVector<T> a(n), b(n);
+        for (size_t i = 0; i < n; ++i) {
+            a[i] = T(i % 13) * T(0.25);
+            b[i] = T(i % 7) * T(0.5);
+        }
+        const int repetitions = n < 65536 ? 2000 : 50;
+        volatile T sink = T();
+
+        double serial = best_seconds(repetitions, [&] { sink = serial_dot(a.data_ptr(), b.data_ptr(), n); });
+        std::cout << n << "\t" << 2.0 * n / serial * 1e-9;
+        for (auto level : {SimdLevel::Scalar, SimdLevel::SSE, SimdLevel::AVX2, SimdLevel::AVX512}) {
+            if (level > detected) {
+                continue;
+            }
+            set_simd_level(level);
+            double t = best_seconds(repetitions, [&] { sink = a.dot(b); });
+            std::cout << "\t" << 2.0 * n / t * 1e-9;
+        }
+        set_simd_level(detected);
+        std::cout << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+int main() {
+    std::cout << "Detected instruction set: " << level_name(simd_level()) << std::endl << std::endl;
+    run<float>("float");
+    run<double>("double");
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include <chrono>
+#include <iostream>
+#include <random>
+#include "../include/linear_algebra/sparse.hpp"
+
+using namespace linear_algebra;
+
+template<typename Func>
+double best_seconds(int repetitions, Func&& func) {
+    double best = 1e30;
+    for (int r = 0; r < repetitions; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        func();
+        auto stop = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(stop - start).count());
+    }
+    return best;
+}
+
+// Random n x n matrix with roughly density * n * n nonzeros and a full diagonal
+CooMatrix<double> random_sparse(std::size_t n, double density, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<std::size_t> index(0, n - 1);
+    std::uniform_real_distribution<double> value(-1.0, 1.0);
+    CooMatrix<double> coo(n, n);
+    const std::size_t count = static_cast<std::size_t>(density * n * n);
+    coo.reserve(count + n);
+    for (std::size_t i = 0; i < n; ++i) {
+        coo.add(i, i, 4.0);
+    }
+    for (std::size_t e = 0; e < count; ++e) {
+        coo.add(index(gen), index(gen), value(gen));
+    }
+    return coo;
+}
+
+int main() {
+    const std::size_t n = 2000;
+    DynamicVector<double> x(n, 1.0);
+
+    std::cout << "Matrix-vector product, n = " << n << ", milliseconds" << std::endl;
+    std::cout << "density\tnonzeros\tdense\tcsr\tcsc\tspeedup" << std::endl;
+    for (double density : {0.0005, 0.005, 0.05, 0.2}) {
+        CsrMatrix<double> csr(random_sparse(n, density, 42));
+        CscMatrix<double> csc(csr);
+        DynamicMatrix<double> dense = csr.to_dense();
+        volatile double sink = 0.0;
+
+        double t_dense = best_seconds(20, [&] { sink = (dense * x)[0]; });
+        double t_csr = best_seconds(20, [&] { sink = (csr * x)[0]; });
+        double t_csc = best_seconds(20, [&] { sink = (csc * x)[0]; });
+        std::cout << density << "\t" << csr.nonzeros() << "\t" << t_dense * 1e3 << "\t" << t_csr * 1e3 << "\t"
+                  << t_csc * 1e3 << "\t" << t_dense / t_csr << std::endl;
+    }
+    std::cout << std::endl;
+
+    const std::size_t m = 1000;
+    std::cout << "Matrix-matrix product, n = " << m << ", milliseconds" << std::endl;
+    std::cout << "density\tnonzeros\tdense\tspgemm\tspeedup\tmax_error" << std::endl;
+    for (double density : {0.0005, 0.005, 0.05}) {
+        CsrMatrix<double> a(random_sparse(m, density, 7));
+        CsrMatrix<double> b(random_sparse(m, density, 11));
+        DynamicMatrix<double> a_dense = a.to_dense();
+        DynamicMatrix<double> b_dense = b.to_dense();
+        DynamicMatrix<double> reference = a_dense * b_dense;
+        CsrMatrix<double> product;
+
+        double t_dense = best_seconds(3, [&] { reference = a_dense * b_dense; });
+        double t_sparse = best_seconds(3, [&] { product = a * b; });
+        DynamicMatrix<double> difference = product.to_dense() - reference;
+        double max_error = 0.0;
+        for (std::size_t i = 0; i < m; ++i) {
+            for (std::size_t j = 0; j < m; ++j) {
+                max_error = std::max(max_error, std::abs(difference(i, j)));
+            }
+        }
+        std::cout << density << "\t" << a.nonzeros() << "\t" << t_dense * 1e3 << "\t" << t_sparse * 1e3 << "\t"
+                  << t_dense / t_sparse << "\t" << max_error << std::endl;
+    }
+    return 0;
+}
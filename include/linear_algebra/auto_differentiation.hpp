@@ -3,23 +3,53 @@
 #ifndef AUTO_DIFFERENTIATION_HPP
 #define AUTO_DIFFERENTIATION_HPP
 
+#include <array>
 #include <cmath>
+#include <cstddef>
 #include <functional>
+#include <tuple>
+#include <type_traits>
+#include "profile.hpp"
 
 namespace linear_algebra {
-    // Primary template for ADVariable
-    template <typename T>
+    // Primary template for ADVariable. Forward-mode dual number carrying K tangents, one per
+    // input direction, so a single evaluation propagates K directional derivatives at once
+    // (with K equal to the number of inputs that is a full Jacobian in one pass).
+    template <typename T, std::size_t K = 1>
     class ADVariable {
     public:
+        ADVariable() : value(), derivatives{} {}
+
+        // Constant: every tangent is zero
+        ADVariable(const T& value) : value(value), derivatives{} {}
+
         ADVariable(const T& value, const T& derivative)
-            : value(value), derivative(derivative) {}
+            : value(value) { derivatives.fill(derivative); }
+
+        ADVariable(const T& value, const std::array<T, K>& derivatives)
+            : value(value), derivatives(derivatives) {}
+
+        // Independent variable seeded with a unit tangent in direction lane
+        static ADVariable seed(const T& value, std::size_t lane) {
+            std::array<T, K> unit{};
+            unit[lane] = T(1);
+            return ADVariable(value, unit);
+        }
 
         T getValue() const { return value; }
-        T getDerivative() const { return derivative; }
+        T getDerivative() const { return derivatives[0]; }
+        T getDerivative(std::size_t lane) const { return derivatives[lane]; }
+        const std::array<T, K>& getDerivatives() const { return derivatives; }
+
+        // Compound assignment, so ADVariable can be the element type of Matrix and Vector
+        ADVariable& operator+=(const ADVariable& other) { return *this = *this + other; }
+        ADVariable& operator-=(const ADVariable& other) { return *this = *this - other; }
+        ADVariable& operator*=(const ADVariable& other) { return *this = *this * other; }
+        ADVariable& operator/=(const ADVariable& other) { return *this = *this / other; }
 
     private:
         T value;
-        T derivative;
+        std::array<T, K> derivatives;
     };
 
     // Specialization for constant ADVariable
@@ -36,58 +66,201 @@ namespace linear_algebra {
         T derivative;
     };
 
-    // Overloaded arithmetic operations for ADVariable
-    template <typename T>
-    ADVariable<T> operator+(const ADVariable<T>& lhs, const ADVariable<T>& rhs) {
-        return ADVariable<T>(lhs.getValue() + rhs.getValue(), lhs.getDerivative() + rhs.getDerivative());
+    namespace detail {
+
+        // Apply the same propagation rule to every tangent lane; K is a compile-time trip count
+        // so the loop unrolls or vectorizes
+        template <typename T, std::size_t K, typename Rule>
+        std::array<T, K> propagate(Rule&& rule) {
+            std::array<T, K> result;
+            for (std::size_t k = 0; k < K; ++k) {
+                result[k] = rule(k);
+            }
+            return result;
+        }
+
     }
 
-    template <typename T>
-    ADVariable<T> operator-(const ADVariable<T>& lhs, const ADVariable<T>& rhs) {
-        return ADVariable<T>(lhs.getValue() - rhs.getValue(), lhs.getDerivative() - rhs.getDerivative());
+    // Overloaded arithmetic operations for ADVariable. Profiled calls (see profile.hpp) report
+    // the shape K x 1, K being the number of tangent lanes.
+    template <typename T, std::size_t K>
+    ADVariable<T, K> operator+(const ADVariable<T, K>& lhs, const ADVariable<T, K>& rhs) {
+        LINEAR_ALGEBRA_PROFILE_OP("ad_add", K, 1, 1 + K, 3 * sizeof(ADVariable<T, K>));
+        const auto& dl = lhs.getDerivatives();
+        const auto& dr = rhs.getDerivatives();
+        return ADVariable<T, K>(lhs.getValue() + rhs.getValue(), detail::propagate<T, K>([&](std::size_t k) { return dl[k] + dr[k]; }));
     }
 
-    template <typename T>
-    ADVariable<T> operator*(const ADVariable<T>& lhs, const ADVariable<T>& rhs) {
-        return ADVariable<T>(lhs.getValue() * rhs.getValue(), lhs.getValue() * rhs.getDerivative() + lhs.getDerivative() * rhs.getValue());
+    template <typename T, std::size_t K>
+    ADVariable<T, K> operator-(const ADVariable<T, K>& lhs, const ADVariable<T, K>& rhs) {
+        LINEAR_ALGEBRA_PROFILE_OP("ad_subtract", K, 1, 1 + K, 3 * sizeof(ADVariable<T, K>));
+        const auto& dl = lhs.getDerivatives();
+        const auto& dr = rhs.getDerivatives();
+        return ADVariable<T, K>(lhs.getValue() - rhs.getValue(), detail::propagate<T, K>([&](std::size_t k) { return dl[k] - dr[k]; }));
     }
 
-    template <typename T>
-    ADVariable<T> operator/(const ADVariable<T>& lhs, const ADVariable<T>& rhs) {
-        return ADVariable<T>(lhs.getValue() / rhs.getValue(), (lhs.getDerivative() * rhs.getValue() - lhs.getValue() * rhs.getDerivative()) / (rhs.getValue() * rhs.getValue()));
+    template <typename T, std::size_t K>
+    ADVariable<T, K> operator*(const ADVariable<T, K>& lhs, const ADVariable<T, K>& rhs) {
+        LINEAR_ALGEBRA_PROFILE_OP("ad_multiply", K, 1, 1 + 3 * K, 3 * sizeof(ADVariable<T, K>));
+        const T l = lhs.getValue();
+        const T r = rhs.getValue();
+        const auto& dl = lhs.getDerivatives();
+        const auto& dr = rhs.getDerivatives();
+        return ADVariable<T, K>(l * r, detail::propagate<T, K>([&](std::size_t k) { return l * dr[k] + dl[k] * r; }));
+    }
+
+    template <typename T, std::size_t K>
+    ADVariable<T, K> operator/(const ADVariable<T, K>& lhs, const ADVariable<T, K>& rhs) {
+        LINEAR_ALGEBRA_PROFILE_OP("ad_divide", K, 1, 2 + 4 * K, 3 * sizeof(ADVariable<T, K>));
+        const T l = lhs.getValue();
+        const T r = rhs.getValue();
+        const T r2 = r * r;
+        const auto& dl = lhs.getDerivatives();
+        const auto& dr = rhs.getDerivatives();
+        return ADVariable<T, K>(l / r, detail::propagate<T, K>([&](std::size_t k) { return (dl[k] * r - l * dr[k]) / r2; }));
+    }
+
+    template <typename T, std::size_t K>
+    ADVariable<T, K> operator-(const ADVariable<T, K>& x) {
+        const auto& dx = x.getDerivatives();
+        return ADVariable<T, K>(-x.getValue(), detail::propagate<T, K>([&](std::size_t k) { return -dx[k]; }));
+    }
+
+    // Mixed operations with constants
+    template <typename T, std::size_t K>
+    ADVariable<T, K> operator+(const ADVariable<T, K>& lhs, const std::type_identity_t<T>& rhs) {
+        return ADVariable<T, K>(lhs.getValue() + rhs, lhs.getDerivatives());
+    }
+
+    template <typename T, std::size_t K>
+    ADVariable<T, K> operator+(const std::type_identity_t<T>& lhs, const ADVariable<T, K>& rhs) {
+        return rhs + lhs;
+    }
+
+    template <typename T, std::size_t K>
+    ADVariable<T, K> operator-(const ADVariable<T, K>& lhs, const std::type_identity_t<T>& rhs) {
+        return ADVariable<T, K>(lhs.getValue() - rhs, lhs.getDerivatives());
+    }
+
+    template <typename T, std::size_t K>
+    ADVariable<T, K> operator-(const std::type_identity_t<T>& lhs, const ADVariable<T, K>& rhs) {
+        return -rhs + lhs;
+    }
+
+    template <typename T, std::size_t K>
+    ADVariable<T, K> operator*(const ADVariable<T, K>& lhs, const std::type_identity_t<T>& rhs) {
+        const auto& dl = lhs.getDerivatives();
+        return ADVariable<T, K>(lhs.getValue() * rhs, detail::propagate<T, K>([&](std::size_t k) { return dl[k] * rhs; }));
+    }
+
+    template <typename T, std::size_t K>
+    ADVariable<T, K> operator*(const std::type_identity_t<T>& lhs, const ADVariable<T, K>& rhs) {
+        return rhs * lhs;
+    }
+
+    template <typename T, std::size_t K>
+    ADVariable<T, K> operator/(const ADVariable<T, K>& lhs, const std::type_identity_t<T>& rhs) {
+        return lhs * (T(1) / rhs);
+    }
+
+    template <typename T, std::size_t K>
+    ADVariable<T, K> operator/(const std::type_identity_t<T>& lhs, const ADVariable<T, K>& rhs) {
+        return ADVariable<T, K>(lhs) / rhs;
+    }
+
+    // Comparisons look at the values only (used by pivoting and sign tests)
+    template <typename T, std::size_t K>
+    bool operator==(const ADVariable<T, K>& lhs, const ADVariable<T, K>& rhs) {
+        return lhs.getValue() == rhs.getValue();
+    }
+
+    template <typename T, std::size_t K>
+    auto operator<=>(const ADVariable<T, K>& lhs, const ADVariable<T, K>& rhs) {
+        return lhs.getValue() <=> rhs.getValue();
     }
 
     // Elementary functions with auto-differentiation support
-    template <typename T>
-    ADVariable<T> exp(const ADVariable<T>& x) {
-        return ADVariable<T>(std::exp(x.getValue()), x.getDerivative() * std::exp(x.getValue()));
+    template <typename T, std::size_t K>
+    ADVariable<T, K> exp(const ADVariable<T, K>& x) {
+        LINEAR_ALGEBRA_PROFILE_OP("ad_exp", K, 1, 1 + K, 2 * sizeof(ADVariable<T, K>));
+        const T e = std::exp(x.getValue());
+        const auto& dx = x.getDerivatives();
+        return ADVariable<T, K>(e, detail::propagate<T, K>([&](std::size_t k) { return dx[k] * e; }));
     }
 
-    template <typename T>
-    ADVariable<T> log(const ADVariable<T>& x) {
-        return ADVariable<T>(std::log(x.getValue()), x.getDerivative() / x.getValue());
+    template <typename T, std::size_t K>
+    ADVariable<T, K> log(const ADVariable<T, K>& x) {
+        LINEAR_ALGEBRA_PROFILE_OP("ad_log", K, 1, 1 + K, 2 * sizeof(ADVariable<T, K>));
+        const T inv = T(1) / x.getValue();
+        const auto& dx = x.getDerivatives();
+        return ADVariable<T, K>(std::log(x.getValue()), detail::propagate<T, K>([&](std::size_t k) { return dx[k] * inv; }));
     }
 
-    template <typename T>
-    ADVariable<T> sin(const ADVariable<T>& x) {
-        return ADVariable<T>(std::sin(x.getValue()), x.getDerivative() * std::cos(x.getValue()));
+    template <typename T, std::size_t K>
+    ADVariable<T, K> sin(const ADVariable<T, K>& x) {
+        LINEAR_ALGEBRA_PROFILE_OP("ad_sin", K, 1, 1 + K, 2 * sizeof(ADVariable<T, K>));
+        const T c = std::cos(x.getValue());
+        const auto& dx = x.getDerivatives();
+        return ADVariable<T, K>(std::sin(x.getValue()), detail::propagate<T, K>([&](std::size_t k) { return dx[k] * c; }));
     }
 
-    template <typename T>
-    ADVariable<T> cos(const ADVariable<T>& x) {
-        return ADVariable<T>(std::cos(x.getValue()), -x.getDerivative() * std::sin(x.getValue()));
+    template <typename T, std::size_t K>
+    ADVariable<T, K> cos(const ADVariable<T, K>& x) {
+        LINEAR_ALGEBRA_PROFILE_OP("ad_cos", K, 1, 1 + K, 2 * sizeof(ADVariable<T, K>));
+        const T s = std::sin(x.getValue());
+        const auto& dx = x.getDerivatives();
+        return ADVariable<T, K>(std::cos(x.getValue()), detail::propagate<T, K>([&](std::size_t k) { return -dx[k] * s; }));
+    }
+
+    template <typename T, std::size_t K>
+    ADVariable<T, K> sqrt(const ADVariable<T, K>& x) {
+        LINEAR_ALGEBRA_PROFILE_OP("ad_sqrt", K, 1, 1 + K, 2 * sizeof(ADVariable<T, K>));
+        const T root = std::sqrt(x.getValue());
+        const T scale = T(0.5) / root;
+        const auto& dx = x.getDerivatives();
+        return ADVariable<T, K>(root, detail::propagate<T, K>([&](std::size_t k) { return dx[k] * scale; }));
+    }
+
+    template <typename T, std::size_t K>
+    ADVariable<T, K> abs(const ADVariable<T, K>& x) {
+        return x.getValue() < T(0) ? -x : x;
     }
 
+    // Type traits for ADVariable element types
+    template <typename T>
+    struct is_ad_variable : std::false_type {};
+
+    template <typename T, std::size_t K>
+    struct is_ad_variable<ADVariable<T, K>> : std::true_type {};
+
     // Variadic template function for sum of ADVariable objects
-    template <typename T, typename... Args>
-    ADVariable<T> sum(const ADVariable<T>& first, const Args&... rest) {
-        return (first + ... + ADVariable<T>(rest.getValue(), rest.getDerivative()));
+    template <typename T, std::size_t K, typename... Args>
+    ADVariable<T, K> sum(const ADVariable<T, K>& first, const Args&... rest) {
+        return (first + ... + ADVariable<T, K>(rest.getValue(), rest.getDerivatives()));
     }
 
     // Lambda template for generic transformation of ADVariable objects
-    template <typename T, typename Func>
-    ADVariable<T> transform(const ADVariable<T>& x, Func&& f) {
-        return ADVariable<T>(f(x.getValue()), x.getDerivative() * f(x.getValue()));
+    template <typename T, std::size_t K, typename Func>
+    ADVariable<T, K> transform(const ADVariable<T, K>& x, Func&& f) {
+        const T fx = f(x.getValue());
+        const auto& dx = x.getDerivatives();
+        return ADVariable<T, K>(fx, detail::propagate<T, K>([&](std::size_t k) { return dx[k] * fx; }));
+    }
+
+    // Jacobian of f: R^K -> R^M at point in a single evaluation. f takes a std::array of K
+    // ADVariable<T, K> inputs (input i seeded along lane i) and returns a std::array of M outputs;
+    // row m of the result holds the partial derivatives of output m.
+    template <typename T, std::size_t K, typename Func>
+    auto jacobian(Func&& f, const std::array<T, K>& point) {
+        LINEAR_ALGEBRA_PROFILE_OP("ad_jacobian", K, 1, 0, 0);
+        std::array<ADVariable<T, K>, K> inputs = detail::propagate<ADVariable<T, K>, K>(
+            [&](std::size_t i) { return ADVariable<T, K>::seed(point[i], i); });
+        const auto outputs = f(inputs);
+        std::array<std::array<T, K>, std::tuple_size_v<std::decay_t<decltype(outputs)>>> result;
+        for (std::size_t m = 0; m < result.size(); ++m) {
+            result[m] = outputs[m].getDerivatives();
+        }
+        return result;
     }
 }
 
@@ -0,0 +1,288 @@
+//Contains implementation for batched operations on many small fixed-size matrices
+
+#ifndef BATCHED_HPP
+#define BATCHED_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "memory.hpp"
+#include "matrix.hpp"
+#include "vector.hpp"
+#include "dynamic_vector.hpp"
+#include "decomposition.hpp"
+#include "small_matrix.hpp"
+
+namespace linear_algebra {
+
+    // Structure-of-arrays storage for a batch of Rows x Cols matrices: element (i, j) of every
+    // matrix in the batch is stored contiguously (a "lane"), so one operation applied across the
+    // batch becomes a unit-stride loop that the compiler vectorizes with one batch entry per SIMD lane.
+    // Lanes are padded to a multiple of lane_padding entries and start on cache-line boundaries.
+    template<typename T, int Rows, int Cols>
+    class MatrixBatch {
+    public:
+        static constexpr std::size_t lane_padding = default_alignment / sizeof(T);
+
+        MatrixBatch() = default;
+        explicit MatrixBatch(std::size_t count);
+
+        std::size_t size() const { return count; }
+
+        // Distance between consecutive lanes
+        std::size_t stride() const { return lane_stride; }
+
+        // Element (i, j) of matrix b
+        T& operator()(std::size_t b, int i, int j) { return data[lane_offset(i, j) + b]; }
+        const T& operator()(std::size_t b, int i, int j) const { return data[lane_offset(i, j) + b]; }
+
+        // Element (i, j) of every matrix in the batch
+        T* lane(int i, int j) { return data.data() + lane_offset(i, j); }
+        const T* lane(int i, int j) const { return data.data() + lane_offset(i, j); }
+
+        void set(std::size_t b, const Matrix<T, Rows, Cols>& mat);
+        Matrix<T, Rows, Cols> get(std::size_t b) const;
+
+    private:
+        std::size_t lane_offset(int i, int j) const { return static_cast<std::size_t>(i * Cols + j) * lane_stride; }
+
+        std::size_t count = 0;
+        std::size_t lane_stride = 0;
+        std::vector<T, AlignedAllocator<T>> data;
+    };
+
+    // Structure-of-arrays storage for a batch of N-vectors, component i of every vector contiguous
+    template<typename T, size_t N>
+    class VectorBatch {
+    public:
+        static constexpr std::size_t lane_padding = default_alignment / sizeof(T);
+
+        VectorBatch() = default;
+        explicit VectorBatch(std::size_t count);
+
+        std::size_t size() const { return count; }
+        std::size_t stride() const { return lane_stride; }
+
+        T& operator()(std::size_t b, size_t i) { return data[i * lane_stride + b]; }
+        const T& operator()(std::size_t b, size_t i) const { return data[i * lane_stride + b]; }
+
+        T* lane(size_t i) { return data.data() + i * lane_stride; }
+        const T* lane(size_t i) const { return data.data() + i * lane_stride; }
+
+        void set(std::size_t b, const Vector<T, N>& vec);
+        Vector<T, N> get(std::size_t b) const;
+
+    private:
+        std::size_t count = 0;
+        std::size_t lane_stride = 0;
+        std::vector<T, AlignedAllocator<T>> data;
+    };
+
+    namespace detail {
+
+        // Batch entries processed per pass in the batched kernels
+        constexpr std::size_t batch_chunk = 256;
+
+        inline std::size_t padded_lane_count(std::size_t count, std::size_t padding) {
+            return (count + padding - 1) / padding * padding;
+        }
+
+        template<typename Batch>
+        void check_same_batch_size(const Batch& a, std::size_t other) {
+            if (a.size() != other) {
+                throw std::invalid_argument("Batch sizes do not match");
+            }
+        }
+
+    }
+
+    // MatrixBatch
+    template<typename T, int Rows, int Cols>
+    MatrixBatch<T, Rows, Cols>::MatrixBatch(std::size_t count)
+        : count(count), lane_stride(detail::padded_lane_count(count, lane_padding)),
+          data(static_cast<std::size_t>(Rows * Cols) * lane_stride, T()) {}
+
+    template<typename T, int Rows, int Cols>
+    void MatrixBatch<T, Rows, Cols>::set(std::size_t b, const Matrix<T, Rows, Cols>& mat) {
+        for (int i = 0; i < Rows; ++i) {
+            for (int j = 0; j < Cols; ++j) {
+                (*this)(b, i, j) = mat(i, j);
+            }
+        }
+    }
+
+    template<typename T, int Rows, int Cols>
+    Matrix<T, Rows, Cols> MatrixBatch<T, Rows, Cols>::get(std::size_t b) const {
+        Matrix<T, Rows, Cols> result;
+        for (int i = 0; i < Rows; ++i) {
+            for (int j = 0; j < Cols; ++j) {
+                result(i, j) = (*this)(b, i, j);
+            }
+        }
+        return result;
+    }
+
+    // VectorBatch
+    template<typename T, size_t N>
+    VectorBatch<T, N>::VectorBatch(std::size_t count)
+        : count(count), lane_stride(detail::padded_lane_count(count, lane_padding)), data(N * lane_stride, T()) {}
+
+    template<typename T, size_t N>
+    void VectorBatch<T, N>::set(std::size_t b, const Vector<T, N>& vec) {
+        for (size_t i = 0; i < N; ++i) {
+            (*this)(b, i) = vec[i];
+        }
+    }
+
+    template<typename T, size_t N>
+    Vector<T, N> VectorBatch<T, N>::get(std::size_t b) const {
+        Vector<T, N> result;
+        for (size_t i = 0; i < N; ++i) {
+            result[i] = (*this)(b, i);
+        }
+        return result;
+    }
+
+    // Batched operations. Each loops over the padded lanes so the trip count is a multiple of the
+    // vector width; padding entries are computed and ignored.
+
+    // C[b] = A[b] * B[b]. The batch is processed in chunks of batch_chunk entries so the operand
+    // and result lanes of a chunk stay in L1 while every output lane is accumulated and written once.
+    template<typename T, int Rows, int Inner, int Cols>
+    MatrixBatch<T, Rows, Cols> multiply(const MatrixBatch<T, Rows, Inner>& a, const MatrixBatch<T, Inner, Cols>& b) {
+        detail::check_same_batch_size(a, b.size());
+        MatrixBatch<T, Rows, Cols> result(a.size());
+        const std::size_t lanes = result.stride();
+        for (std::size_t e0 = 0; e0 < lanes; e0 += detail::batch_chunk) {
+            const std::size_t e1 = std::min(lanes, e0 + detail::batch_chunk);
+            for (int i = 0; i < Rows; ++i) {
+                for (int j = 0; j < Cols; ++j) {
+                    T* __restrict out = result.lane(i, j);
+                    const T* __restrict x = a.lane(i, 0);
+                    const T* __restrict y = b.lane(0, j);
+                    for (std::size_t e = e0; e < e1; ++e) {
+                        out[e] = x[e] * y[e];
+                    }
+                    for (int k = 1; k < Inner; ++k) {
+                        x = a.lane(i, k);
+                        y = b.lane(k, j);
+                        for (std::size_t e = e0; e < e1; ++e) {
+                            out[e] += x[e] * y[e];
+                        }
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+    // y[b] = A[b] * x[b]
+    template<typename T, int Rows, int Cols, size_t N>
+    VectorBatch<T, Rows> multiply(const MatrixBatch<T, Rows, Cols>& a, const VectorBatch<T, N>& x) {
+        static_assert(static_cast<size_t>(Cols) == N, "Matrix columns must match vector size");
+        detail::check_same_batch_size(a, x.size());
+        VectorBatch<T, Rows> result(a.size());
+        const std::size_t lanes = result.stride();
+        for (std::size_t e0 = 0; e0 < lanes; e0 += detail::batch_chunk) {
+            const std::size_t e1 = std::min(lanes, e0 + detail::batch_chunk);
+            for (int i = 0; i < Rows; ++i) {
+                T* __restrict out = result.lane(i);
+                const T* __restrict m = a.lane(i, 0);
+                const T* __restrict v = x.lane(0);
+                for (std::size_t e = e0; e < e1; ++e) {
+                    out[e] = m[e] * v[e];
+                }
+                for (int k = 1; k < Cols; ++k) {
+                    m = a.lane(i, k);
+                    v = x.lane(k);
+                    for (std::size_t e = e0; e < e1; ++e) {
+                        out[e] += m[e] * v[e];
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+    // det(A[b]) for every matrix in the batch
+    template<typename T, int N>
+    DynamicVector<T> determinant(const MatrixBatch<T, N, N>& a) {
+        DynamicVector<T> result(a.size());
+        if constexpr (N <= detail::small_matrix_limit) {
+            T* __restrict out = result.data_ptr();
+            for (std::size_t e = 0; e < a.size(); ++e) {
+                out[e] = detail::small_determinant<T, N>([&](int i, int j) { return a.lane(i, j)[e]; });
+            }
+        } else {
+            for (std::size_t e = 0; e < a.size(); ++e) {
+                result[e] = static_cast<T>(a.get(e).determinant());
+            }
+        }
+        return result;
+    }
+
+    // A[b]^-1 for every matrix in the batch. Floating-point sizes up to 4 use the closed-form kernels,
+    // where a singular entry comes out non-finite instead of throwing (check determinant() if that
+    // matters). Larger sizes and integer entries go through Matrix::inverse one entry at a time
+    // (LU, or the exact integer kernel) and throw on a singular one.
+    template<typename T, int N>
+    MatrixBatch<T, N, N> inverse(const MatrixBatch<T, N, N>& a) {
+        MatrixBatch<T, N, N> result(a.size());
+        if constexpr (N <= detail::small_matrix_limit && std::is_floating_point_v<T>) {
+            // Padding lanes beyond size() hold zeros and are left alone
+            for (std::size_t e = 0; e < a.size(); ++e) {
+                detail::small_inverse<T, N>([&](int i, int j) { return a.lane(i, j)[e]; },
+                                            [&](int i, int j, const T& value) { result.lane(i, j)[e] = value; });
+            }
+        } else {
+            for (std::size_t e = 0; e < a.size(); ++e) {
+                result.set(e, a.get(e).inverse());
+            }
+        }
+        return result;
+    }
+
+    // Solve A[b] x[b] = rhs[b] for every entry in the batch
+    template<typename T, int N, size_t M>
+    VectorBatch<T, M> solve(const MatrixBatch<T, N, N>& a, const VectorBatch<T, M>& rhs) {
+        static_assert(static_cast<size_t>(N) == M, "Matrix size must match vector size");
+        detail::check_same_batch_size(a, rhs.size());
+        if constexpr (N <= detail::small_matrix_limit) {
+            // For these sizes applying the closed-form inverse is cheaper than elimination
+            return multiply(inverse(a), rhs);
+        } else {
+            VectorBatch<T, M> result(a.size());
+            for (std::size_t e = 0; e < a.size(); ++e) {
+                result.set(e, LU<T, N>(a.get(e)).solve(rhs.get(e)));
+            }
+            return result;
+        }
+    }
+
+    // Cross products of two batches of 3-vectors
+    template<typename T>
+    VectorBatch<T, 3> cross(const VectorBatch<T, 3>& u, const VectorBatch<T, 3>& v) {
+        detail::check_same_batch_size(u, v.size());
+        VectorBatch<T, 3> result(u.size());
+        const T* __restrict u0 = u.lane(0);
+        const T* __restrict u1 = u.lane(1);
+        const T* __restrict u2 = u.lane(2);
+        const T* __restrict v0 = v.lane(0);
+        const T* __restrict v1 = v.lane(1);
+        const T* __restrict v2 = v.lane(2);
+        T* __restrict r0 = result.lane(0);
+        T* __restrict r1 = result.lane(1);
+        T* __restrict r2 = result.lane(2);
+        for (std::size_t e = 0; e < result.stride(); ++e) {
+            r0[e] = u1[e] * v2[e] - u2[e] * v1[e];
+            r1[e] = u2[e] * v0[e] - u0[e] * v2[e];
+            r2[e] = u0[e] * v1[e] - u1[e] * v0[e];
+        }
+        return result;
+    }
+
+}
+
+#endif
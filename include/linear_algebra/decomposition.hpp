@@ -0,0 +1,1023 @@
+//Contains implementation for matrix decompositions (LU, Cholesky, QR) and the solvers built on them
+
+#ifndef DECOMPOSITION_HPP
+#define DECOMPOSITION_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "matrix.hpp"
+#include "auto_differentiation.hpp"
+#include "parallel.hpp"
+
+namespace linear_algebra {
+
+    namespace detail {
+
+        // In-place LU factorization with partial pivoting of an n x n row-major block.
+        // On return the strictly lower part holds L (unit diagonal implied) and the upper part holds U.
+        // piv[k] is the row that was swapped with row k at step k, sign is the permutation parity.
+        // Returns false if a zero pivot was met; the factorization is still completed column by column.
+        template<typename T>
+        bool lu_factor(T* a, int n, std::ptrdiff_t lda, int* piv, int& sign) {
+            bool regular = true;
+            sign = 1;
+            for (int k = 0; k < n; ++k) {
+                // Pick the largest remaining entry in column k as pivot
+                using std::abs;
+                int p = k;
+                auto max_abs = abs(a[k * lda + k]);
+                for (int i = k + 1; i < n; ++i) {
+                    auto v = abs(a[i * lda + k]);
+                    if (v > max_abs) {
+                        max_abs = v;
+                        p = i;
+                    }
+                }
+                piv[k] = p;
+
+                if (p != k) {
+                    for (int j = 0; j < n; ++j) {
+                        std::swap(a[k * lda + j], a[p * lda + j]);
+                    }
+                    sign = -sign;
+                }
+
+                const T pivot = a[k * lda + k];
+                if (pivot == T(0)) {
+                    regular = false;
+                    continue;
+                }
+
+                // Eliminate below the pivot and update the trailing block row by row,
+                // rows are independent so large trailing blocks are split across threads
+                const T* pivot_row = a + k * lda;
+                const double trailing = static_cast<double>(n - k - 1);
+                parallel_for(k + 1, n, 64, 2.0 * trailing * trailing, [&](std::size_t first, std::size_t last) {
+                    for (int i = static_cast<int>(first); i < static_cast<int>(last); ++i) {
+                        T* row = a + i * lda;
+                        const T l = row[k] / pivot;
+                        row[k] = l;
+                        for (int j = k + 1; j < n; ++j) {
+                            row[j] -= l * pivot_row[j];
+                        }
+                    }
+                });
+            }
+            return regular;
+        }
+
+        // Solve A X = B in place for nrhs right-hand sides stored row-major in b (n x nrhs, leading dimension ldb),
+        // given the factors produced by lu_factor. The factors may be kept in a narrower storage type F,
+        // each one is converted to T as it is read.
+        template<typename T, typename F = T>
+        void lu_solve(const F* lu, int n, std::ptrdiff_t lda, const int* piv, T* b, int nrhs, std::ptrdiff_t ldb) {
+            // Apply the row permutation
+            for (int k = 0; k < n; ++k) {
+                if (piv[k] != k) {
+                    for (int j = 0; j < nrhs; ++j) {
+                        std::swap(b[k * ldb + j], b[piv[k] * ldb + j]);
+                    }
+                }
+            }
+
+            // Columns of B are independent, so blocks of right-hand sides are substituted in parallel
+            parallel_for(0, nrhs, 64, 2.0 * n * n * nrhs, [&](std::size_t first, std::size_t last) {
+                const int j0 = static_cast<int>(first);
+                const int j1 = static_cast<int>(last);
+
+                // Forward substitution with unit lower triangle
+                for (int i = 1; i < n; ++i) {
+                    T* bi = b + i * ldb;
+                    for (int k = 0; k < i; ++k) {
+                        const T l = static_cast<T>(lu[i * lda + k]);
+                        const T* bk = b + k * ldb;
+                        for (int j = j0; j < j1; ++j) {
+                            bi[j] -= l * bk[j];
+                        }
+                    }
+                }
+
+                // Back substitution with upper triangle
+                for (int i = n - 1; i >= 0; --i) {
+                    T* bi = b + i * ldb;
+                    for (int k = i + 1; k < n; ++k) {
+                        const T u = static_cast<T>(lu[i * lda + k]);
+                        const T* bk = b + k * ldb;
+                        for (int j = j0; j < j1; ++j) {
+                            bi[j] -= u * bk[j];
+                        }
+                    }
+                    const T d = static_cast<T>(lu[i * lda + i]);
+                    for (int j = j0; j < j1; ++j) {
+                        bi[j] /= d;
+                    }
+                }
+            });
+        }
+
+        // Overwrite an n x n row-major block with its inverse by Gauss-Jordan elimination with partial
+        // pivoting, using only the n entries of piv as workspace. Same 2n^3 flops as inverting through
+        // LU factors, without the second n x n buffer. Returns false on a zero pivot, in which case
+        // the block holds a partially reduced matrix.
+        template<typename T>
+        bool gauss_jordan_invert(T* a, int n, std::ptrdiff_t lda, int* piv) {
+            for (int k = 0; k < n; ++k) {
+                using std::abs;
+                int p = k;
+                auto max_abs = abs(a[k * lda + k]);
+                for (int i = k + 1; i < n; ++i) {
+                    auto v = abs(a[i * lda + k]);
+                    if (v > max_abs) {
+                        max_abs = v;
+                        p = i;
+                    }
+                }
+                piv[k] = p;
+                if (p != k) {
+                    for (int j = 0; j < n; ++j) {
+                        std::swap(a[k * lda + j], a[p * lda + j]);
+                    }
+                }
+
+                T* pivot_row = a + k * lda;
+                const T pivot = pivot_row[k];
+                if (pivot == T(0)) {
+                    return false;
+                }
+                // Column k of the identity is built in the slot that column k of A vacates
+                pivot_row[k] = T(1);
+                for (int j = 0; j < n; ++j) {
+                    pivot_row[j] /= pivot;
+                }
+
+                parallel_for(0, n, 64, 2.0 * n * n, [&](std::size_t first, std::size_t last) {
+                    for (int i = static_cast<int>(first); i < static_cast<int>(last); ++i) {
+                        if (i == k) {
+                            continue;
+                        }
+                        T* row = a + i * lda;
+                        const T f = row[k];
+                        row[k] = T(0);
+                        for (int j = 0; j < n; ++j) {
+                            row[j] -= f * pivot_row[j];
+                        }
+                    }
+                });
+            }
+            // Row interchanges of A become column interchanges of the inverse, undone in reverse order
+            for (int k = n - 1; k >= 0; --k) {
+                if (piv[k] != k) {
+                    for (int i = 0; i < n; ++i) {
+                        std::swap(a[i * lda + k], a[i * lda + piv[k]]);
+                    }
+                }
+            }
+            return true;
+        }
+
+        // One fraction-free elimination step, out = (a * b - c * d) / e with an exact division.
+        // Returns false if the result does not fit in long long; the products are formed in
+        // 128 bits where the compiler has them, otherwise every partial result is checked.
+        inline bool bareiss_step(long long a, long long b, long long c, long long d, long long e, long long& out) {
+#if defined(__SIZEOF_INT128__)
+            __extension__ typedef __int128 wide;
+            const wide r = (static_cast<wide>(a) * b - static_cast<wide>(c) * d) / e;
+            if (r < std::numeric_limits<long long>::min() || r > std::numeric_limits<long long>::max()) {
+                return false;
+            }
+            out = static_cast<long long>(r);
+            return true;
+#else
+            long long ab, cd, diff;
+            if (__builtin_mul_overflow(a, b, &ab) || __builtin_mul_overflow(c, d, &cd) || __builtin_sub_overflow(ab, cd, &diff)) {
+                return false;
+            }
+            out = diff / e;
+            return true;
+#endif
+        }
+
+        // Exact determinant of an n x n integer block by fraction-free (Bareiss) elimination.
+        // Every division is exact and each intermediate entry is a minor of A, so nothing is rounded.
+        // Returns false if a minor overflows long long, the caller then falls back to floating point.
+        template<typename T>
+        bool integer_determinant(const T* a, int n, std::ptrdiff_t lda, long long& det) {
+            std::vector<long long> m(static_cast<std::size_t>(n) * n);
+            for (int i = 0; i < n; ++i) {
+                for (int j = 0; j < n; ++j) {
+                    m[i * n + j] = static_cast<long long>(a[i * lda + j]);
+                }
+            }
+            bool negate = false;
+            long long previous = 1;
+            for (int k = 0; k < n; ++k) {
+                int p = k;
+                while (p < n && m[p * n + k] == 0) {
+                    ++p;
+                }
+                if (p == n) {
+                    det = 0;
+                    return true;
+                }
+                if (p != k) {
+                    std::swap_ranges(m.begin() + k * n, m.begin() + (k + 1) * n, m.begin() + p * n);
+                    negate = !negate;
+                }
+                const long long pivot = m[k * n + k];
+                for (int i = k + 1; i < n; ++i) {
+                    for (int j = k + 1; j < n; ++j) {
+                        if (!bareiss_step(m[i * n + j], pivot, m[i * n + k], m[k * n + j], previous, m[i * n + j])) {
+                            return false;
+                        }
+                    }
+                }
+                previous = pivot;
+            }
+            det = m[(n - 1) * n + (n - 1)];
+            if (negate) {
+                if (det == std::numeric_limits<long long>::min()) {
+                    return false;
+                }
+                det = -det;
+            }
+            return true;
+        }
+
+        // Inverse of an n x n integer block written to out (leading dimension ldo), by fraction-free
+        // Gauss-Jordan elimination on [A | I]. This ends with [det(A) I | adj(A)] in exact integers;
+        // each entry adj(A) / det(A) is rounded to the nearest integer, halves away from zero, which
+        // is what the floating-point LU paths give for integer matrices. Throws if A is singular.
+        // Returns false, leaving out untouched, if an intermediate or an entry does not fit.
+        template<typename T>
+        bool integer_inverse(const T* a, int n, std::ptrdiff_t lda, T* out, std::ptrdiff_t ldo) {
+            const int w = 2 * n;
+            std::vector<long long> m(static_cast<std::size_t>(n) * w, 0);
+            for (int i = 0; i < n; ++i) {
+                for (int j = 0; j < n; ++j) {
+                    m[i * w + j] = static_cast<long long>(a[i * lda + j]);
+                }
+                m[i * w + n + i] = 1;
+            }
+            long long previous = 1;
+            for (int k = 0; k < n; ++k) {
+                int p = k;
+                while (p < n && m[p * w + k] == 0) {
+                    ++p;
+                }
+                if (p == n) {
+                    throw std::runtime_error("Matrix is singular, inverse doesn't exist");
+                }
+                if (p != k) {
+                    std::swap_ranges(m.begin() + k * w, m.begin() + (k + 1) * w, m.begin() + p * w);
+                }
+                const long long pivot = m[k * w + k];
+                for (int i = 0; i < n; ++i) {
+                    if (i == k) {
+                        continue;
+                    }
+                    const long long f = m[i * w + k];
+                    for (int j = 0; j < w; ++j) {
+                        if (j != k && !bareiss_step(m[i * w + j], pivot, f, m[k * w + j], previous, m[i * w + j])) {
+                            return false;
+                        }
+                    }
+                    m[i * w + k] = 0;
+                }
+                previous = pivot;
+            }
+            // Row swaps change the sign of both halves together, so each row divides by its own diagonal.
+            // The rounded quotients go back into the right half first, out may alias a.
+            for (int i = 0; i < n; ++i) {
+                const long long d = m[i * w + i];
+                for (int j = 0; j < n; ++j) {
+                    long long& x = m[i * w + n + j];
+                    const long long r = x % d;
+                    long long q = x / d;
+                    // |r| >= |d| - |r| is 2 |r| >= |d| without the overflow
+                    if (r != 0 && (r < 0 ? -r : r) >= (d < 0 ? -d : d) - (r < 0 ? -r : r)) {
+                        q += (x < 0) == (d < 0) ? 1 : -1;
+                    }
+                    if (!std::in_range<T>(q)) {
+                        return false;
+                    }
+                    x = q;
+                }
+            }
+            for (int i = 0; i < n; ++i) {
+                for (int j = 0; j < n; ++j) {
+                    out[i * ldo + j] = static_cast<T>(m[i * w + n + j]);
+                }
+            }
+            return true;
+        }
+
+        // In-place Cholesky factorization A = L L^T of a symmetric n x n row-major block.
+        // Only the lower triangle is read; L overwrites it. Returns false if A is not positive definite.
+        template<typename T>
+        bool cholesky_factor(T* a, int n, std::ptrdiff_t lda) {
+            for (int j = 0; j < n; ++j) {
+                T* row_j = a + j * lda;
+                T d = row_j[j];
+                for (int k = 0; k < j; ++k) {
+                    d -= row_j[k] * row_j[k];
+                }
+                if (!(d > T(0))) {
+                    return false;
+                }
+                using std::sqrt;
+                d = sqrt(d);
+                row_j[j] = d;
+                parallel_for(j + 1, n, 64, 2.0 * (n - j) * j, [&](std::size_t first, std::size_t last) {
+                    for (int i = static_cast<int>(first); i < static_cast<int>(last); ++i) {
+                        T* row_i = a + i * lda;
+                        T s = row_i[j];
+                        for (int k = 0; k < j; ++k) {
+                            s -= row_i[k] * row_j[k];
+                        }
+                        row_i[j] = s / d;
+                    }
+                });
+            }
+            return true;
+        }
+
+        // Solve L L^T X = B in place for nrhs right-hand sides, given the factor from cholesky_factor
+        template<typename T>
+        void cholesky_solve(const T* l, int n, std::ptrdiff_t lda, T* b, int nrhs, std::ptrdiff_t ldb) {
+            parallel_for(0, nrhs, 64, 2.0 * n * n * nrhs, [&](std::size_t first, std::size_t last) {
+                const int j0 = static_cast<int>(first);
+                const int j1 = static_cast<int>(last);
+
+                // Forward substitution with L
+                for (int i = 0; i < n; ++i) {
+                    T* bi = b + i * ldb;
+                    for (int k = 0; k < i; ++k) {
+                        const T lik = l[i * lda + k];
+                        const T* bk = b + k * ldb;
+                        for (int j = j0; j < j1; ++j) {
+                            bi[j] -= lik * bk[j];
+                        }
+                    }
+                    const T d = l[i * lda + i];
+                    for (int j = j0; j < j1; ++j) {
+                        bi[j] /= d;
+                    }
+                }
+
+                // Back substitution with L^T
+                for (int i = n - 1; i >= 0; --i) {
+                    T* bi = b + i * ldb;
+                    for (int k = i + 1; k < n; ++k) {
+                        const T lki = l[k * lda + i];
+                        const T* bk = b + k * ldb;
+                        for (int j = j0; j < j1; ++j) {
+                            bi[j] -= lki * bk[j];
+                        }
+                    }
+                    const T d = l[i * lda + i];
+                    for (int j = j0; j < j1; ++j) {
+                        bi[j] /= d;
+                    }
+                }
+            });
+        }
+
+        // In-place Householder QR of an m x n row-major block (m >= n).
+        // R overwrites the upper triangle, the Householder vectors (unit leading entry implied)
+        // are stored below the diagonal and their scaling factors in tau.
+        template<typename T>
+        void qr_factor(T* a, int m, int n, std::ptrdiff_t lda, T* tau) {
+            for (int k = 0; k < n; ++k) {
+                const T alpha = a[k * lda + k];
+                T tail = T(0);
+                for (int i = k + 1; i < m; ++i) {
+                    tail += a[i * lda + k] * a[i * lda + k];
+                }
+                if (tail == T(0)) {
+                    tau[k] = T(0);
+                    continue;
+                }
+
+                using std::sqrt;
+                T beta = sqrt(alpha * alpha + tail);
+                if (alpha > T(0)) {
+                    beta = -beta;
+                }
+                tau[k] = (beta - alpha) / beta;
+                const T scale = T(1) / (alpha - beta);
+                for (int i = k + 1; i < m; ++i) {
+                    a[i * lda + k] *= scale;
+                }
+                a[k * lda + k] = beta;
+
+                // Apply H = I - tau v v^T to the trailing columns, each column independently
+                parallel_for(k + 1, n, 32, 4.0 * (m - k) * (n - k), [&](std::size_t first, std::size_t last) {
+                    for (int j = static_cast<int>(first); j < static_cast<int>(last); ++j) {
+                        T w = a[k * lda + j];
+                        for (int i = k + 1; i < m; ++i) {
+                            w += a[i * lda + k] * a[i * lda + j];
+                        }
+                        w *= tau[k];
+                        a[k * lda + j] -= w;
+                        for (int i = k + 1; i < m; ++i) {
+                            a[i * lda + j] -= w * a[i * lda + k];
+                        }
+                    }
+                });
+            }
+        }
+
+        // Overwrite the m x nrhs block b with Q^T b using the reflectors from qr_factor
+        template<typename T>
+        void qr_apply_qt(const T* qr, int m, int n, std::ptrdiff_t lda, const T* tau, T* b, int nrhs, std::ptrdiff_t ldb) {
+            for (int k = 0; k < n; ++k) {
+                if (tau[k] == T(0)) {
+                    continue;
+                }
+                for (int j = 0; j < nrhs; ++j) {
+                    T w = b[k * ldb + j];
+                    for (int i = k + 1; i < m; ++i) {
+                        w += qr[i * lda + k] * b[i * ldb + j];
+                    }
+                    w *= tau[k];
+                    b[k * ldb + j] -= w;
+                    for (int i = k + 1; i < m; ++i) {
+                        b[i * ldb + j] -= w * qr[i * lda + k];
+                    }
+                }
+            }
+        }
+
+        // Solve R X = B in place for the leading n rows of b, R being the upper triangle of an n x n block
+        template<typename T>
+        void upper_triangular_solve(const T* r, int n, std::ptrdiff_t lda, T* b, int nrhs, std::ptrdiff_t ldb) {
+            for (int i = n - 1; i >= 0; --i) {
+                T* bi = b + i * ldb;
+                for (int k = i + 1; k < n; ++k) {
+                    const T u = r[i * lda + k];
+                    const T* bk = b + k * ldb;
+                    for (int j = 0; j < nrhs; ++j) {
+                        bi[j] -= u * bk[j];
+                    }
+                }
+                const T d = r[i * lda + i];
+                for (int j = 0; j < nrhs; ++j) {
+                    bi[j] /= d;
+                }
+            }
+        }
+
+    }
+
+    // Element type the LU factors are kept in: integer matrices are factored in double,
+    // since the elimination divides by the pivots
+    template<typename T>
+    using factor_t = std::conditional_t<std::is_integral_v<T>, double, T>;
+
+    // LU decomposition with partial pivoting, P A = L U.
+    // For integer T the solutions and the inverse are rounded to the nearest integer, halves away from zero.
+    template<typename T, int N>
+    class LU {
+    public:
+        explicit LU(const Matrix<T, N, N>& a);
+
+        // True if a zero pivot was encountered
+        bool is_singular() const { return singular; }
+
+        // Determinant from the product of the pivots
+        determinant_t<T> determinant() const;
+
+        // Inverse built from the factors, one substitution per column of the identity
+        Matrix<T, N, N> inverse() const;
+
+        // Solve A x = b by forward and back substitution, reusing the factors
+        Vector<T, N> solve(const Vector<T, N>& b) const;
+
+        // Solve A X = B for a block of K right-hand sides in one sweep
+        template<int K>
+        Matrix<T, N, K> solve(const Matrix<T, N, K>& b) const;
+
+        // Overwrite b (or every column of B) with the solution, without a result object
+        void solve_in_place(Vector<T, N>& b) const;
+
+        template<int K>
+        void solve_in_place(Matrix<T, N, K>& b) const;
+
+        // Combined factors: L below the diagonal (unit diagonal implied), U on and above it
+        const Matrix<factor_t<T>, N, N>& factors() const { return lu; }
+
+        Matrix<factor_t<T>, N, N> lower() const;
+        Matrix<factor_t<T>, N, N> upper() const;
+
+        // Pivot sequence: row k was exchanged with row pivots()[k] at step k
+        const std::array<int, N>& pivots() const { return piv; }
+
+        // Permutation matrix P such that P A = L U
+        Matrix<T, N, N> permutation() const;
+
+    private:
+        // Substitution on nrhs row-major right-hand sides of type T
+        void substitute(T* b, int nrhs) const;
+
+        Matrix<factor_t<T>, N, N> lu;
+        std::array<int, N> piv;
+        int sign;
+        bool singular;
+    };
+
+    template<typename T, int N>
+    LU<T, N>::LU(const Matrix<T, N, N>& a) : piv{}, sign(1) {
+        if constexpr (std::is_same_v<factor_t<T>, T>) {
+            lu = a;
+        } else {
+            for (int i = 0; i < N; ++i) {
+                for (int j = 0; j < N; ++j) {
+                    lu(i, j) = static_cast<factor_t<T>>(a(i, j));
+                }
+            }
+        }
+        singular = !detail::lu_factor(lu.data_ptr(), N, N, piv.data(), sign);
+    }
+
+    template<typename T, int N>
+    determinant_t<T> LU<T, N>::determinant() const {
+        if (singular) {
+            return determinant_t<T>(0);
+        }
+        determinant_t<T> det = determinant_t<T>(sign);
+        for (int i = 0; i < N; ++i) {
+            det *= lu(i, i);
+        }
+        return det;
+    }
+
+    template<typename T, int N>
+    Matrix<T, N, N> LU<T, N>::inverse() const {
+        if (singular) {
+            throw std::runtime_error("Matrix is singular, inverse doesn't exist");
+        }
+        Matrix<T, N, N> result;
+        for (int i = 0; i < N; ++i) {
+            result(i, i) = T(1);
+        }
+        substitute(result.data_ptr(), N);
+        return result;
+    }
+
+    template<typename T, int N>
+    void LU<T, N>::substitute(T* b, int nrhs) const {
+        using F = factor_t<T>;
+        if constexpr (std::is_same_v<F, T>) {
+            detail::lu_solve(lu.data_ptr(), N, N, piv.data(), b, nrhs, nrhs);
+        } else {
+            std::vector<F> x(b, b + static_cast<std::size_t>(N) * nrhs);
+            detail::lu_solve(lu.data_ptr(), N, N, piv.data(), x.data(), nrhs, nrhs);
+            std::transform(x.begin(), x.end(), b, [](F v) { return static_cast<T>(std::llround(v)); });
+        }
+    }
+
+    template<typename T, int N>
+    Vector<T, N> LU<T, N>::solve(const Vector<T, N>& b) const {
+        if (singular) {
+            throw std::runtime_error("Matrix is singular, system has no unique solution");
+        }
+        Vector<T, N> x = b;
+        substitute(x.data_ptr(), 1);
+        return x;
+    }
+
+    template<typename T, int N>
+    template<int K>
+    Matrix<T, N, K> LU<T, N>::solve(const Matrix<T, N, K>& b) const {
+        if (singular) {
+            throw std::runtime_error("Matrix is singular, system has no unique solution");
+        }
+        Matrix<T, N, K> x = b;
+        substitute(x.data_ptr(), K);
+        return x;
+    }
+
+    template<typename T, int N>
+    void LU<T, N>::solve_in_place(Vector<T, N>& b) const {
+        if (singular) {
+            throw std::runtime_error("Matrix is singular, system has no unique solution");
+        }
+        substitute(b.data_ptr(), 1);
+    }
+
+    template<typename T, int N>
+    template<int K>
+    void LU<T, N>::solve_in_place(Matrix<T, N, K>& b) const {
+        if (singular) {
+            throw std::runtime_error("Matrix is singular, system has no unique solution");
+        }
+        substitute(b.data_ptr(), K);
+    }
+
+    template<typename T, int N>
+    Matrix<factor_t<T>, N, N> LU<T, N>::lower() const {
+        Matrix<factor_t<T>, N, N> result;
+        for (int i = 0; i < N; ++i) {
+            for (int j = 0; j < i; ++j) {
+                result(i, j) = lu(i, j);
+            }
+            result(i, i) = factor_t<T>(1);
+        }
+        return result;
+    }
+
+    template<typename T, int N>
+    Matrix<factor_t<T>, N, N> LU<T, N>::upper() const {
+        Matrix<factor_t<T>, N, N> result;
+        for (int i = 0; i < N; ++i) {
+            for (int j = i; j < N; ++j) {
+                result(i, j) = lu(i, j);
+            }
+        }
+        return result;
+    }
+
+    template<typename T, int N>
+    Matrix<T, N, N> LU<T, N>::permutation() const {
+        std::array<int, N> perm;
+        for (int i = 0; i < N; ++i) {
+            perm[i] = i;
+        }
+        for (int k = 0; k < N; ++k) {
+            std::swap(perm[k], perm[piv[k]]);
+        }
+        Matrix<T, N, N> result;
+        for (int i = 0; i < N; ++i) {
+            result(i, perm[i]) = T(1);
+        }
+        return result;
+    }
+
+
+    // Cholesky decomposition of a symmetric positive definite matrix, A = L L^T
+    template<typename T, int N>
+    class Cholesky {
+    public:
+        explicit Cholesky(const Matrix<T, N, N>& a);
+
+        // False if a non-positive pivot was met and the factor is unusable
+        bool is_positive_definite() const { return positive_definite; }
+
+        // Lower triangular factor L
+        Matrix<T, N, N> lower() const;
+
+        double determinant() const;
+
+        Vector<T, N> solve(const Vector<T, N>& b) const;
+
+        template<int K>
+        Matrix<T, N, K> solve(const Matrix<T, N, K>& b) const;
+
+    private:
+        Matrix<T, N, N> l;
+        bool positive_definite;
+    };
+
+    template<typename T, int N>
+    Cholesky<T, N>::Cholesky(const Matrix<T, N, N>& a) : l(a) {
+        positive_definite = detail::cholesky_factor(l.data_ptr(), N, N);
+    }
+
+    template<typename T, int N>
+    Matrix<T, N, N> Cholesky<T, N>::lower() const {
+        Matrix<T, N, N> result;
+        for (int i = 0; i < N; ++i) {
+            for (int j = 0; j <= i; ++j) {
+                result(i, j) = l(i, j);
+            }
+        }
+        return result;
+    }
+
+    template<typename T, int N>
+    double Cholesky<T, N>::determinant() const {
+        if (!positive_definite) {
+            throw std::runtime_error("Matrix is not positive definite");
+        }
+        double det = 1.0;
+        for (int i = 0; i < N; ++i) {
+            det *= l(i, i);
+        }
+        return det * det;
+    }
+
+    template<typename T, int N>
+    Vector<T, N> Cholesky<T, N>::solve(const Vector<T, N>& b) const {
+        if (!positive_definite) {
+            throw std::runtime_error("Matrix is not positive definite");
+        }
+        Vector<T, N> x = b;
+        detail::cholesky_solve(l.data_ptr(), N, N, x.data_ptr(), 1, 1);
+        return x;
+    }
+
+    template<typename T, int N>
+    template<int K>
+    Matrix<T, N, K> Cholesky<T, N>::solve(const Matrix<T, N, K>& b) const {
+        if (!positive_definite) {
+            throw std::runtime_error("Matrix is not positive definite");
+        }
+        Matrix<T, N, K> x = b;
+        detail::cholesky_solve(l.data_ptr(), N, N, x.data_ptr(), K, K);
+        return x;
+    }
+
+    // Householder QR decomposition, A = Q R, used for least squares on tall systems
+    template<typename T, int Rows, int Cols>
+    class QR {
+    public:
+        static_assert(Rows >= Cols, "QR decomposition requires at least as many rows as columns");
+
+        explicit QR(const Matrix<T, Rows, Cols>& a);
+
+        // True if R has a zero on its diagonal
+        bool is_rank_deficient() const;
+
+        // Thin factors: Q with orthonormal columns and square upper triangular R
+        Matrix<T, Rows, Cols> q() const;
+        Matrix<T, Cols, Cols> r() const;
+
+        // Least squares solution minimizing ||A x - b||
+        Vector<T, Cols> solve(const Vector<T, Rows>& b) const;
+
+        template<int K>
+        Matrix<T, Cols, K> solve(const Matrix<T, Rows, K>& b) const;
+
+    private:
+        Matrix<T, Rows, Cols> qr;
+        std::array<T, Cols> tau;
+    };
+
+    template<typename T, int Rows, int Cols>
+    QR<T, Rows, Cols>::QR(const Matrix<T, Rows, Cols>& a) : qr(a), tau{} {
+        detail::qr_factor(qr.data_ptr(), Rows, Cols, Cols, tau.data());
+    }
+
+    template<typename T, int Rows, int Cols>
+    bool QR<T, Rows, Cols>::is_rank_deficient() const {
+        for (int i = 0; i < Cols; ++i) {
+            if (qr(i, i) == T(0)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template<typename T, int Rows, int Cols>
+    Matrix<T, Rows, Cols> QR<T, Rows, Cols>::q() const {
+        // Apply the reflectors in reverse order to the leading columns of the identity
+        Matrix<T, Rows, Cols> result;
+        for (int i = 0; i < Cols; ++i) {
+            result(i, i) = T(1);
+        }
+        for (int k = Cols - 1; k >= 0; --k) {
+            if (tau[k] == T(0)) {
+                continue;
+            }
+            for (int j = 0; j < Cols; ++j) {
+                T w = result(k, j);
+                for (int i = k + 1; i < Rows; ++i) {
+                    w += qr(i, k) * result(i, j);
+                }
+                w *= tau[k];
+                result(k, j) -= w;
+                for (int i = k + 1; i < Rows; ++i) {
+                    result(i, j) -= w * qr(i, k);
+                }
+            }
+        }
+        return result;
+    }
+
+    template<typename T, int Rows, int Cols>
+    Matrix<T, Cols, Cols> QR<T, Rows, Cols>::r() const {
+        Matrix<T, Cols, Cols> result;
+        for (int i = 0; i < Cols; ++i) {
+            for (int j = i; j < Cols; ++j) {
+                result(i, j) = qr(i, j);
+            }
+        }
+        return result;
+    }
+
+    template<typename T, int Rows, int Cols>
+    Vector<T, Cols> QR<T, Rows, Cols>::solve(const Vector<T, Rows>& b) const {
+        if (is_rank_deficient()) {
+            throw std::runtime_error("Matrix is rank deficient, least squares solution is not unique");
+        }
+        Vector<T, Rows> y = b;
+        detail::qr_apply_qt(qr.data_ptr(), Rows, Cols, Cols, tau.data(), y.data_ptr(), 1, 1);
+        detail::upper_triangular_solve(qr.data_ptr(), Cols, Cols, y.data_ptr(), 1, 1);
+        Vector<T, Cols> x;
+        for (int i = 0; i < Cols; ++i) {
+            x[i] = y[i];
+        }
+        return x;
+    }
+
+    template<typename T, int Rows, int Cols>
+    template<int K>
+    Matrix<T, Cols, K> QR<T, Rows, Cols>::solve(const Matrix<T, Rows, K>& b) const {
+        if (is_rank_deficient()) {
+            throw std::runtime_error("Matrix is rank deficient, least squares solution is not unique");
+        }
+        Matrix<T, Rows, K> y = b;
+        detail::qr_apply_qt(qr.data_ptr(), Rows, Cols, Cols, tau.data(), y.data_ptr(), K, K);
+        detail::upper_triangular_solve(qr.data_ptr(), Cols, Cols, y.data_ptr(), K, K);
+        Matrix<T, Cols, K> x;
+        for (int i = 0; i < Cols; ++i) {
+            for (int j = 0; j < K; ++j) {
+                x(i, j) = y(i, j);
+            }
+        }
+        return x;
+    }
+
+    // LU of a matrix of forward-mode AD variables. Only the values are factorized; tangents are
+    // carried through with the matrix-level rules
+    //     d(A^-1) = -A^-1 dA A^-1,   d(det A) = det(A) tr(A^-1 dA),   dx = A^-1 (db - dA x)
+    // so every tangent lane costs a few products or solves with the value factors instead of
+    // AD arithmetic inside the elimination.
+    template<typename T, std::size_t K, int N>
+    class LU<ADVariable<T, K>, N> {
+    public:
+        using value_type = ADVariable<T, K>;
+
+        explicit LU(const Matrix<value_type, N, N>& a);
+
+        bool is_singular() const { return values.is_singular(); }
+
+        // Zero (with zero tangents) for a singular matrix
+        value_type determinant() const;
+
+        Matrix<value_type, N, N> inverse() const;
+
+        Vector<value_type, N> solve(const Vector<value_type, N>& b) const;
+
+        template<int M>
+        Matrix<value_type, N, M> solve(const Matrix<value_type, N, M>& b) const;
+
+        // Same interface as the primary template; the tangent solves need value-typed
+        // temporaries anyway, so these overwrite b with the result of solve
+        void solve_in_place(Vector<value_type, N>& b) const { b = solve(b); }
+
+        template<int M>
+        void solve_in_place(Matrix<value_type, N, M>& b) const { b = solve(b); }
+
+        // Factorization of the value part
+        const LU<T, N>& value_factors() const { return values; }
+
+        const std::array<int, N>& pivots() const { return values.pivots(); }
+
+    private:
+        static Matrix<T, N, N> value_part(const Matrix<value_type, N, N>& a);
+
+        LU<T, N> values;
+        // Tangent lane k of A
+        std::array<Matrix<T, N, N>, K> tangents;
+    };
+
+    template<typename T, std::size_t K, int N>
+    Matrix<T, N, N> LU<ADVariable<T, K>, N>::value_part(const Matrix<value_type, N, N>& a) {
+        Matrix<T, N, N> result;
+        for (int i = 0; i < N; ++i) {
+            for (int j = 0; j < N; ++j) {
+                result(i, j) = a(i, j).getValue();
+            }
+        }
+        return result;
+    }
+
+    template<typename T, std::size_t K, int N>
+    LU<ADVariable<T, K>, N>::LU(const Matrix<value_type, N, N>& a) : values(value_part(a)) {
+        for (int i = 0; i < N; ++i) {
+            for (int j = 0; j < N; ++j) {
+                for (std::size_t k = 0; k < K; ++k) {
+                    tangents[k](i, j) = a(i, j).getDerivative(k);
+                }
+            }
+        }
+    }
+
+    template<typename T, std::size_t K, int N>
+    ADVariable<T, K> LU<ADVariable<T, K>, N>::determinant() const {
+        if (is_singular()) {
+            return value_type(T(0));
+        }
+        const T det = values.determinant();
+        const Matrix<T, N, N> inv = values.inverse();
+        std::array<T, K> d;
+        for (std::size_t k = 0; k < K; ++k) {
+            // tr(A^-1 dA) without forming the product
+            T trace = T(0);
+            for (int i = 0; i < N; ++i) {
+                for (int j = 0; j < N; ++j) {
+                    trace += inv(i, j) * tangents[k](j, i);
+                }
+            }
+            d[k] = det * trace;
+        }
+        return value_type(det, d);
+    }
+
+    template<typename T, std::size_t K, int N>
+    Matrix<ADVariable<T, K>, N, N> LU<ADVariable<T, K>, N>::inverse() const {
+        const Matrix<T, N, N> inv = values.inverse();
+        std::array<Matrix<T, N, N>, K> d;
+        for (std::size_t k = 0; k < K; ++k) {
+            d[k] = inv * tangents[k] * inv;
+        }
+        Matrix<value_type, N, N> result;
+        for (int i = 0; i < N; ++i) {
+            for (int j = 0; j < N; ++j) {
+                std::array<T, K> lanes;
+                for (std::size_t k = 0; k < K; ++k) {
+                    lanes[k] = -d[k](i, j);
+                }
+                result(i, j) = value_type(inv(i, j), lanes);
+            }
+        }
+        return result;
+    }
+
+    template<typename T, std::size_t K, int N>
+    Vector<ADVariable<T, K>, N> LU<ADVariable<T, K>, N>::solve(const Vector<value_type, N>& b) const {
+        Vector<T, N> b_value;
+        for (int i = 0; i < N; ++i) {
+            b_value[i] = b[i].getValue();
+        }
+        const Vector<T, N> x = values.solve(b_value);
+
+        // All K tangent right-hand sides db_k - dA_k x go through the factors in one sweep
+        Matrix<T, N, static_cast<int>(K)> rhs;
+        for (std::size_t k = 0; k < K; ++k) {
+            const Vector<T, N> dax = tangents[k] * x;
+            for (int i = 0; i < N; ++i) {
+                rhs(i, static_cast<int>(k)) = b[i].getDerivative(k) - dax[i];
+            }
+        }
+        const Matrix<T, N, static_cast<int>(K)> dx = values.solve(rhs);
+
+        Vector<value_type, N> result;
+        for (int i = 0; i < N; ++i) {
+            std::array<T, K> lanes;
+            for (std::size_t k = 0; k < K; ++k) {
+                lanes[k] = dx(i, static_cast<int>(k));
+            }
+            result[i] = value_type(x[i], lanes);
+        }
+        return result;
+    }
+
+    template<typename T, std::size_t K, int N>
+    template<int M>
+    Matrix<ADVariable<T, K>, N, M> LU<ADVariable<T, K>, N>::solve(const Matrix<value_type, N, M>& b) const {
+        Matrix<T, N, M> b_value;
+        for (int i = 0; i < N; ++i) {
+            for (int j = 0; j < M; ++j) {
+                b_value(i, j) = b(i, j).getValue();
+            }
+        }
+        const Matrix<T, N, M> x = values.solve(b_value);
+
+        Matrix<value_type, N, M> result;
+        for (int i = 0; i < N; ++i) {
+            for (int j = 0; j < M; ++j) {
+                result(i, j) = value_type(x(i, j));
+            }
+        }
+        for (std::size_t k = 0; k < K; ++k) {
+            const Matrix<T, N, M> dax = tangents[k] * x;
+            Matrix<T, N, M> rhs;
+            for (int i = 0; i < N; ++i) {
+                for (int j = 0; j < M; ++j) {
+                    rhs(i, j) = b(i, j).getDerivative(k) - dax(i, j);
+                }
+            }
+            const Matrix<T, N, M> dx = values.solve(rhs);
+            for (int i = 0; i < N; ++i) {
+                for (int j = 0; j < M; ++j) {
+                    std::array<T, K> lanes = result(i, j).getDerivatives();
+                    lanes[k] = dx(i, j);
+                    result(i, j) = value_type(x(i, j), lanes);
+                }
+            }
+        }
+        return result;
+    }
+
+}
+
+#endif
@@ -0,0 +1,606 @@
+//Contains implementation for DynamicMatrix class
+
+#ifndef DYNAMIC_MATRIX_HPP
+#define DYNAMIC_MATRIX_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <initializer_list>
+#include <iostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "memory.hpp"
+#include "simd.hpp"
+#include "matrix.hpp"
+#include "dynamic_vector.hpp"
+#include "gemm.hpp"
+#include "parallel.hpp"
+#include "decomposition.hpp"
+
+namespace linear_algebra {
+
+    template<typename T>
+    class DynamicLU;
+
+    // Matrix whose shape is chosen at runtime, stored row-major in one contiguous aligned heap block
+    template<typename T>
+    class DynamicMatrix {
+    public:
+        // Constructors
+        DynamicMatrix() = default;
+        DynamicMatrix(std::size_t rows, std::size_t cols, const T& value = T());
+        DynamicMatrix(const std::initializer_list<std::initializer_list<T>>& init_list);
+
+        // Conversion from and to the fixed-size Matrix
+        template<int Rows, int Cols>
+        DynamicMatrix(const Matrix<T, Rows, Cols>& mat);
+
+        template<int Rows, int Cols>
+        Matrix<T, Rows, Cols> to_fixed() const;
+
+        static DynamicMatrix<T> identity(std::size_t n);
+
+        std::size_t rows() const { return row_count; }
+        std::size_t cols() const { return col_count; }
+
+        // Change the shape, keeping the allocation when it is large enough. Elements keep their
+        // position in the row-major storage, new ones are value-initialized.
+        void resize(std::size_t rows, std::size_t cols);
+
+        // Accessor and mutator functions
+        T& operator()(std::size_t row, std::size_t col) { return data[row * col_count + col]; }
+        const T& operator()(std::size_t row, std::size_t col) const { return data[row * col_count + col]; }
+
+        // Contiguous row-major storage, for kernels working on raw memory
+        T* data_ptr() { return data.data(); }
+        const T* data_ptr() const { return data.data(); }
+
+        // Basic operations
+        DynamicMatrix<T> operator+(const DynamicMatrix<T>& other) const;
+        DynamicMatrix<T> operator-(const DynamicMatrix<T>& other) const;
+        DynamicMatrix<T> operator*(const DynamicMatrix<T>& other) const;
+        DynamicVector<T> operator*(const DynamicVector<T>& vec) const;
+
+        // Scalar operations
+        DynamicMatrix<T> operator*(T scalar) const;
+        DynamicMatrix<T> operator/(T scalar) const;
+
+        // Compound assignment works on the existing storage
+        DynamicMatrix<T>& operator+=(const DynamicMatrix<T>& other);
+        DynamicMatrix<T>& operator-=(const DynamicMatrix<T>& other);
+        DynamicMatrix<T>& operator*=(T scalar);
+        DynamicMatrix<T>& operator/=(T scalar);
+
+        // Transpose; the rvalue overload reuses the expiring matrix's storage
+        DynamicMatrix<T> transpose() const&;
+        DynamicMatrix<T> transpose() &&;
+
+        // Square matrices are transposed by swapping across the diagonal, other shapes go
+        // through one temporary buffer
+        DynamicMatrix<T>& transpose_in_place();
+
+        // Inverse (if possible); the rvalue overload inverts the expiring matrix in place
+        DynamicMatrix<T> inverse() const&;
+        DynamicMatrix<T> inverse() &&;
+
+        // Replace a square matrix by its inverse. On a singular matrix this throws and leaves
+        // the contents unspecified.
+        DynamicMatrix<T>& invert_in_place();
+
+        // Determinant (if possible)
+        double determinant() const;
+
+        // Display matrix
+        void display() const;
+
+        // Calculate the Frobenius norm of the matrix
+        T norm() const;
+
+        //solve linear equations through an LU factorization
+        DynamicVector<T> solve_linear_equations(const DynamicVector<T>& b) const;
+
+        // Same, overwriting b with the solution
+        void solve_in_place(DynamicVector<T>& b) const;
+
+    private:
+        void check_same_shape(const DynamicMatrix<T>& other) const;
+
+        std::size_t row_count = 0;
+        std::size_t col_count = 0;
+        std::vector<T, AlignedAllocator<T>> data;
+    };
+
+    // Constructors
+    template<typename T>
+    DynamicMatrix<T>::DynamicMatrix(std::size_t rows, std::size_t cols, const T& value)
+        : row_count(rows), col_count(cols), data(rows * cols, value) {}
+
+    template<typename T>
+    DynamicMatrix<T>::DynamicMatrix(const std::initializer_list<std::initializer_list<T>>& init_list)
+        : row_count(init_list.size()), col_count(init_list.size() ? init_list.begin()->size() : 0) {
+        data.reserve(row_count * col_count);
+        for (const auto& row : init_list) {
+            if (row.size() != col_count) {
+                throw std::invalid_argument("Invalid number of columns in initializer list");
+            }
+            data.insert(data.end(), row.begin(), row.end());
+        }
+    }
+
+    template<typename T>
+    template<int Rows, int Cols>
+    DynamicMatrix<T>::DynamicMatrix(const Matrix<T, Rows, Cols>& mat)
+        : row_count(Rows), col_count(Cols), data(mat.data_ptr(), mat.data_ptr() + Rows * Cols) {}
+
+    template<typename T>
+    template<int Rows, int Cols>
+    Matrix<T, Rows, Cols> DynamicMatrix<T>::to_fixed() const {
+        if (row_count != Rows || col_count != Cols) {
+            throw std::invalid_argument("Matrix shape does not match the fixed-size target");
+        }
+        Matrix<T, Rows, Cols> result;
+        std::copy(data.begin(), data.end(), result.data_ptr());
+        return result;
+    }
+
+    template<typename T>
+    DynamicMatrix<T> DynamicMatrix<T>::identity(std::size_t n) {
+        DynamicMatrix<T> result(n, n);
+        for (std::size_t i = 0; i < n; ++i) {
+            result(i, i) = T(1);
+        }
+        return result;
+    }
+
+    template<typename T>
+    void DynamicMatrix<T>::resize(std::size_t rows, std::size_t cols) {
+        data.resize(rows * cols);
+        row_count = rows;
+        col_count = cols;
+    }
+
+    template<typename T>
+    void DynamicMatrix<T>::check_same_shape(const DynamicMatrix<T>& other) const {
+        if (row_count != other.row_count || col_count != other.col_count) {
+            throw std::invalid_argument("Matrix dimensions do not match");
+        }
+    }
+
+    // Basic operations
+    template<typename T>
+    DynamicMatrix<T> DynamicMatrix<T>::operator+(const DynamicMatrix<T>& other) const {
+        check_same_shape(other);
+        DynamicMatrix<T> result(row_count, col_count);
+        detail::simd::add(result.data_ptr(), data_ptr(), other.data_ptr(), data.size());
+        return result;
+    }
+
+    template<typename T>
+    DynamicMatrix<T> DynamicMatrix<T>::operator-(const DynamicMatrix<T>& other) const {
+        check_same_shape(other);
+        DynamicMatrix<T> result(row_count, col_count);
+        detail::simd::subtract(result.data_ptr(), data_ptr(), other.data_ptr(), data.size());
+        return result;
+    }
+
+    template<typename T>
+    DynamicMatrix<T> DynamicMatrix<T>::operator*(const DynamicMatrix<T>& other) const {
+        DynamicMatrix<T> result;
+        multiply_into(result, *this, other);
+        return result;
+    }
+
+    template<typename T>
+    DynamicVector<T> DynamicMatrix<T>::operator*(const DynamicVector<T>& vec) const {
+        DynamicVector<T> result;
+        multiply_into(result, *this, vec);
+        return result;
+    }
+
+    // Scalar operations
+    template<typename T>
+    DynamicMatrix<T> DynamicMatrix<T>::operator*(T scalar) const {
+        DynamicMatrix<T> result(row_count, col_count);
+        detail::simd::scale(result.data_ptr(), data_ptr(), scalar, data.size());
+        return result;
+    }
+
+    template<typename T>
+    DynamicMatrix<T> DynamicMatrix<T>::operator/(T scalar) const {
+        if (scalar == T(0)) {
+            throw std::runtime_error("Division by zero");
+        }
+        DynamicMatrix<T> result(row_count, col_count);
+        for (std::size_t i = 0; i < data.size(); ++i) {
+            result.data[i] = data[i] / scalar;
+        }
+        return result;
+    }
+
+    template<typename T>
+    DynamicMatrix<T>& DynamicMatrix<T>::operator+=(const DynamicMatrix<T>& other) {
+        check_same_shape(other);
+        detail::simd::add(data_ptr(), data_ptr(), other.data_ptr(), data.size());
+        return *this;
+    }
+
+    template<typename T>
+    DynamicMatrix<T>& DynamicMatrix<T>::operator-=(const DynamicMatrix<T>& other) {
+        check_same_shape(other);
+        detail::simd::subtract(data_ptr(), data_ptr(), other.data_ptr(), data.size());
+        return *this;
+    }
+
+    template<typename T>
+    DynamicMatrix<T>& DynamicMatrix<T>::operator*=(T scalar) {
+        detail::simd::scale(data_ptr(), data_ptr(), scalar, data.size());
+        return *this;
+    }
+
+    template<typename T>
+    DynamicMatrix<T>& DynamicMatrix<T>::operator/=(T scalar) {
+        if (scalar == T(0)) {
+            throw std::runtime_error("Division by zero");
+        }
+        for (T& value : data) {
+            value /= scalar;
+        }
+        return *this;
+    }
+
+    // Operands that are about to expire lend their storage to the result
+    template<typename T>
+    DynamicMatrix<T> operator+(DynamicMatrix<T>&& a, const DynamicMatrix<T>& b) {
+        a += b;
+        return std::move(a);
+    }
+
+    template<typename T>
+    DynamicMatrix<T> operator+(const DynamicMatrix<T>& a, DynamicMatrix<T>&& b) {
+        b += a;
+        return std::move(b);
+    }
+
+    template<typename T>
+    DynamicMatrix<T> operator+(DynamicMatrix<T>&& a, DynamicMatrix<T>&& b) {
+        a += b;
+        return std::move(a);
+    }
+
+    template<typename T>
+    DynamicMatrix<T> operator-(DynamicMatrix<T>&& a, const DynamicMatrix<T>& b) {
+        a -= b;
+        return std::move(a);
+    }
+
+    template<typename T>
+    DynamicMatrix<T> operator-(const DynamicMatrix<T>& a, DynamicMatrix<T>&& b) {
+        if (a.rows() != b.rows() || a.cols() != b.cols()) {
+            throw std::invalid_argument("Matrix dimensions do not match");
+        }
+        detail::simd::subtract(b.data_ptr(), a.data_ptr(), b.data_ptr(), a.rows() * a.cols());
+        return std::move(b);
+    }
+
+    template<typename T>
+    DynamicMatrix<T> operator-(DynamicMatrix<T>&& a, DynamicMatrix<T>&& b) {
+        a -= b;
+        return std::move(a);
+    }
+
+    template<typename T>
+    DynamicMatrix<T> operator*(DynamicMatrix<T>&& a, std::type_identity_t<T> scalar) {
+        a *= scalar;
+        return std::move(a);
+    }
+
+    template<typename T>
+    DynamicMatrix<T> operator/(DynamicMatrix<T>&& a, std::type_identity_t<T> scalar) {
+        a /= scalar;
+        return std::move(a);
+    }
+
+    // dst = op(A) op(B), reusing dst's allocation when it is large enough. A transposed operand is
+    // read in place, never copied. dst must not be one of the operands.
+    template<typename T>
+    void multiply_into(DynamicMatrix<T>& dst, const DynamicMatrix<T>& a, const DynamicMatrix<T>& b,
+                       Transpose op_a = Transpose::No, Transpose op_b = Transpose::No) {
+        const std::size_t m = op_a == Transpose::No ? a.rows() : a.cols();
+        const std::size_t k = op_a == Transpose::No ? a.cols() : a.rows();
+        const std::size_t n = op_b == Transpose::No ? b.cols() : b.rows();
+        if (k != (op_b == Transpose::No ? b.rows() : b.cols())) {
+            throw std::invalid_argument("Number of columns in the first matrix must match the number of rows in the second matrix");
+        }
+        if (&dst == &a || &dst == &b) {
+            throw std::invalid_argument("Output of multiply_into must not alias an operand");
+        }
+        dst.resize(m, n);
+        std::fill_n(dst.data_ptr(), m * n, T());
+        detail::gemm(op_a, op_b, static_cast<int>(m), static_cast<int>(n), static_cast<int>(k),
+                     a.data_ptr(), a.cols(), b.data_ptr(), b.cols(), dst.data_ptr(), n);
+    }
+
+    // A^T B and A B^T without forming the transpose
+    template<typename T>
+    DynamicMatrix<T> transpose_multiply(const DynamicMatrix<T>& a, const DynamicMatrix<T>& b) {
+        DynamicMatrix<T> result;
+        multiply_into(result, a, b, Transpose::Yes, Transpose::No);
+        return result;
+    }
+
+    template<typename T>
+    DynamicMatrix<T> multiply_transpose(const DynamicMatrix<T>& a, const DynamicMatrix<T>& b) {
+        DynamicMatrix<T> result;
+        multiply_into(result, a, b, Transpose::No, Transpose::Yes);
+        return result;
+    }
+
+    // dst = A x, reusing dst's allocation when it is large enough
+    template<typename T>
+    void multiply_into(DynamicVector<T>& dst, const DynamicMatrix<T>& a, const DynamicVector<T>& x) {
+        if (a.cols() != x.size()) {
+            throw std::invalid_argument("Number of columns in the matrix must match the size of the vector");
+        }
+        if (&dst == &x) {
+            throw std::invalid_argument("Output of multiply_into must not alias an operand");
+        }
+        dst.resize(a.rows());
+        // Each row is an independent dot product, so large products are split by rows
+        parallel_for(0, a.rows(), 256, 2.0 * a.rows() * a.cols(), [&](std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; ++i) {
+                dst[i] = detail::simd::dot(a.data_ptr() + i * a.cols(), x.data_ptr(), a.cols());
+            }
+        });
+    }
+
+    // Transpose
+    template<typename T>
+    DynamicMatrix<T> DynamicMatrix<T>::transpose() const& {
+        DynamicMatrix<T> result(col_count, row_count);
+        detail::transpose(static_cast<int>(row_count), static_cast<int>(col_count), data_ptr(), col_count, result.data_ptr(), row_count);
+        return result;
+    }
+
+    template<typename T>
+    DynamicMatrix<T> DynamicMatrix<T>::transpose() && {
+        transpose_in_place();
+        return std::move(*this);
+    }
+
+    template<typename T>
+    DynamicMatrix<T>& DynamicMatrix<T>::transpose_in_place() {
+        if (row_count == col_count) {
+            detail::transpose_in_place(static_cast<int>(row_count), data_ptr(), col_count);
+        } else {
+            // Allocated like data, so the two buffers can be swapped (the allocator does not propagate on swap)
+            std::vector<T, AlignedAllocator<T>> transposed(data.size(), T(), data.get_allocator());
+            detail::transpose(static_cast<int>(row_count), static_cast<int>(col_count), data_ptr(), col_count, transposed.data(), row_count);
+            data.swap(transposed);
+            std::swap(row_count, col_count);
+        }
+        return *this;
+    }
+
+    // Inverse (if possible)
+    template<typename T>
+    DynamicMatrix<T> DynamicMatrix<T>::inverse() const& {
+        if constexpr (std::is_integral_v<T>) {
+            DynamicMatrix<T> result = *this;
+            return std::move(result.invert_in_place());
+        } else {
+            return DynamicLU<T>(*this).inverse();
+        }
+    }
+
+    template<typename T>
+    DynamicMatrix<T> DynamicMatrix<T>::inverse() && {
+        invert_in_place();
+        return std::move(*this);
+    }
+
+    template<typename T>
+    DynamicMatrix<T>& DynamicMatrix<T>::invert_in_place() {
+        if (row_count != col_count) {
+            throw std::invalid_argument("Inverse is only defined for square matrices");
+        }
+        // Integers are inverted exactly, Gauss-Jordan would truncate every division by a pivot
+        if constexpr (std::is_integral_v<T>) {
+            if (!detail::integer_inverse(data_ptr(), static_cast<int>(row_count), col_count, data_ptr(), col_count)) {
+                *this = DynamicLU<T>(*this).inverse();
+            }
+        } else {
+            std::vector<int, AlignedAllocator<int>> piv(row_count);
+            if (!detail::gauss_jordan_invert(data_ptr(), static_cast<int>(row_count), col_count, piv.data())) {
+                throw std::runtime_error("Matrix is singular, inverse doesn't exist");
+            }
+        }
+        return *this;
+    }
+
+    // Determinant (if possible)
+    template<typename T>
+    double DynamicMatrix<T>::determinant() const {
+        if constexpr (std::is_integral_v<T>) {
+            if (row_count != col_count) {
+                throw std::invalid_argument("Determinant is only defined for square matrices");
+            }
+            long long det;
+            if (!detail::integer_determinant(data_ptr(), static_cast<int>(row_count), col_count, det)) {
+                return DynamicLU<T>(*this).determinant();
+            }
+            return static_cast<double>(det);
+        } else {
+            return DynamicLU<T>(*this).determinant();
+        }
+    }
+
+    // Display matrix
+    template<typename T>
+    void DynamicMatrix<T>::display() const {
+        for (std::size_t i = 0; i < row_count; ++i) {
+            for (std::size_t j = 0; j < col_count; ++j) {
+                std::cout << (*this)(i, j) << "\t";
+            }
+            std::cout << std::endl;
+        }
+    }
+
+    // Calculate the Frobenius norm of the matrix
+    template<typename T>
+    T DynamicMatrix<T>::norm() const {
+        return std::sqrt(detail::simd::sum_squares(data_ptr(), data.size()));
+    }
+
+    template<typename T>
+    DynamicVector<T> DynamicMatrix<T>::solve_linear_equations(const DynamicVector<T>& b) const {
+        return DynamicLU<T>(*this).solve(b);
+    }
+
+    template<typename T>
+    void DynamicMatrix<T>::solve_in_place(DynamicVector<T>& b) const {
+        DynamicLU<T>(*this).solve_in_place(b);
+    }
+
+    // Mixed products with the fixed-size types
+    template<typename T, int Rows, int Cols>
+    DynamicMatrix<T> operator*(const DynamicMatrix<T>& a, const Matrix<T, Rows, Cols>& b) {
+        return a * DynamicMatrix<T>(b);
+    }
+
+    template<typename T, int Rows, int Cols>
+    DynamicMatrix<T> operator*(const Matrix<T, Rows, Cols>& a, const DynamicMatrix<T>& b) {
+        return DynamicMatrix<T>(a) * b;
+    }
+
+    template<typename T, size_t N>
+    DynamicVector<T> operator*(const DynamicMatrix<T>& a, const Vector<T, N>& vec) {
+        return a * DynamicVector<T>(vec);
+    }
+
+    // LU decomposition with partial pivoting for runtime-sized square matrices.
+    // Integer matrices are factored in double and their solutions rounded to the nearest integer, halves away from zero.
+    template<typename T>
+    class DynamicLU {
+    public:
+        explicit DynamicLU(const DynamicMatrix<T>& a);
+
+        bool is_singular() const { return singular; }
+
+        double determinant() const;
+
+        DynamicMatrix<T> inverse() const;
+
+        // Solve A x = b (or A X = B for a block of right-hand sides), reusing the factors
+        DynamicVector<T> solve(const DynamicVector<T>& b) const;
+        DynamicMatrix<T> solve(const DynamicMatrix<T>& b) const;
+
+        // Overwrite b (or every column of B) with the solution
+        void solve_in_place(DynamicVector<T>& b) const;
+        void solve_in_place(DynamicMatrix<T>& b) const;
+
+        // Combined factors: L below the diagonal (unit diagonal implied), U on and above it
+        const DynamicMatrix<factor_t<T>>& factors() const { return lu; }
+
+        const std::vector<int, AlignedAllocator<int>>& pivots() const { return piv; }
+
+    private:
+        void check_solvable(std::size_t rhs_rows) const;
+
+        // Substitution on a row-major block of right-hand sides of type T
+        void substitute(T* b, int nrhs, std::size_t ldb) const;
+
+        DynamicMatrix<factor_t<T>> lu;
+        std::vector<int, AlignedAllocator<int>> piv;
+        int sign = 1;
+        bool singular = false;
+    };
+
+    template<typename T>
+    DynamicLU<T>::DynamicLU(const DynamicMatrix<T>& a) : piv(a.rows()) {
+        if (a.rows() != a.cols()) {
+            throw std::invalid_argument("LU decomposition is only defined for square matrices");
+        }
+        if constexpr (std::is_same_v<factor_t<T>, T>) {
+            lu = a;
+        } else {
+            lu = DynamicMatrix<factor_t<T>>(a.rows(), a.cols());
+            std::copy(a.data_ptr(), a.data_ptr() + a.rows() * a.cols(), lu.data_ptr());
+        }
+        singular = !detail::lu_factor(lu.data_ptr(), static_cast<int>(lu.rows()), lu.cols(), piv.data(), sign);
+    }
+
+    template<typename T>
+    double DynamicLU<T>::determinant() const {
+        if (singular) {
+            return 0.0;
+        }
+        double det = sign;
+        for (std::size_t i = 0; i < lu.rows(); ++i) {
+            det *= lu(i, i);
+        }
+        return det;
+    }
+
+    template<typename T>
+    void DynamicLU<T>::check_solvable(std::size_t rhs_rows) const {
+        if (singular) {
+            throw std::runtime_error("Matrix is singular, system has no unique solution");
+        }
+        if (rhs_rows != lu.rows()) {
+            throw std::invalid_argument("Size of the right-hand side must match the matrix");
+        }
+    }
+
+    template<typename T>
+    DynamicMatrix<T> DynamicLU<T>::inverse() const {
+        if (singular) {
+            throw std::runtime_error("Matrix is singular, inverse doesn't exist");
+        }
+        return solve(DynamicMatrix<T>::identity(lu.rows()));
+    }
+
+    template<typename T>
+    DynamicVector<T> DynamicLU<T>::solve(const DynamicVector<T>& b) const {
+        DynamicVector<T> x = b;
+        solve_in_place(x);
+        return x;
+    }
+
+    template<typename T>
+    DynamicMatrix<T> DynamicLU<T>::solve(const DynamicMatrix<T>& b) const {
+        DynamicMatrix<T> x = b;
+        solve_in_place(x);
+        return x;
+    }
+
+    template<typename T>
+    void DynamicLU<T>::solve_in_place(DynamicVector<T>& b) const {
+        check_solvable(b.size());
+        substitute(b.data_ptr(), 1, 1);
+    }
+
+    template<typename T>
+    void DynamicLU<T>::solve_in_place(DynamicMatrix<T>& b) const {
+        check_solvable(b.rows());
+        substitute(b.data_ptr(), static_cast<int>(b.cols()), b.cols());
+    }
+
+    template<typename T>
+    void DynamicLU<T>::substitute(T* b, int nrhs, std::size_t ldb) const {
+        using F = factor_t<T>;
+        const int n = static_cast<int>(lu.rows());
+        if constexpr (std::is_same_v<F, T>) {
+            detail::lu_solve(lu.data_ptr(), n, lu.cols(), piv.data(), b, nrhs, ldb);
+        } else {
+            std::vector<F> x(b, b + lu.rows() * ldb);
+            detail::lu_solve(lu.data_ptr(), n, lu.cols(), piv.data(), x.data(), nrhs, ldb);
+            std::transform(x.begin(), x.end(), b, [](F v) { return static_cast<T>(std::llround(v)); });
+        }
+    }
+
+}
+
+#endif
@@ -0,0 +1,263 @@
+//Contains implementation for DynamicVector class
+
+#ifndef DYNAMIC_VECTOR_HPP
+#define DYNAMIC_VECTOR_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <initializer_list>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "memory.hpp"
+#include "simd.hpp"
+#include "vector.hpp"
+
+namespace linear_algebra {
+
+    // Vector whose size is chosen at runtime, stored contiguously on the heap
+    template<typename T>
+    class DynamicVector {
+    public:
+        // Constructors
+        DynamicVector() = default;
+        explicit DynamicVector(std::size_t size, const T& value = T());
+        DynamicVector(std::initializer_list<T> init_list);
+
+        // Conversion from and to the fixed-size Vector
+        template<size_t N>
+        DynamicVector(const Vector<T, N>& vec);
+
+        template<size_t N>
+        Vector<T, N> to_fixed() const;
+
+        std::size_t size() const { return data.size(); }
+
+        // Change the size, keeping the allocation when it is large enough; the leading
+        // elements are kept and new ones are value-initialized
+        void resize(std::size_t size) { data.resize(size); }
+
+        T& operator[](std::size_t index) { return data[index]; }
+        const T& operator[](std::size_t index) const { return data[index]; }
+
+        // Contiguous storage, for kernels working on raw memory
+        T* data_ptr() { return data.data(); }
+        const T* data_ptr() const { return data.data(); }
+
+        // Basic operations
+        DynamicVector<T> operator+(const DynamicVector<T>& other) const;
+        DynamicVector<T> operator-(const DynamicVector<T>& other) const;
+        DynamicVector<T> operator*(T scalar) const;
+
+        // Compound assignment works on the existing storage
+        DynamicVector<T>& operator+=(const DynamicVector<T>& other);
+        DynamicVector<T>& operator-=(const DynamicVector<T>& other);
+        DynamicVector<T>& operator*=(T scalar);
+        DynamicVector<T>& operator/=(T scalar);
+
+        T dot(const DynamicVector<T>& other) const;
+
+        // Normalization; the rvalue overload reuses the expiring vector's storage
+        DynamicVector<T> normalize() const&;
+        DynamicVector<T> normalize() &&;
+        DynamicVector<T>& normalize_in_place();
+
+        // Magnitude
+        T magnitude() const;
+
+        template<typename U>
+        friend std::ostream& operator<<(std::ostream& os, const DynamicVector<U>& vec);
+
+    private:
+        void check_size(const DynamicVector<T>& other) const;
+
+        std::vector<T, AlignedAllocator<T>> data;
+    };
+
+    // Constructors
+    template<typename T>
+    DynamicVector<T>::DynamicVector(std::size_t size, const T& value) : data(size, value) {}
+
+    template<typename T>
+    DynamicVector<T>::DynamicVector(std::initializer_list<T> init_list) : data(init_list.begin(), init_list.end()) {}
+
+    template<typename T>
+    template<size_t N>
+    DynamicVector<T>::DynamicVector(const Vector<T, N>& vec) : data(vec.data_ptr(), vec.data_ptr() + N) {}
+
+    template<typename T>
+    template<size_t N>
+    Vector<T, N> DynamicVector<T>::to_fixed() const {
+        if (size() != N) {
+            throw std::invalid_argument("Vector size does not match the fixed-size target");
+        }
+        Vector<T, N> result;
+        for (size_t i = 0; i < N; ++i) {
+            result[i] = data[i];
+        }
+        return result;
+    }
+
+    template<typename T>
+    void DynamicVector<T>::check_size(const DynamicVector<T>& other) const {
+        if (size() != other.size()) {
+            throw std::invalid_argument("Vector sizes do not match");
+        }
+    }
+
+    // Basic operations
+    template<typename T>
+    DynamicVector<T> DynamicVector<T>::operator+(const DynamicVector<T>& other) const {
+        check_size(other);
+        DynamicVector<T> result(size());
+        detail::simd::add(result.data_ptr(), data_ptr(), other.data_ptr(), size());
+        return result;
+    }
+
+    template<typename T>
+    DynamicVector<T> DynamicVector<T>::operator-(const DynamicVector<T>& other) const {
+        check_size(other);
+        DynamicVector<T> result(size());
+        detail::simd::subtract(result.data_ptr(), data_ptr(), other.data_ptr(), size());
+        return result;
+    }
+
+    template<typename T>
+    DynamicVector<T> DynamicVector<T>::operator*(T scalar) const {
+        DynamicVector<T> result(size());
+        detail::simd::scale(result.data_ptr(), data_ptr(), scalar, size());
+        return result;
+    }
+
+    template<typename T>
+    DynamicVector<T>& DynamicVector<T>::operator+=(const DynamicVector<T>& other) {
+        check_size(other);
+        detail::simd::add(data_ptr(), data_ptr(), other.data_ptr(), size());
+        return *this;
+    }
+
+    template<typename T>
+    DynamicVector<T>& DynamicVector<T>::operator-=(const DynamicVector<T>& other) {
+        check_size(other);
+        detail::simd::subtract(data_ptr(), data_ptr(), other.data_ptr(), size());
+        return *this;
+    }
+
+    template<typename T>
+    DynamicVector<T>& DynamicVector<T>::operator*=(T scalar) {
+        detail::simd::scale(data_ptr(), data_ptr(), scalar, size());
+        return *this;
+    }
+
+    template<typename T>
+    DynamicVector<T>& DynamicVector<T>::operator/=(T scalar) {
+        if (scalar == T(0)) {
+            throw std::runtime_error("Division by zero");
+        }
+        for (T& value : data) {
+            value /= scalar;
+        }
+        return *this;
+    }
+
+    // Operands that are about to expire lend their storage to the result
+    template<typename T>
+    DynamicVector<T> operator+(DynamicVector<T>&& a, const DynamicVector<T>& b) {
+        a += b;
+        return std::move(a);
+    }
+
+    template<typename T>
+    DynamicVector<T> operator+(const DynamicVector<T>& a, DynamicVector<T>&& b) {
+        b += a;
+        return std::move(b);
+    }
+
+    template<typename T>
+    DynamicVector<T> operator+(DynamicVector<T>&& a, DynamicVector<T>&& b) {
+        a += b;
+        return std::move(a);
+    }
+
+    template<typename T>
+    DynamicVector<T> operator-(DynamicVector<T>&& a, const DynamicVector<T>& b) {
+        a -= b;
+        return std::move(a);
+    }
+
+    template<typename T>
+    DynamicVector<T> operator-(const DynamicVector<T>& a, DynamicVector<T>&& b) {
+        if (a.size() != b.size()) {
+            throw std::invalid_argument("Vector sizes do not match");
+        }
+        detail::simd::subtract(b.data_ptr(), a.data_ptr(), b.data_ptr(), b.size());
+        return std::move(b);
+    }
+
+    template<typename T>
+    DynamicVector<T> operator-(DynamicVector<T>&& a, DynamicVector<T>&& b) {
+        a -= b;
+        return std::move(a);
+    }
+
+    template<typename T>
+    DynamicVector<T> operator*(DynamicVector<T>&& a, std::type_identity_t<T> scalar) {
+        a *= scalar;
+        return std::move(a);
+    }
+
+    template<typename T>
+    T DynamicVector<T>::dot(const DynamicVector<T>& other) const {
+        check_size(other);
+        return detail::simd::dot(data.data(), other.data.data(), size());
+    }
+
+    // Normalization
+    template<typename T>
+    DynamicVector<T> DynamicVector<T>::normalize() const& {
+        T mag = magnitude();
+        if (mag == T(0)) {
+            return *this;
+        }
+        return *this * (T(1) / mag);
+    }
+
+    template<typename T>
+    DynamicVector<T> DynamicVector<T>::normalize() && {
+        normalize_in_place();
+        return std::move(*this);
+    }
+
+    template<typename T>
+    DynamicVector<T>& DynamicVector<T>::normalize_in_place() {
+        T mag = magnitude();
+        if (mag != T(0)) {
+            *this *= T(1) / mag;
+        }
+        return *this;
+    }
+
+    // Magnitude
+    template<typename T>
+    T DynamicVector<T>::magnitude() const {
+        return std::sqrt(detail::simd::sum_squares(data.data(), size()));
+    }
+
+    template<typename T>
+    std::ostream& operator<<(std::ostream& os, const DynamicVector<T>& vec) {
+        os << "(";
+        for (std::size_t i = 0; i < vec.size(); ++i) {
+            os << vec[i];
+            if (i + 1 != vec.size()) {
+                os << ", ";
+            }
+        }
+        os << ")";
+        return os;
+    }
+
+}
+
+#endif
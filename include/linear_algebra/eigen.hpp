@@ -0,0 +1,1151 @@
+//Contains implementation for eigenvalue decompositions, the SVD and partial (Lanczos, power iteration) eigensolvers
+
+#ifndef EIGEN_HPP
+#define EIGEN_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+#include "matrix.hpp"
+#include "vector.hpp"
+#include "dynamic_matrix.hpp"
+#include "dynamic_vector.hpp"
+#include "iterative.hpp"
+
+namespace linear_algebra {
+
+    namespace detail {
+
+        // |a| with the sign of b
+        template<typename T>
+        T with_sign(T a, T b) {
+            return b >= T(0) ? std::abs(a) : -std::abs(a);
+        }
+
+        // Householder reduction of a symmetric n x n row-major matrix to tridiagonal form.
+        // On entry v holds A (only the lower triangle is read), on return the orthogonal Q with
+        // Q^T A Q tridiagonal, d the diagonal and e the subdiagonal (e[i] couples rows i and i + 1).
+        template<typename T>
+        void symmetric_tridiagonalize(T* v, int n, std::ptrdiff_t ldv, T* d, T* e) {
+            auto V = [&](int i, int j) -> T& { return v[i * ldv + j]; };
+            for (int i = 0; i < n; ++i) {
+                for (int j = i + 1; j < n; ++j) {
+                    V(i, j) = V(j, i);
+                }
+            }
+            for (int j = 0; j < n; ++j) {
+                d[j] = V(n - 1, j);
+            }
+
+            // Reduce row by row from the bottom, e[i] receives the coupling of rows i - 1 and i
+            for (int i = n - 1; i > 0; --i) {
+                T scale = T(0);
+                T h = T(0);
+                for (int k = 0; k < i; ++k) {
+                    scale += std::abs(d[k]);
+                }
+                if (scale == T(0)) {
+                    e[i] = d[i - 1];
+                    for (int j = 0; j < i; ++j) {
+                        d[j] = V(i - 1, j);
+                        V(i, j) = T(0);
+                        V(j, i) = T(0);
+                    }
+                } else {
+                    for (int k = 0; k < i; ++k) {
+                        d[k] /= scale;
+                        h += d[k] * d[k];
+                    }
+                    T f = d[i - 1];
+                    T g = std::sqrt(h);
+                    if (f > T(0)) {
+                        g = -g;
+                    }
+                    e[i] = scale * g;
+                    h -= f * g;
+                    d[i - 1] = f - g;
+                    for (int j = 0; j < i; ++j) {
+                        e[j] = T(0);
+                    }
+                    for (int j = 0; j < i; ++j) {
+                        f = d[j];
+                        V(j, i) = f;
+                        g = e[j] + V(j, j) * f;
+                        for (int k = j + 1; k <= i - 1; ++k) {
+                            g += V(k, j) * d[k];
+                            e[k] += V(k, j) * f;
+                        }
+                        e[j] = g;
+                    }
+                    f = T(0);
+                    for (int j = 0; j < i; ++j) {
+                        e[j] /= h;
+                        f += e[j] * d[j];
+                    }
+                    const T hh = f / (h + h);
+                    for (int j = 0; j < i; ++j) {
+                        e[j] -= hh * d[j];
+                    }
+                    for (int j = 0; j < i; ++j) {
+                        f = d[j];
+                        g = e[j];
+                        for (int k = j; k <= i - 1; ++k) {
+                            V(k, j) -= f * e[k] + g * d[k];
+                        }
+                        d[j] = V(i - 1, j);
+                        V(i, j) = T(0);
+                    }
+                }
+                d[i] = h;
+            }
+
+            // Accumulate the reflectors into Q
+            for (int i = 0; i < n - 1; ++i) {
+                V(n - 1, i) = V(i, i);
+                V(i, i) = T(1);
+                const T h = d[i + 1];
+                if (h != T(0)) {
+                    for (int k = 0; k <= i; ++k) {
+                        d[k] = V(k, i + 1) / h;
+                    }
+                    for (int j = 0; j <= i; ++j) {
+                        T g = T(0);
+                        for (int k = 0; k <= i; ++k) {
+                            g += V(k, i + 1) * V(k, j);
+                        }
+                        for (int k = 0; k <= i; ++k) {
+                            V(k, j) -= g * d[k];
+                        }
+                    }
+                }
+                for (int k = 0; k <= i; ++k) {
+                    V(k, i + 1) = T(0);
+                }
+            }
+            for (int j = 0; j < n; ++j) {
+                d[j] = V(n - 1, j);
+                V(n - 1, j) = T(0);
+            }
+            V(n - 1, n - 1) = T(1);
+
+            // Shift to the convention of the output: e[i] couples rows i and i + 1
+            for (int i = 1; i < n; ++i) {
+                e[i - 1] = e[i];
+            }
+            e[n - 1] = T(0);
+        }
+
+        // Eigenvalues of the symmetric tridiagonal matrix (d, e) by implicit QL with Wilkinson-type
+        // shifts. The rotations are applied to the columns of v (n x n), so passing Q from
+        // symmetric_tridiagonalize yields eigenvectors of A and passing the identity those of the
+        // tridiagonal matrix. Eigenvalues are returned ascending in d with matching columns of v.
+        template<typename T>
+        void symmetric_tridiagonal_eigen(T* d, T* e, int n, T* v, std::ptrdiff_t ldv) {
+            auto V = [&](int i, int j) -> T& { return v[i * ldv + j]; };
+            const T eps = std::numeric_limits<T>::epsilon();
+            const int max_iterations = 30 * std::max(n, 1);
+            if (n > 0) {
+                e[n - 1] = T(0);
+            }
+            T f = T(0);
+            T tst1 = T(0);
+            for (int l = 0; l < n; ++l) {
+                // Find a negligible subdiagonal element that splits off the block starting at l
+                tst1 = std::max(tst1, std::abs(d[l]) + std::abs(e[l]));
+                int m = l;
+                while (m < n - 1 && std::abs(e[m]) > eps * tst1) {
+                    ++m;
+                }
+                if (m > l) {
+                    int iterations = 0;
+                    do {
+                        if (++iterations > max_iterations) {
+                            throw std::runtime_error("Eigenvalue iteration did not converge");
+                        }
+                        T g = d[l];
+                        T p = (d[l + 1] - g) / (T(2) * e[l]);
+                        T r = std::hypot(p, T(1));
+                        if (p < T(0)) {
+                            r = -r;
+                        }
+                        d[l] = e[l] / (p + r);
+                        d[l + 1] = e[l] * (p + r);
+                        const T dl1 = d[l + 1];
+                        T h = g - d[l];
+                        for (int i = l + 2; i < n; ++i) {
+                            d[i] -= h;
+                        }
+                        f += h;
+
+                        p = d[m];
+                        T c = T(1), c2 = c, c3 = c;
+                        const T el1 = e[l + 1];
+                        T s = T(0), s2 = T(0);
+                        for (int i = m - 1; i >= l; --i) {
+                            c3 = c2;
+                            c2 = c;
+                            s2 = s;
+                            g = c * e[i];
+                            h = c * p;
+                            r = std::hypot(p, e[i]);
+                            e[i + 1] = s * r;
+                            s = e[i] / r;
+                            c = p / r;
+                            p = c * d[i] - s * g;
+                            d[i + 1] = h + s * (c * g + s * d[i]);
+                            for (int k = 0; k < n; ++k) {
+                                h = V(k, i + 1);
+                                V(k, i + 1) = s * V(k, i) + c * h;
+                                V(k, i) = c * V(k, i) - s * h;
+                            }
+                        }
+                        p = -s * s2 * c3 * el1 * e[l] / dl1;
+                        e[l] = s * p;
+                        d[l] = c * p;
+                    } while (std::abs(e[l]) > eps * tst1);
+                }
+                d[l] += f;
+                e[l] = T(0);
+            }
+
+            // Selection sort, ascending, moving the eigenvector columns along
+            for (int i = 0; i < n - 1; ++i) {
+                int k = i;
+                T p = d[i];
+                for (int j = i + 1; j < n; ++j) {
+                    if (d[j] < p) {
+                        k = j;
+                        p = d[j];
+                    }
+                }
+                if (k != i) {
+                    d[k] = d[i];
+                    d[i] = p;
+                    for (int j = 0; j < n; ++j) {
+                        std::swap(V(j, i), V(j, k));
+                    }
+                }
+            }
+        }
+
+        // Diagonal similarity scaling by powers of two so rows and columns have comparable norms,
+        // which improves the accuracy of the nonsymmetric eigenvalues without rounding errors
+        template<typename T>
+        void balance(T* a, int n, std::ptrdiff_t lda) {
+            auto A = [&](int i, int j) -> T& { return a[i * lda + j]; };
+            constexpr T radix = T(2);
+            constexpr T radix2 = radix * radix;
+            bool done = false;
+            while (!done) {
+                done = true;
+                for (int i = 0; i < n; ++i) {
+                    T r = T(0), c = T(0);
+                    for (int j = 0; j < n; ++j) {
+                        if (j != i) {
+                            c += std::abs(A(j, i));
+                            r += std::abs(A(i, j));
+                        }
+                    }
+                    if (c != T(0) && r != T(0)) {
+                        T g = r / radix;
+                        T f = T(1);
+                        const T s = c + r;
+                        while (c < g) {
+                            f *= radix;
+                            c *= radix2;
+                        }
+                        g = r * radix;
+                        while (c > g) {
+                            f /= radix;
+                            c /= radix2;
+                        }
+                        if ((c + r) / f < T(0.95) * s) {
+                            done = false;
+                            g = T(1) / f;
+                            for (int j = 0; j < n; ++j) {
+                                A(i, j) *= g;
+                            }
+                            for (int j = 0; j < n; ++j) {
+                                A(j, i) *= f;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        // Householder reduction to upper Hessenberg form, H = P^T A P, in place
+        template<typename T>
+        void hessenberg_reduce(T* a, int n, std::ptrdiff_t lda) {
+            auto A = [&](int i, int j) -> T& { return a[i * lda + j]; };
+            std::vector<T> v(static_cast<std::size_t>(std::max(n, 1)));
+            for (int k = 0; k < n - 2; ++k) {
+                T scale = T(0);
+                for (int i = k + 1; i < n; ++i) {
+                    scale += std::abs(A(i, k));
+                }
+                if (scale == T(0)) {
+                    continue;
+                }
+                T sigma = T(0);
+                for (int i = k + 1; i < n; ++i) {
+                    v[i] = A(i, k) / scale;
+                    sigma += v[i] * v[i];
+                }
+                const T alpha = -with_sign(std::sqrt(sigma), v[k + 1]);
+                // Half the squared norm of the reflector vector v - alpha e1
+                const T half_norm = sigma - v[k + 1] * alpha;
+                v[k + 1] -= alpha;
+
+                for (int j = k; j < n; ++j) {
+                    T f = T(0);
+                    for (int i = k + 1; i < n; ++i) {
+                        f += v[i] * A(i, j);
+                    }
+                    f /= half_norm;
+                    for (int i = k + 1; i < n; ++i) {
+                        A(i, j) -= f * v[i];
+                    }
+                }
+                for (int i = 0; i < n; ++i) {
+                    T f = T(0);
+                    for (int j = k + 1; j < n; ++j) {
+                        f += A(i, j) * v[j];
+                    }
+                    f /= half_norm;
+                    for (int j = k + 1; j < n; ++j) {
+                        A(i, j) -= f * v[j];
+                    }
+                }
+                for (int i = k + 2; i < n; ++i) {
+                    A(i, k) = T(0);
+                }
+            }
+        }
+
+        // Eigenvalues (wr + i wi) of an upper Hessenberg matrix by the Francis double-shift QR
+        // iteration, deflating 1x1 and 2x2 blocks from the bottom. h is destroyed.
+        template<typename T>
+        void hessenberg_eigenvalues(T* h, int n, std::ptrdiff_t ldh, T* wr, T* wi) {
+            auto H = [&](int i, int j) -> T& { return h[i * ldh + j]; };
+            const T eps = std::numeric_limits<T>::epsilon();
+            T anorm = T(0);
+            for (int i = 0; i < n; ++i) {
+                for (int j = std::max(i - 1, 0); j < n; ++j) {
+                    anorm += std::abs(H(i, j));
+                }
+            }
+
+            int nn = n - 1;
+            T t = T(0);
+            while (nn >= 0) {
+                int iterations = 0;
+                int l;
+                do {
+                    // Look for a single small subdiagonal element
+                    for (l = nn; l >= 1; --l) {
+                        T s = std::abs(H(l - 1, l - 1)) + std::abs(H(l, l));
+                        if (s == T(0)) {
+                            s = anorm;
+                        }
+                        if (std::abs(H(l, l - 1)) <= eps * s) {
+                            H(l, l - 1) = T(0);
+                            break;
+                        }
+                    }
+                    T x = H(nn, nn);
+                    if (l == nn) {
+                        // One root found
+                        wr[nn] = x + t;
+                        wi[nn] = T(0);
+                        --nn;
+                    } else {
+                        T y = H(nn - 1, nn - 1);
+                        T w = H(nn, nn - 1) * H(nn - 1, nn);
+                        if (l == nn - 1) {
+                            // Two roots from the trailing 2x2 block
+                            const T p = T(0.5) * (y - x);
+                            const T q = p * p + w;
+                            T z = std::sqrt(std::abs(q));
+                            x += t;
+                            if (q >= T(0)) {
+                                z = p + with_sign(z, p);
+                                wr[nn - 1] = wr[nn] = x + z;
+                                if (z != T(0)) {
+                                    wr[nn] = x - w / z;
+                                }
+                                wi[nn - 1] = wi[nn] = T(0);
+                            } else {
+                                wr[nn - 1] = wr[nn] = x + p;
+                                wi[nn - 1] = -z;
+                                wi[nn] = z;
+                            }
+                            nn -= 2;
+                        } else {
+                            if (iterations == 60) {
+                                throw std::runtime_error("Eigenvalue iteration did not converge");
+                            }
+                            if (iterations == 10 || iterations == 20 || iterations == 40) {
+                                // Exceptional shift to break cycles
+                                t += x;
+                                for (int i = 0; i <= nn; ++i) {
+                                    H(i, i) -= x;
+                                }
+                                const T s = std::abs(H(nn, nn - 1)) + std::abs(H(nn - 1, nn - 2));
+                                y = x = T(0.75) * s;
+                                w = T(-0.4375) * s * s;
+                            }
+                            ++iterations;
+
+                            // Find two consecutive small subdiagonal elements to start the bulge
+                            int m;
+                            T p = T(0), q = T(0), r = T(0), z;
+                            for (m = nn - 2; m >= l; --m) {
+                                z = H(m, m);
+                                r = x - z;
+                                T s = y - z;
+                                p = (r * s - w) / H(m + 1, m) + H(m, m + 1);
+                                q = H(m + 1, m + 1) - z - r - s;
+                                r = H(m + 2, m + 1);
+                                s = std::abs(p) + std::abs(q) + std::abs(r);
+                                p /= s;
+                                q /= s;
+                                r /= s;
+                                if (m == l) {
+                                    break;
+                                }
+                                const T u = std::abs(H(m, m - 1)) * (std::abs(q) + std::abs(r));
+                                const T v = std::abs(p) * (std::abs(H(m - 1, m - 1)) + std::abs(z) + std::abs(H(m + 1, m + 1)));
+                                if (u <= eps * v) {
+                                    break;
+                                }
+                            }
+                            for (int i = m + 2; i <= nn; ++i) {
+                                H(i, i - 2) = T(0);
+                                if (i != m + 2) {
+                                    H(i, i - 3) = T(0);
+                                }
+                            }
+
+                            // Chase the bulge down the active block
+                            for (int k = m; k <= nn - 1; ++k) {
+                                if (k != m) {
+                                    p = H(k, k - 1);
+                                    q = H(k + 1, k - 1);
+                                    r = k != nn - 1 ? H(k + 2, k - 1) : T(0);
+                                    x = std::abs(p) + std::abs(q) + std::abs(r);
+                                    if (x != T(0)) {
+                                        p /= x;
+                                        q /= x;
+                                        r /= x;
+                                    }
+                                }
+                                const T s = with_sign(std::sqrt(p * p + q * q + r * r), p);
+                                if (s == T(0)) {
+                                    continue;
+                                }
+                                if (k == m) {
+                                    if (l != m) {
+                                        H(k, k - 1) = -H(k, k - 1);
+                                    }
+                                } else {
+                                    H(k, k - 1) = -s * x;
+                                }
+                                p += s;
+                                x = p / s;
+                                y = q / s;
+                                z = r / s;
+                                q /= p;
+                                r /= p;
+                                for (int j = k; j <= nn; ++j) {
+                                    p = H(k, j) + q * H(k + 1, j);
+                                    if (k != nn - 1) {
+                                        p += r * H(k + 2, j);
+                                        H(k + 2, j) -= p * z;
+                                    }
+                                    H(k + 1, j) -= p * y;
+                                    H(k, j) -= p * x;
+                                }
+                                const int last = std::min(nn, k + 3);
+                                for (int i = l; i <= last; ++i) {
+                                    p = x * H(i, k) + y * H(i, k + 1);
+                                    if (k != nn - 1) {
+                                        p += z * H(i, k + 2);
+                                        H(i, k + 2) -= p * r;
+                                    }
+                                    H(i, k + 1) -= p * q;
+                                    H(i, k) -= p;
+                                }
+                            }
+                        }
+                    }
+                } while (l < nn - 1);
+            }
+        }
+
+        // Golub-Reinsch SVD of an m x n row-major matrix with m >= n: Householder
+        // bidiagonalization followed by implicit-shift QR on the bidiagonal. On return a holds U
+        // (m x n), w the singular values (unsorted, non-negative) and v the n x n matrix V.
+        template<typename T>
+        void svd_decompose(T* a, int m, int n, std::ptrdiff_t lda, T* w, T* v, std::ptrdiff_t ldv) {
+            auto A = [&](int i, int j) -> T& { return a[i * lda + j]; };
+            auto V = [&](int i, int j) -> T& { return v[i * ldv + j]; };
+            const T eps = std::numeric_limits<T>::epsilon();
+            std::vector<T> rv1(static_cast<std::size_t>(std::max(n, 1)));
+
+            // Bidiagonalization: w gets the diagonal, rv1 the superdiagonal
+            T g = T(0), scale = T(0), anorm = T(0);
+            int l = 0;
+            for (int i = 0; i < n; ++i) {
+                l = i + 1;
+                rv1[i] = scale * g;
+                g = scale = T(0);
+                T s = T(0);
+                if (i < m) {
+                    for (int k = i; k < m; ++k) {
+                        scale += std::abs(A(k, i));
+                    }
+                    if (scale != T(0)) {
+                        for (int k = i; k < m; ++k) {
+                            A(k, i) /= scale;
+                            s += A(k, i) * A(k, i);
+                        }
+                        T f = A(i, i);
+                        g = -with_sign(std::sqrt(s), f);
+                        const T h = f * g - s;
+                        A(i, i) = f - g;
+                        for (int j = l; j < n; ++j) {
+                            s = T(0);
+                            for (int k = i; k < m; ++k) {
+                                s += A(k, i) * A(k, j);
+                            }
+                            f = s / h;
+                            for (int k = i; k < m; ++k) {
+                                A(k, j) += f * A(k, i);
+                            }
+                        }
+                        for (int k = i; k < m; ++k) {
+                            A(k, i) *= scale;
+                        }
+                    }
+                }
+                w[i] = scale * g;
+                g = scale = T(0);
+                s = T(0);
+                if (i < m && i != n - 1) {
+                    for (int k = l; k < n; ++k) {
+                        scale += std::abs(A(i, k));
+                    }
+                    if (scale != T(0)) {
+                        for (int k = l; k < n; ++k) {
+                            A(i, k) /= scale;
+                            s += A(i, k) * A(i, k);
+                        }
+                        const T f = A(i, l);
+                        g = -with_sign(std::sqrt(s), f);
+                        const T h = f * g - s;
+                        A(i, l) = f - g;
+                        for (int k = l; k < n; ++k) {
+                            rv1[k] = A(i, k) / h;
+                        }
+                        for (int j = l; j < m; ++j) {
+                            s = T(0);
+                            for (int k = l; k < n; ++k) {
+                                s += A(j, k) * A(i, k);
+                            }
+                            for (int k = l; k < n; ++k) {
+                                A(j, k) += s * rv1[k];
+                            }
+                        }
+                        for (int k = l; k < n; ++k) {
+                            A(i, k) *= scale;
+                        }
+                    }
+                }
+                anorm = std::max(anorm, std::abs(w[i]) + std::abs(rv1[i]));
+            }
+
+            // Accumulate the right-hand transformations into V
+            for (int i = n - 1; i >= 0; --i) {
+                if (i < n - 1) {
+                    if (g != T(0)) {
+                        // Double division avoids a possible underflow
+                        for (int j = l; j < n; ++j) {
+                            V(j, i) = (A(i, j) / A(i, l)) / g;
+                        }
+                        for (int j = l; j < n; ++j) {
+                            T s = T(0);
+                            for (int k = l; k < n; ++k) {
+                                s += A(i, k) * V(k, j);
+                            }
+                            for (int k = l; k < n; ++k) {
+                                V(k, j) += s * V(k, i);
+                            }
+                        }
+                    }
+                    for (int j = l; j < n; ++j) {
+                        V(i, j) = V(j, i) = T(0);
+                    }
+                }
+                V(i, i) = T(1);
+                g = rv1[i];
+                l = i;
+            }
+
+            // Accumulate the left-hand transformations into U (stored in a)
+            for (int i = std::min(m, n) - 1; i >= 0; --i) {
+                l = i + 1;
+                g = w[i];
+                for (int j = l; j < n; ++j) {
+                    A(i, j) = T(0);
+                }
+                if (g != T(0)) {
+                    g = T(1) / g;
+                    for (int j = l; j < n; ++j) {
+                        T s = T(0);
+                        for (int k = l; k < m; ++k) {
+                            s += A(k, i) * A(k, j);
+                        }
+                        const T f = (s / A(i, i)) * g;
+                        for (int k = i; k < m; ++k) {
+                            A(k, j) += f * A(k, i);
+                        }
+                    }
+                    for (int j = i; j < m; ++j) {
+                        A(j, i) *= g;
+                    }
+                } else {
+                    for (int j = i; j < m; ++j) {
+                        A(j, i) = T(0);
+                    }
+                }
+                A(i, i) += T(1);
+            }
+
+            // Diagonalize the bidiagonal form, one singular value at a time from the bottom
+            constexpr int max_iterations = 75;
+            for (int k = n - 1; k >= 0; --k) {
+                for (int iteration = 1; iteration <= max_iterations; ++iteration) {
+                    // Test for splitting; rv1[0] is always zero, so the scan stops at l = 0
+                    bool cancel = true;
+                    int nm = 0;
+                    for (l = k; l >= 0; --l) {
+                        nm = l - 1;
+                        if (std::abs(rv1[l]) <= eps * anorm) {
+                            cancel = false;
+                            break;
+                        }
+                        if (std::abs(w[nm]) <= eps * anorm) {
+                            break;
+                        }
+                    }
+                    if (cancel) {
+                        // w[nm] is negligible: chase rv1[l] out with rotations
+                        T c = T(0), s = T(1);
+                        for (int i = l; i <= k; ++i) {
+                            const T f = s * rv1[i];
+                            rv1[i] = c * rv1[i];
+                            if (std::abs(f) <= eps * anorm) {
+                                break;
+                            }
+                            g = w[i];
+                            T h = std::hypot(f, g);
+                            w[i] = h;
+                            h = T(1) / h;
+                            c = g * h;
+                            s = -f * h;
+                            for (int j = 0; j < m; ++j) {
+                                const T y = A(j, nm);
+                                const T z = A(j, i);
+                                A(j, nm) = y * c + z * s;
+                                A(j, i) = z * c - y * s;
+                            }
+                        }
+                    }
+                    T z = w[k];
+                    if (l == k) {
+                        // Converged, make the singular value non-negative
+                        if (z < T(0)) {
+                            w[k] = -z;
+                            for (int j = 0; j < n; ++j) {
+                                V(j, k) = -V(j, k);
+                            }
+                        }
+                        break;
+                    }
+                    if (iteration == max_iterations) {
+                        throw std::runtime_error("Singular value iteration did not converge");
+                    }
+
+                    // Shift from the bottom 2x2 minor
+                    T x = w[l];
+                    nm = k - 1;
+                    T y = w[nm];
+                    g = rv1[nm];
+                    T h = rv1[k];
+                    T f = ((y - z) * (y + z) + (g - h) * (g + h)) / (T(2) * h * y);
+                    g = std::hypot(f, T(1));
+                    f = ((x - z) * (x + z) + h * ((y / (f + with_sign(g, f))) - h)) / x;
+
+                    // Next QR transformation
+                    T c = T(1), s = T(1);
+                    for (int j = l; j <= nm; ++j) {
+                        const int i = j + 1;
+                        g = rv1[i];
+                        y = w[i];
+                        h = s * g;
+                        g = c * g;
+                        z = std::hypot(f, h);
+                        rv1[j] = z;
+                        c = f / z;
+                        s = h / z;
+                        f = x * c + g * s;
+                        g = g * c - x * s;
+                        h = y * s;
+                        y *= c;
+                        for (int jj = 0; jj < n; ++jj) {
+                            x = V(jj, j);
+                            z = V(jj, i);
+                            V(jj, j) = x * c + z * s;
+                            V(jj, i) = z * c - x * s;
+                        }
+                        z = std::hypot(f, h);
+                        w[j] = z;
+                        if (z != T(0)) {
+                            z = T(1) / z;
+                            c = f * z;
+                            s = h * z;
+                        }
+                        f = c * g + s * y;
+                        x = c * y - s * g;
+                        for (int jj = 0; jj < m; ++jj) {
+                            y = A(jj, j);
+                            z = A(jj, i);
+                            A(jj, j) = y * c + z * s;
+                            A(jj, i) = z * c - y * s;
+                        }
+                    }
+                    rv1[l] = T(0);
+                    rv1[k] = f;
+                    w[k] = x;
+                }
+            }
+        }
+
+    }
+
+    // Eigendecomposition of a symmetric matrix, A = Q diag(lambda) Q^T, by Householder
+    // tridiagonalization and implicit QL. Only the lower triangle of A is read.
+    template<typename T, int N>
+    class SymmetricEigen {
+    public:
+        explicit SymmetricEigen(const Matrix<T, N, N>& a);
+
+        // Eigenvalues in ascending order
+        const Vector<T, N>& eigenvalues() const { return values; }
+
+        // Orthonormal eigenvectors as columns, column i belongs to eigenvalues()[i]
+        const Matrix<T, N, N>& eigenvectors() const { return vectors; }
+
+    private:
+        Vector<T, N> values;
+        Matrix<T, N, N> vectors;
+    };
+
+    template<typename T, int N>
+    SymmetricEigen<T, N>::SymmetricEigen(const Matrix<T, N, N>& a) : vectors(a) {
+        std::array<T, N> off_diagonal{};
+        detail::symmetric_tridiagonalize(vectors.data_ptr(), N, N, values.data_ptr(), off_diagonal.data());
+        detail::symmetric_tridiagonal_eigen(values.data_ptr(), off_diagonal.data(), N, vectors.data_ptr(), N);
+    }
+
+    // Eigenvalues of a general real matrix: balancing, Householder reduction to Hessenberg form
+    // and the shifted (Francis double-shift) QR iteration. Complex eigenvalues come in conjugate pairs.
+    template<typename T, int N>
+    class NonsymmetricEigen {
+    public:
+        explicit NonsymmetricEigen(const Matrix<T, N, N>& a);
+
+        // Eigenvalues sorted by real part, then imaginary part
+        const Vector<std::complex<T>, N>& eigenvalues() const { return values; }
+
+        // Largest real part of the eigenvalues, negative for an asymptotically stable x' = A x
+        T spectral_abscissa() const { return values[N - 1].real(); }
+
+        // Largest eigenvalue magnitude, below one for a stable iteration x <- A x
+        T spectral_radius() const;
+
+    private:
+        Vector<std::complex<T>, N> values;
+    };
+
+    template<typename T, int N>
+    NonsymmetricEigen<T, N>::NonsymmetricEigen(const Matrix<T, N, N>& a) {
+        Matrix<T, N, N> h = a;
+        std::array<T, N> wr{}, wi{};
+        detail::balance(h.data_ptr(), N, N);
+        detail::hessenberg_reduce(h.data_ptr(), N, N);
+        detail::hessenberg_eigenvalues(h.data_ptr(), N, N, wr.data(), wi.data());
+
+        std::array<std::complex<T>, N> sorted;
+        for (int i = 0; i < N; ++i) {
+            sorted[i] = std::complex<T>(wr[i], wi[i]);
+        }
+        std::sort(sorted.begin(), sorted.end(), [](const std::complex<T>& x, const std::complex<T>& y) {
+            return x.real() != y.real() ? x.real() < y.real() : x.imag() < y.imag();
+        });
+        for (int i = 0; i < N; ++i) {
+            values[i] = sorted[i];
+        }
+    }
+
+    template<typename T, int N>
+    T NonsymmetricEigen<T, N>::spectral_radius() const {
+        T radius = T(0);
+        for (int i = 0; i < N; ++i) {
+            radius = std::max(radius, std::abs(values[i]));
+        }
+        return radius;
+    }
+
+    // Thin singular value decomposition A = U diag(sigma) V^T with K = min(Rows, Cols)
+    template<typename T, int Rows, int Cols>
+    class SVD {
+    public:
+        static constexpr int K = Rows < Cols ? Rows : Cols;
+
+        explicit SVD(const Matrix<T, Rows, Cols>& a);
+
+        // Singular values in descending order
+        const Vector<T, K>& singular_values() const { return sigma; }
+
+        // Left and right singular vectors as orthonormal columns
+        const Matrix<T, Rows, K>& u() const { return left; }
+        const Matrix<T, Cols, K>& v() const { return right; }
+
+        // Number of singular values above tolerance, by default max(Rows, Cols) * eps * sigma_max
+        int rank(T tolerance = T(-1)) const;
+
+        // sigma_max / sigma_min, infinite for a rank deficient matrix
+        T condition_number() const;
+
+        // Moore-Penrose pseudo-inverse V diag(1 / sigma) U^T over the numerical rank
+        Matrix<T, Cols, Rows> pseudo_inverse() const;
+
+    private:
+        T default_tolerance() const;
+
+        Vector<T, K> sigma;
+        Matrix<T, Rows, K> left;
+        Matrix<T, Cols, K> right;
+    };
+
+    template<typename T, int Rows, int Cols>
+    SVD<T, Rows, Cols>::SVD(const Matrix<T, Rows, Cols>& a) {
+        // The kernel wants at least as many rows as columns; wide matrices are decomposed transposed
+        constexpr int m = Rows >= Cols ? Rows : Cols;
+        std::vector<T> work(static_cast<std::size_t>(m) * K);
+        std::vector<T> w(K);
+        std::vector<T> vk(static_cast<std::size_t>(K) * K);
+        for (int i = 0; i < Rows; ++i) {
+            for (int j = 0; j < Cols; ++j) {
+                if constexpr (Rows >= Cols) {
+                    work[static_cast<std::size_t>(i) * K + j] = a(i, j);
+                } else {
+                    work[static_cast<std::size_t>(j) * K + i] = a(i, j);
+                }
+            }
+        }
+        detail::svd_decompose(work.data(), m, K, K, w.data(), vk.data(), K);
+
+        // Sort descending, carrying the singular vectors along
+        std::array<int, K> order;
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](int x, int y) { return w[x] > w[y]; });
+        for (int c = 0; c < K; ++c) {
+            const int src = order[c];
+            sigma[c] = w[src];
+            for (int i = 0; i < m; ++i) {
+                const T value = work[static_cast<std::size_t>(i) * K + src];
+                if constexpr (Rows >= Cols) {
+                    left(i, c) = value;
+                } else {
+                    right(i, c) = value;
+                }
+            }
+            for (int i = 0; i < K; ++i) {
+                const T value = vk[static_cast<std::size_t>(i) * K + src];
+                if constexpr (Rows >= Cols) {
+                    right(i, c) = value;
+                } else {
+                    left(i, c) = value;
+                }
+            }
+        }
+    }
+
+    template<typename T, int Rows, int Cols>
+    T SVD<T, Rows, Cols>::default_tolerance() const {
+        return static_cast<T>(Rows > Cols ? Rows : Cols) * std::numeric_limits<T>::epsilon() * (K > 0 ? sigma[0] : T(0));
+    }
+
+    template<typename T, int Rows, int Cols>
+    int SVD<T, Rows, Cols>::rank(T tolerance) const {
+        if (tolerance < T(0)) {
+            tolerance = default_tolerance();
+        }
+        int r = 0;
+        for (int i = 0; i < K; ++i) {
+            if (sigma[i] > tolerance) {
+                ++r;
+            }
+        }
+        return r;
+    }
+
+    template<typename T, int Rows, int Cols>
+    T SVD<T, Rows, Cols>::condition_number() const {
+        if (K == 0 || sigma[K - 1] == T(0)) {
+            return std::numeric_limits<T>::infinity();
+        }
+        return sigma[0] / sigma[K - 1];
+    }
+
+    template<typename T, int Rows, int Cols>
+    Matrix<T, Cols, Rows> SVD<T, Rows, Cols>::pseudo_inverse() const {
+        const int r = rank();
+        Matrix<T, Cols, Rows> result;
+        for (int c = 0; c < r; ++c) {
+            const T inv = T(1) / sigma[c];
+            for (int i = 0; i < Cols; ++i) {
+                const T vi = right(i, c) * inv;
+                for (int j = 0; j < Rows; ++j) {
+                    result(i, j) += vi * left(j, c);
+                }
+            }
+        }
+        return result;
+    }
+
+    // Partial eigensolvers for symmetric operators of size n given as anything the iterative
+    // solvers accept (dense or sparse matrices, or a callable op(x, y) computing y = A x).
+
+    template<typename T>
+    struct PartialEigenOptions {
+        // Ritz pairs are accepted once ||A x - lambda x|| <= tolerance * max(|lambda|, 1)
+        T tolerance = T(1e-10);
+        // Operator applications before giving up
+        std::size_t max_iterations = 10000;
+    };
+
+    template<typename T>
+    struct PartialEigenResult {
+        // Requested eigenvalues, largest first
+        DynamicVector<T> values;
+        // Matching unit eigenvectors as columns (n x k)
+        DynamicMatrix<T> vectors;
+        bool converged = false;
+        // Operator applications performed
+        std::size_t iterations = 0;
+    };
+
+    namespace detail {
+
+        // Deterministic start vector with no special structure, so it is unlikely to be
+        // orthogonal to any eigenvector
+        template<typename T>
+        DynamicVector<T> start_vector(std::size_t n) {
+            DynamicVector<T> v(n);
+            std::uint64_t state = 0x9e3779b97f4a7c15ULL;
+            for (std::size_t i = 0; i < n; ++i) {
+                state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+                v[i] = static_cast<T>(static_cast<double>(state >> 11) / 9007199254740992.0 - 0.5);
+            }
+            const T norm = norm2(v);
+            for (std::size_t i = 0; i < n; ++i) {
+                v[i] /= norm;
+            }
+            return v;
+        }
+
+    }
+
+    // Dominant eigenpair (largest magnitude) by power iteration with a Rayleigh quotient estimate.
+    // Converges at the rate |lambda_2 / lambda_1|; use lanczos_eigen when the gap is small.
+    template<typename T, typename Op>
+    PartialEigenResult<T> power_iteration(const Op& a, std::size_t n, const PartialEigenOptions<T>& options = {}) {
+        PartialEigenResult<T> result;
+        DynamicVector<T> x = detail::start_vector<T>(n);
+        DynamicVector<T> y(n);
+        T lambda = T(0);
+        while (result.iterations < options.max_iterations) {
+            detail::apply_operator(a, x, y);
+            ++result.iterations;
+            lambda = detail::dot(x, y);
+            T residual = T(0);
+            for (std::size_t i = 0; i < n; ++i) {
+                const T ri = y[i] - lambda * x[i];
+                residual += ri * ri;
+            }
+            const T y_norm = detail::norm2(y);
+            if (std::sqrt(residual) <= options.tolerance * std::max(std::abs(lambda), T(1)) || y_norm == T(0)) {
+                result.converged = true;
+                break;
+            }
+            for (std::size_t i = 0; i < n; ++i) {
+                x[i] = y[i] / y_norm;
+            }
+        }
+        result.values = DynamicVector<T>{lambda};
+        result.vectors = DynamicMatrix<T>(n, 1);
+        for (std::size_t i = 0; i < n; ++i) {
+            result.vectors(i, 0) = x[i];
+        }
+        return result;
+    }
+
+    // The k algebraically largest eigenpairs of a symmetric operator by the Lanczos process with
+    // full reorthogonalization. The Krylov basis starts at max(2k, 20) vectors and doubles
+    // until the k Ritz pairs meet the tolerance (or the basis spans the whole space).
+    template<typename T, typename Op>
+    PartialEigenResult<T> lanczos_eigen(const Op& a, std::size_t n, std::size_t k, const PartialEigenOptions<T>& options = {}) {
+        if (k == 0 || k > n) {
+            throw std::invalid_argument("Number of requested eigenpairs must be between 1 and the operator size");
+        }
+        PartialEigenResult<T> result;
+        std::size_t basis_size = std::min(n, std::max<std::size_t>(2 * k, 20));
+        while (true) {
+            std::vector<DynamicVector<T>> q;
+            q.reserve(basis_size);
+            q.push_back(detail::start_vector<T>(n));
+            std::vector<T> alpha, beta;
+            DynamicVector<T> w(n);
+            for (std::size_t j = 0; j < basis_size; ++j) {
+                detail::apply_operator(a, q[j], w);
+                ++result.iterations;
+                alpha.push_back(detail::dot(q[j], w));
+                // Two passes of classical Gram-Schmidt against the whole basis keep it orthogonal
+                // to working precision, which plain three-term recurrence does not
+                for (int pass = 0; pass < 2; ++pass) {
+                    for (std::size_t i = 0; i <= j; ++i) {
+                        detail::axpy(-detail::dot(q[i], w), q[i], w);
+                    }
+                }
+                const T b = detail::norm2(w);
+                if (j + 1 == basis_size) {
+                    beta.push_back(b);
+                    break;
+                }
+                if (b <= std::numeric_limits<T>::epsilon() * std::max(std::abs(alpha.back()), T(1))) {
+                    // Invariant subspace found, its Ritz values are exact
+                    beta.push_back(T(0));
+                    break;
+                }
+                beta.push_back(b);
+                DynamicVector<T> next(n);
+                for (std::size_t i = 0; i < n; ++i) {
+                    next[i] = w[i] / b;
+                }
+                q.push_back(std::move(next));
+            }
+
+            // Ritz values and vectors from the tridiagonal projection
+            const int m = static_cast<int>(alpha.size());
+            std::vector<T> d(alpha), e(static_cast<std::size_t>(m), T(0));
+            for (int i = 0; i + 1 < m; ++i) {
+                e[i] = beta[i];
+            }
+            std::vector<T> s(static_cast<std::size_t>(m) * m, T(0));
+            for (int i = 0; i < m; ++i) {
+                s[static_cast<std::size_t>(i) * m + i] = T(1);
+            }
+            detail::symmetric_tridiagonal_eigen(d.data(), e.data(), m, s.data(), m);
+
+            const std::size_t found = std::min<std::size_t>(k, static_cast<std::size_t>(m));
+            bool converged = found == k;
+            const T last_beta = beta.back();
+            for (std::size_t c = 0; c < found; ++c) {
+                const int col = m - 1 - static_cast<int>(c);
+                // ||A y - theta y|| = |beta_m * s(m, i)| for the Ritz pair (theta, y)
+                const T residual = std::abs(last_beta * s[static_cast<std::size_t>(m - 1) * m + col]);
+                converged = converged && residual <= options.tolerance * std::max(std::abs(d[col]), T(1));
+            }
+
+            const bool exhausted = basis_size >= n || static_cast<std::size_t>(m) < basis_size
+                                   || result.iterations >= options.max_iterations;
+            if (converged || exhausted) {
+                result.converged = converged;
+                result.values = DynamicVector<T>(found);
+                result.vectors = DynamicMatrix<T>(n, found);
+                for (std::size_t c = 0; c < found; ++c) {
+                    const int col = m - 1 - static_cast<int>(c);
+                    result.values[c] = d[col];
+                    for (int j = 0; j < m; ++j) {
+                        const T coefficient = s[static_cast<std::size_t>(j) * m + col];
+                        for (std::size_t i = 0; i < n; ++i) {
+                            result.vectors(i, c) += coefficient * q[j][i];
+                        }
+                    }
+                }
+                return result;
+            }
+            basis_size = std::min(n, 2 * basis_size);
+        }
+    }
+
+    template<typename T>
+    struct PartialSVDResult {
+        // Leading singular values, largest first, and the matching singular vectors as columns
+        DynamicVector<T> values;
+        DynamicMatrix<T> u;
+        DynamicMatrix<T> v;
+        bool converged = false;
+        std::size_t iterations = 0;
+    };
+
+    // The k leading singular triplets of a (dense or sparse) matrix with rows(), cols() and
+    // transpose(), from the Lanczos eigenpairs of A^T A: sigma = sqrt(lambda), u = A v / sigma.
+    // Squaring halves the relative accuracy of small singular values, which is fine for the
+    // leading components this is meant for.
+    template<typename T, typename Mat>
+    PartialSVDResult<T> partial_svd(const Mat& a, std::size_t k, const PartialEigenOptions<T>& options = {}) {
+        const Mat at = a.transpose();
+        DynamicVector<T> ax(a.rows());
+        auto normal = [&](const DynamicVector<T>& x, DynamicVector<T>& y) {
+            detail::apply_operator(a, x, ax);
+            detail::apply_operator(at, ax, y);
+        };
+        PartialEigenResult<T> eigen = lanczos_eigen(normal, a.cols(), k, options);
+
+        PartialSVDResult<T> result;
+        const std::size_t found = eigen.values.size();
+        result.converged = eigen.converged;
+        result.iterations = eigen.iterations;
+        result.values = DynamicVector<T>(found);
+        result.u = DynamicMatrix<T>(a.rows(), found);
+        result.v = eigen.vectors;
+        DynamicVector<T> vc(a.cols()), uc(a.rows());
+        for (std::size_t c = 0; c < found; ++c) {
+            const T sigma = std::sqrt(std::max(eigen.values[c], T(0)));
+            result.values[c] = sigma;
+            for (std::size_t i = 0; i < a.cols(); ++i) {
+                vc[i] = eigen.vectors(i, c);
+            }
+            detail::apply_operator(a, vc, uc);
+            for (std::size_t i = 0; i < a.rows(); ++i) {
+                result.u(i, c) = sigma > T(0) ? uc[i] / sigma : T(0);
+            }
+        }
+        return result;
+    }
+
+}
+
+#endif
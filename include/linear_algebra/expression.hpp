@@ -0,0 +1,381 @@
+//Contains implementation for lazy element-wise expressions over Vector and Matrix
+
+#ifndef EXPRESSION_HPP
+#define EXPRESSION_HPP
+
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "simd.hpp"
+
+namespace linear_algebra {
+
+    // Forward declarations
+    template<typename T, size_t N>
+    class Vector;
+
+    template<typename T, int Rows, int Cols>
+    class Matrix;
+
+    // Base of every vector-valued expression. E is the concrete node type; elements are read with E::operator[].
+    // Nothing is computed until the expression is assigned to a Vector, which then walks the data once.
+    template<typename E, typename T, size_t N>
+    class VectorExpression {
+    public:
+        using value_type = T;
+
+        constexpr const E& self() const { return static_cast<const E&>(*this); }
+
+        constexpr Vector<T, N> eval() const { return Vector<T, N>(*this); }
+    };
+
+    // Base of every matrix-valued expression, elements are read with E::operator()(row, col)
+    template<typename E, typename T, int Rows, int Cols>
+    class MatrixExpression {
+    public:
+        using value_type = T;
+
+        constexpr const E& self() const { return static_cast<const E&>(*this); }
+
+        constexpr Matrix<T, Rows, Cols> eval() const { return Matrix<T, Rows, Cols>(*this); }
+
+        void display() const { eval().display(); }
+    };
+
+    namespace detail {
+
+        // Concrete Vector/Matrix operands are held by reference, intermediate nodes by value.
+        // Temporary Vector/Matrix operands never reach a node: the rvalue overloads at the end of
+        // this file evaluate into them, so a node cannot outlive what it refers to.
+        template<typename E>
+        struct is_expression_leaf : std::false_type {};
+
+        template<typename T, size_t N>
+        struct is_expression_leaf<Vector<T, N>> : std::true_type {};
+
+        template<typename T, int Rows, int Cols>
+        struct is_expression_leaf<Matrix<T, Rows, Cols>> : std::true_type {};
+
+        template<typename E>
+        using expression_operand_t = std::conditional_t<is_expression_leaf<E>::value, const E&, const E>;
+
+    }
+
+    // Element-wise combination of two vector expressions
+    template<typename L, typename R, typename Op, typename T, size_t N>
+    class VectorBinaryExpression : public VectorExpression<VectorBinaryExpression<L, R, Op, T, N>, T, N> {
+    public:
+        constexpr VectorBinaryExpression(const L& lhs, const R& rhs) : lhs(lhs), rhs(rhs) {}
+
+        constexpr T operator[](size_t i) const { return Op{}(lhs[i], rhs[i]); }
+
+        constexpr const L& left() const { return lhs; }
+        constexpr const R& right() const { return rhs; }
+
+    private:
+        detail::expression_operand_t<L> lhs;
+        detail::expression_operand_t<R> rhs;
+    };
+
+    // Element-wise combination of a vector expression with a scalar
+    template<typename E, typename Op, typename T, size_t N>
+    class VectorScalarExpression : public VectorExpression<VectorScalarExpression<E, Op, T, N>, T, N> {
+    public:
+        constexpr VectorScalarExpression(const E& expr, const T& scalar) : expr(expr), scalar(scalar) {}
+
+        constexpr T operator[](size_t i) const { return Op{}(expr[i], scalar); }
+
+        constexpr const E& operand() const { return expr; }
+        constexpr const T& scalar_operand() const { return scalar; }
+
+    private:
+        detail::expression_operand_t<E> expr;
+        T scalar;
+    };
+
+    // Element-wise combination of two matrix expressions
+    template<typename L, typename R, typename Op, typename T, int Rows, int Cols>
+    class MatrixBinaryExpression : public MatrixExpression<MatrixBinaryExpression<L, R, Op, T, Rows, Cols>, T, Rows, Cols> {
+    public:
+        constexpr MatrixBinaryExpression(const L& lhs, const R& rhs) : lhs(lhs), rhs(rhs) {}
+
+        constexpr T operator()(int row, int col) const { return Op{}(lhs(row, col), rhs(row, col)); }
+
+        constexpr const L& left() const { return lhs; }
+        constexpr const R& right() const { return rhs; }
+
+    private:
+        detail::expression_operand_t<L> lhs;
+        detail::expression_operand_t<R> rhs;
+    };
+
+    // Element-wise combination of a matrix expression with a scalar
+    template<typename E, typename Op, typename T, int Rows, int Cols>
+    class MatrixScalarExpression : public MatrixExpression<MatrixScalarExpression<E, Op, T, Rows, Cols>, T, Rows, Cols> {
+    public:
+        constexpr MatrixScalarExpression(const E& expr, const T& scalar) : expr(expr), scalar(scalar) {}
+
+        constexpr T operator()(int row, int col) const { return Op{}(expr(row, col), scalar); }
+
+        constexpr const E& operand() const { return expr; }
+        constexpr const T& scalar_operand() const { return scalar; }
+
+    private:
+        detail::expression_operand_t<E> expr;
+        T scalar;
+    };
+
+    namespace detail {
+
+        template<typename Op>
+        struct simd_operation {
+            static constexpr bool supported = false;
+        };
+
+        template<>
+        struct simd_operation<std::plus<>> {
+            static constexpr bool supported = true;
+            using type = simd::add_op;
+        };
+
+        template<>
+        struct simd_operation<std::minus<>> {
+            static constexpr bool supported = true;
+            using type = simd::sub_op;
+        };
+
+        template<>
+        struct simd_operation<std::multiplies<>> {
+            static constexpr bool supported = true;
+            using type = simd::mul_op;
+        };
+
+        // A single operation applied to concrete operands maps directly onto a SIMD kernel over contiguous storage
+        template<typename E>
+        struct is_simd_assignable : std::false_type {};
+
+        template<typename L, typename R, typename Op, typename T, size_t N>
+        struct is_simd_assignable<VectorBinaryExpression<L, R, Op, T, N>>
+            : std::bool_constant<is_expression_leaf<L>::value && is_expression_leaf<R>::value && simd_operation<Op>::supported> {};
+
+        template<typename E, typename T, size_t N>
+        struct is_simd_assignable<VectorScalarExpression<E, std::multiplies<>, T, N>>
+            : std::bool_constant<is_expression_leaf<E>::value> {};
+
+        template<typename L, typename R, typename Op, typename T, int Rows, int Cols>
+        struct is_simd_assignable<MatrixBinaryExpression<L, R, Op, T, Rows, Cols>>
+            : std::bool_constant<is_expression_leaf<L>::value && is_expression_leaf<R>::value && simd_operation<Op>::supported> {};
+
+        template<typename E, typename T, int Rows, int Cols>
+        struct is_simd_assignable<MatrixScalarExpression<E, std::multiplies<>, T, Rows, Cols>>
+            : std::bool_constant<is_expression_leaf<E>::value> {};
+
+        template<typename T, typename L, typename R, typename Op, size_t N>
+        constexpr void assign_simd(T* dst, const VectorBinaryExpression<L, R, Op, T, N>& e) {
+            simd::binary(dst, e.left().data_ptr(), e.right().data_ptr(), N, typename simd_operation<Op>::type{});
+        }
+
+        template<typename T, typename E, size_t N>
+        constexpr void assign_simd(T* dst, const VectorScalarExpression<E, std::multiplies<>, T, N>& e) {
+            simd::scale(dst, e.operand().data_ptr(), e.scalar_operand(), N);
+        }
+
+        template<typename T, typename L, typename R, typename Op, int Rows, int Cols>
+        constexpr void assign_simd(T* dst, const MatrixBinaryExpression<L, R, Op, T, Rows, Cols>& e) {
+            simd::binary(dst, e.left().data_ptr(), e.right().data_ptr(), static_cast<size_t>(Rows) * Cols, typename simd_operation<Op>::type{});
+        }
+
+        template<typename T, typename E, int Rows, int Cols>
+        constexpr void assign_simd(T* dst, const MatrixScalarExpression<E, std::multiplies<>, T, Rows, Cols>& e) {
+            simd::scale(dst, e.operand().data_ptr(), e.scalar_operand(), static_cast<size_t>(Rows) * Cols);
+        }
+
+        // Write a vector expression into contiguous storage of N elements
+        template<typename T, size_t N, typename E>
+        constexpr void assign_expression(T* dst, const VectorExpression<E, T, N>& expr) {
+            const E& e = expr.self();
+            if constexpr (is_simd_assignable<E>::value) {
+                assign_simd(dst, e);
+            } else {
+                for (size_t i = 0; i < N; ++i) {
+                    dst[i] = e[i];
+                }
+            }
+        }
+
+        // Write a matrix expression into contiguous row-major storage
+        template<typename T, int Rows, int Cols, typename E>
+        constexpr void assign_expression(T* dst, const MatrixExpression<E, T, Rows, Cols>& expr) {
+            const E& e = expr.self();
+            if constexpr (is_simd_assignable<E>::value) {
+                assign_simd(dst, e);
+            } else {
+                for (int i = 0; i < Rows; ++i) {
+                    for (int j = 0; j < Cols; ++j) {
+                        dst[i * Cols + j] = e(i, j);
+                    }
+                }
+            }
+        }
+
+    }
+
+    // Vector operators
+    template<typename L, typename R, typename T, size_t N>
+    constexpr VectorBinaryExpression<L, R, std::plus<>, T, N> operator+(const VectorExpression<L, T, N>& lhs, const VectorExpression<R, T, N>& rhs) {
+        return {lhs.self(), rhs.self()};
+    }
+
+    template<typename L, typename R, typename T, size_t N>
+    constexpr VectorBinaryExpression<L, R, std::minus<>, T, N> operator-(const VectorExpression<L, T, N>& lhs, const VectorExpression<R, T, N>& rhs) {
+        return {lhs.self(), rhs.self()};
+    }
+
+    template<typename E, typename T, size_t N>
+    constexpr VectorScalarExpression<E, std::multiplies<>, T, N> operator*(const VectorExpression<E, T, N>& expr, const std::type_identity_t<T>& scalar) {
+        return {expr.self(), scalar};
+    }
+
+    template<typename E, typename T, size_t N>
+    constexpr VectorScalarExpression<E, std::multiplies<>, T, N> operator*(const std::type_identity_t<T>& scalar, const VectorExpression<E, T, N>& expr) {
+        return {expr.self(), scalar};
+    }
+
+    // Matrix operators
+    template<typename L, typename R, typename T, int Rows, int Cols>
+    constexpr MatrixBinaryExpression<L, R, std::plus<>, T, Rows, Cols> operator+(const MatrixExpression<L, T, Rows, Cols>& lhs, const MatrixExpression<R, T, Rows, Cols>& rhs) {
+        return {lhs.self(), rhs.self()};
+    }
+
+    template<typename L, typename R, typename T, int Rows, int Cols>
+    constexpr MatrixBinaryExpression<L, R, std::minus<>, T, Rows, Cols> operator-(const MatrixExpression<L, T, Rows, Cols>& lhs, const MatrixExpression<R, T, Rows, Cols>& rhs) {
+        return {lhs.self(), rhs.self()};
+    }
+
+    template<typename E, typename T, int Rows, int Cols>
+    constexpr MatrixScalarExpression<E, std::multiplies<>, T, Rows, Cols> operator*(const MatrixExpression<E, T, Rows, Cols>& expr, const std::type_identity_t<T>& scalar) {
+        return {expr.self(), scalar};
+    }
+
+    template<typename E, typename T, int Rows, int Cols>
+    constexpr MatrixScalarExpression<E, std::multiplies<>, T, Rows, Cols> operator*(const std::type_identity_t<T>& scalar, const MatrixExpression<E, T, Rows, Cols>& expr) {
+        return {expr.self(), scalar};
+    }
+
+    template<typename E, typename T, int Rows, int Cols>
+    constexpr MatrixScalarExpression<E, std::divides<>, T, Rows, Cols> operator/(const MatrixExpression<E, T, Rows, Cols>& expr, const std::type_identity_t<T>& scalar) {
+        if (scalar == T(0)) {
+            throw std::runtime_error("Division by zero");
+        }
+        return {expr.self(), scalar};
+    }
+
+    // Operators with a temporary Vector/Matrix operand evaluate at once into its storage and return it,
+    // a lazy node kept with auto would otherwise refer to the destroyed temporary
+    template<typename T, size_t N, typename R>
+    constexpr Vector<T, N> operator+(Vector<T, N>&& lhs, const VectorExpression<R, T, N>& rhs) {
+        lhs += rhs.self();
+        return std::move(lhs);
+    }
+
+    template<typename L, typename T, size_t N>
+    constexpr Vector<T, N> operator+(const VectorExpression<L, T, N>& lhs, Vector<T, N>&& rhs) {
+        rhs = lhs.self() + rhs;
+        return std::move(rhs);
+    }
+
+    template<typename T, size_t N>
+    constexpr Vector<T, N> operator+(Vector<T, N>&& lhs, Vector<T, N>&& rhs) {
+        lhs += rhs;
+        return std::move(lhs);
+    }
+
+    template<typename T, size_t N, typename R>
+    constexpr Vector<T, N> operator-(Vector<T, N>&& lhs, const VectorExpression<R, T, N>& rhs) {
+        lhs -= rhs.self();
+        return std::move(lhs);
+    }
+
+    template<typename L, typename T, size_t N>
+    constexpr Vector<T, N> operator-(const VectorExpression<L, T, N>& lhs, Vector<T, N>&& rhs) {
+        rhs = lhs.self() - rhs;
+        return std::move(rhs);
+    }
+
+    template<typename T, size_t N>
+    constexpr Vector<T, N> operator-(Vector<T, N>&& lhs, Vector<T, N>&& rhs) {
+        lhs -= rhs;
+        return std::move(lhs);
+    }
+
+    template<typename T, size_t N>
+    constexpr Vector<T, N> operator*(Vector<T, N>&& vec, const std::type_identity_t<T>& scalar) {
+        vec *= scalar;
+        return std::move(vec);
+    }
+
+    template<typename T, size_t N>
+    constexpr Vector<T, N> operator*(const std::type_identity_t<T>& scalar, Vector<T, N>&& vec) {
+        vec *= scalar;
+        return std::move(vec);
+    }
+
+    template<typename T, int Rows, int Cols, typename R>
+    constexpr Matrix<T, Rows, Cols> operator+(Matrix<T, Rows, Cols>&& lhs, const MatrixExpression<R, T, Rows, Cols>& rhs) {
+        lhs += rhs.self();
+        return std::move(lhs);
+    }
+
+    template<typename L, typename T, int Rows, int Cols>
+    constexpr Matrix<T, Rows, Cols> operator+(const MatrixExpression<L, T, Rows, Cols>& lhs, Matrix<T, Rows, Cols>&& rhs) {
+        rhs = lhs.self() + rhs;
+        return std::move(rhs);
+    }
+
+    template<typename T, int Rows, int Cols>
+    constexpr Matrix<T, Rows, Cols> operator+(Matrix<T, Rows, Cols>&& lhs, Matrix<T, Rows, Cols>&& rhs) {
+        lhs += rhs;
+        return std::move(lhs);
+    }
+
+    template<typename T, int Rows, int Cols, typename R>
+    constexpr Matrix<T, Rows, Cols> operator-(Matrix<T, Rows, Cols>&& lhs, const MatrixExpression<R, T, Rows, Cols>& rhs) {
+        lhs -= rhs.self();
+        return std::move(lhs);
+    }
+
+    template<typename L, typename T, int Rows, int Cols>
+    constexpr Matrix<T, Rows, Cols> operator-(const MatrixExpression<L, T, Rows, Cols>& lhs, Matrix<T, Rows, Cols>&& rhs) {
+        rhs = lhs.self() - rhs;
+        return std::move(rhs);
+    }
+
+    template<typename T, int Rows, int Cols>
+    constexpr Matrix<T, Rows, Cols> operator-(Matrix<T, Rows, Cols>&& lhs, Matrix<T, Rows, Cols>&& rhs) {
+        lhs -= rhs;
+        return std::move(lhs);
+    }
+
+    template<typename T, int Rows, int Cols>
+    constexpr Matrix<T, Rows, Cols> operator*(Matrix<T, Rows, Cols>&& m, const std::type_identity_t<T>& scalar) {
+        m *= scalar;
+        return std::move(m);
+    }
+
+    template<typename T, int Rows, int Cols>
+    constexpr Matrix<T, Rows, Cols> operator*(const std::type_identity_t<T>& scalar, Matrix<T, Rows, Cols>&& m) {
+        m *= scalar;
+        return std::move(m);
+    }
+
+    template<typename T, int Rows, int Cols>
+    constexpr Matrix<T, Rows, Cols> operator/(Matrix<T, Rows, Cols>&& m, const std::type_identity_t<T>& scalar) {
+        m /= scalar;
+        return std::move(m);
+    }
+
+}
+
+#endif
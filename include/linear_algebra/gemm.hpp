@@ -0,0 +1,342 @@
+//Contains implementation for the cache-blocked matrix multiply and transpose kernels
+
+#ifndef GEMM_HPP
+#define GEMM_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include "parallel.hpp"
+
+namespace linear_algebra {
+
+    // Operand flag of the multiply entry points: op(A) is A itself or A^T, read in place
+    enum class Transpose { No, Yes };
+
+    namespace detail {
+
+        // Blocking parameters for the packed kernel.
+        // MR x NR is the register tile held in accumulators by the micro-kernel,
+        // a packed MC x KC block of A is sized to stay in L2 and a KC x NR sliver of B in L1.
+        // The 6 x 24 tile vectorizes cleanly for both float and double; some widths (e.g. 16) do not.
+        template<typename T>
+        struct gemm_blocking {
+            static constexpr int MR = 6;
+            static constexpr int NR = 24;
+            static constexpr int KC = 256;
+            static constexpr int MC = 96;
+            static constexpr int NC = 2048;
+        };
+
+        // Products with fewer multiply-adds than this skip packing and use a plain loop
+        inline constexpr long gemm_small_threshold = 32L * 32L * 32L;
+
+        // Operands of the strided kernels: element (i, p) of A is a[i * rsa + p * csa], and likewise
+        // for B. A row-major block has strides (ld, 1), its transpose is read with (1, ld).
+
+        // Plain loop for small products, C += A B. Rows of B and C are streamed when B is row-major;
+        // a transposed B has contiguous columns, so each entry of C becomes a dot product instead.
+        template<typename T>
+        void gemm_simple(int m, int n, int k, const T* a, std::ptrdiff_t rsa, std::ptrdiff_t csa,
+                         const T* b, std::ptrdiff_t rsb, std::ptrdiff_t csb, T* c, std::ptrdiff_t ldc) {
+            if (csb != 1 && rsb == 1) {
+                for (int i = 0; i < m; ++i) {
+                    const T* ai = a + i * rsa;
+                    for (int j = 0; j < n; ++j) {
+                        const T* bj = b + j * csb;
+                        T sum = T();
+                        for (int p = 0; p < k; ++p) {
+                            sum += ai[p * csa] * bj[p];
+                        }
+                        c[i * ldc + j] += sum;
+                    }
+                }
+                return;
+            }
+            for (int i = 0; i < m; ++i) {
+                T* ci = c + i * ldc;
+                for (int p = 0; p < k; ++p) {
+                    const T aip = a[i * rsa + p * csa];
+                    const T* bp = b + p * rsb;
+                    for (int j = 0; j < n; ++j) {
+                        ci[j] += aip * bp[j * csb];
+                    }
+                }
+            }
+        }
+
+        // Pack an mc x kc block of A into MR-row slivers, each stored column by column, zero padded.
+        // Packing is where a transposed A is absorbed: each of its stored rows holds one column of
+        // every sliver, so it is read once, contiguously, instead of once per sliver.
+        template<typename T, int MR>
+        void gemm_pack_a(int mc, int kc, const T* a, std::ptrdiff_t rsa, std::ptrdiff_t csa, T* buffer) {
+            if (rsa == 1) {
+                for (int p = 0; p < kc; ++p) {
+                    const T* ap = a + p * csa;
+                    for (int ir = 0; ir < mc; ir += MR) {
+                        const int rows = std::min(MR, mc - ir);
+                        T* sliver = buffer + static_cast<std::size_t>(ir) * kc + static_cast<std::size_t>(p) * MR;
+                        for (int i = 0; i < rows; ++i) {
+                            sliver[i] = ap[ir + i];
+                        }
+                        for (int i = rows; i < MR; ++i) {
+                            sliver[i] = T();
+                        }
+                    }
+                }
+                return;
+            }
+            for (int ir = 0; ir < mc; ir += MR) {
+                const int rows = std::min(MR, mc - ir);
+                for (int p = 0; p < kc; ++p) {
+                    const T* ap = a + ir * rsa + p * csa;
+                    for (int i = 0; i < rows; ++i) {
+                        buffer[i] = ap[i * rsa];
+                    }
+                    for (int i = rows; i < MR; ++i) {
+                        buffer[i] = T();
+                    }
+                    buffer += MR;
+                }
+            }
+        }
+
+        // Pack a kc x nc block of B into NR-column slivers, each stored row by row, zero padded.
+        // A transposed B is gathered NR columns at a time, which touches the same NR cache lines
+        // for consecutive p.
+        template<typename T, int NR>
+        void gemm_pack_b(int kc, int nc, const T* b, std::ptrdiff_t rsb, std::ptrdiff_t csb, T* buffer) {
+            for (int jr = 0; jr < nc; jr += NR) {
+                const int cols = std::min(NR, nc - jr);
+                for (int p = 0; p < kc; ++p) {
+                    const T* bp = b + p * rsb + jr * csb;
+                    if (csb == 1) {
+                        for (int j = 0; j < cols; ++j) {
+                            buffer[j] = bp[j];
+                        }
+                    } else {
+                        for (int j = 0; j < cols; ++j) {
+                            buffer[j] = bp[j * csb];
+                        }
+                    }
+                    for (int j = cols; j < NR; ++j) {
+                        buffer[j] = T();
+                    }
+                    buffer += NR;
+                }
+            }
+        }
+
+        // Register-tiled micro-kernel: C[mr x nr] += packed A sliver * packed B sliver.
+        // The full MR x NR tile is accumulated locally so the inner loops have fixed trip counts.
+        template<typename T, int MR, int NR>
+        inline void gemm_micro_kernel(int kc, const T* __restrict a, const T* __restrict b, T* c, std::ptrdiff_t ldc, int mr, int nr) {
+            T acc[MR][NR] = {};
+            for (int p = 0; p < kc; ++p) {
+                for (int i = 0; i < MR; ++i) {
+                    const T ai = a[i];
+                    for (int j = 0; j < NR; ++j) {
+                        acc[i][j] += ai * b[j];
+                    }
+                }
+                a += MR;
+                b += NR;
+            }
+            for (int i = 0; i < mr; ++i) {
+                T* ci = c + i * ldc;
+                for (int j = 0; j < nr; ++j) {
+                    ci[j] += acc[i][j];
+                }
+            }
+        }
+
+        // Packing buffers are kept per thread and only grow. Each is reached through a function so the
+        // thread_local is constructed (and destroyed) on whichever thread asks for it, pool workers included
+        template<typename T>
+        std::vector<T>& gemm_a_storage() {
+            thread_local std::vector<T> storage;
+            return storage;
+        }
+
+        template<typename T>
+        std::vector<T>& gemm_b_storage() {
+            thread_local std::vector<T> storage;
+            return storage;
+        }
+
+        template<typename T>
+        T* gemm_buffer(std::vector<T>& buffer, std::size_t size) {
+            if (buffer.size() < size) {
+                buffer.resize(size);
+            }
+            return buffer.data();
+        }
+
+        // C += A B for strided A (m x k) and B (k x n), row-major C (m x n) with leading dimension ldc
+        template<typename T>
+        void gemm_strided(int m, int n, int k, const T* a, std::ptrdiff_t rsa, std::ptrdiff_t csa,
+                          const T* b, std::ptrdiff_t rsb, std::ptrdiff_t csb, T* c, std::ptrdiff_t ldc) {
+            if (m <= 0 || n <= 0 || k <= 0) {
+                return;
+            }
+            if (static_cast<long>(m) * n * k < gemm_small_threshold) {
+                gemm_simple(m, n, k, a, rsa, csa, b, rsb, csb, c, ldc);
+                return;
+            }
+
+            using blocking = gemm_blocking<T>;
+            constexpr int MR = blocking::MR;
+            constexpr int NR = blocking::NR;
+            constexpr int KC = blocking::KC;
+            constexpr int MC = blocking::MC;
+            constexpr int NC = blocking::NC;
+
+            // Every thread packs A into its own buffer, B is packed once by the calling thread
+            T* packed_b = gemm_buffer(gemm_b_storage<T>(), static_cast<std::size_t>(KC) * (std::min(NC, n) + NR));
+
+            // Each packed panel of B is shared by tasks covering one MC block of rows of C and a
+            // chunk of its columns, so every element of C is owned by exactly one task
+            constexpr int column_chunk = 8 * NR;
+
+            for (int jc = 0; jc < n; jc += NC) {
+                const int nc = std::min(NC, n - jc);
+                const int m_blocks = (m + MC - 1) / MC;
+                const int n_chunks = (nc + column_chunk - 1) / column_chunk;
+
+                for (int pc = 0; pc < k; pc += KC) {
+                    const int kc = std::min(KC, k - pc);
+                    gemm_pack_b<T, NR>(kc, nc, b + pc * rsb + jc * csb, rsb, csb, packed_b);
+
+                    parallel_for(0, static_cast<std::size_t>(m_blocks) * n_chunks, 1, 2.0 * m * nc * kc,
+                                 [&](std::size_t first, std::size_t last) {
+                        T* packed_a = gemm_buffer(gemm_a_storage<T>(), static_cast<std::size_t>(MC + MR) * KC);
+                        int packed_block = -1;
+                        for (std::size_t task = first; task < last; ++task) {
+                            const int block = static_cast<int>(task / n_chunks);
+                            const int chunk = static_cast<int>(task % n_chunks);
+                            const int ic = block * MC;
+                            const int mc = std::min(MC, m - ic);
+                            if (block != packed_block) {
+                                gemm_pack_a<T, MR>(mc, kc, a + ic * rsa + pc * csa, rsa, csa, packed_a);
+                                packed_block = block;
+                            }
+
+                            const int jr_end = std::min(nc, (chunk + 1) * column_chunk);
+                            for (int jr = chunk * column_chunk; jr < jr_end; jr += NR) {
+                                const int nr = std::min(NR, nc - jr);
+                                const T* b_sliver = packed_b + static_cast<std::size_t>(jr) * kc;
+                                for (int ir = 0; ir < mc; ir += MR) {
+                                    const int mr = std::min(MR, mc - ir);
+                                    const T* a_sliver = packed_a + static_cast<std::size_t>(ir) * kc;
+                                    gemm_micro_kernel<T, MR, NR>(kc, a_sliver, b_sliver, c + (ic + ir) * ldc + jc + jr, ldc, mr, nr);
+                                }
+                            }
+                        }
+                    });
+                }
+            }
+        }
+
+        // C += A B for row-major A (m x k), B (k x n) and C (m x n) with leading dimensions lda, ldb, ldc
+        template<typename T>
+        void gemm(int m, int n, int k, const T* a, std::ptrdiff_t lda, const T* b, std::ptrdiff_t ldb, T* c, std::ptrdiff_t ldc) {
+            gemm_strided(m, n, k, a, lda, 1, b, ldb, 1, c, ldc);
+        }
+
+        // C += op(A) op(B) with op(A) m x k and op(B) k x n. A transposed operand is stored row-major
+        // as k x m (n x k for B) with leading dimension lda (ldb) and is read in place, no copy of the
+        // transpose is made.
+        template<typename T>
+        void gemm(Transpose op_a, Transpose op_b, int m, int n, int k, const T* a, std::ptrdiff_t lda,
+                  const T* b, std::ptrdiff_t ldb, T* c, std::ptrdiff_t ldc) {
+            const bool ta = op_a == Transpose::Yes;
+            const bool tb = op_b == Transpose::Yes;
+            gemm_strided(m, n, k, a, ta ? 1 : lda, ta ? lda : 1, b, tb ? 1 : ldb, tb ? ldb : 1, c, ldc);
+        }
+
+        // Recursion of the transpose kernels stops at blocks this size, whose source and destination fit in L1 together
+        inline constexpr int transpose_leaf = 32;
+
+        // dst = src^T for a rows x cols block by halving the longer side until the blocks are leaves.
+        // Cache-oblivious: at some depth the source and destination blocks fit in each cache level,
+        // whatever its size, so no tile size has to be tuned per machine.
+        template<typename T>
+        void transpose_recursive(int rows, int cols, const T* src, std::ptrdiff_t lds, T* dst, std::ptrdiff_t ldd) {
+            if (rows <= transpose_leaf && cols <= transpose_leaf) {
+                for (int i = 0; i < rows; ++i) {
+                    for (int j = 0; j < cols; ++j) {
+                        dst[j * ldd + i] = src[i * lds + j];
+                    }
+                }
+                return;
+            }
+            if (rows >= cols) {
+                const int half = rows / 2;
+                transpose_recursive(half, cols, src, lds, dst, ldd);
+                transpose_recursive(rows - half, cols, src + half * lds, lds, dst + half, ldd);
+            } else {
+                const int half = cols / 2;
+                transpose_recursive(rows, half, src, lds, dst, ldd);
+                transpose_recursive(rows, cols - half, src + half, lds, dst + half * ldd, ldd);
+            }
+        }
+
+        // dst (cols x rows, leading dimension ldd) = src^T (src is rows x cols, leading dimension lds).
+        // Bands of rows are independent and are split across threads for large matrices, each band
+        // is transposed recursively.
+        template<typename T>
+        void transpose(int rows, int cols, const T* src, std::ptrdiff_t lds, T* dst, std::ptrdiff_t ldd) {
+            constexpr int band = 4 * transpose_leaf;
+            const int bands = (rows + band - 1) / band;
+            parallel_for(0, bands, 1, 4.0 * rows * cols, [&](std::size_t first, std::size_t last) {
+                const int i0 = static_cast<int>(first) * band;
+                const int i1 = std::min(rows, static_cast<int>(last) * band);
+                transpose_recursive(i1 - i0, cols, src + i0 * lds, lds, dst + i0, ldd);
+            });
+        }
+
+        // Swap the rows x cols block x with the transpose of the cols x rows block y, recursively
+        template<typename T>
+        void transpose_swap(int rows, int cols, T* x, T* y, std::ptrdiff_t ld) {
+            if (rows <= transpose_leaf && cols <= transpose_leaf) {
+                for (int i = 0; i < rows; ++i) {
+                    for (int j = 0; j < cols; ++j) {
+                        std::swap(x[i * ld + j], y[j * ld + i]);
+                    }
+                }
+                return;
+            }
+            if (rows >= cols) {
+                const int half = rows / 2;
+                transpose_swap(half, cols, x, y, ld);
+                transpose_swap(rows - half, cols, x + half * ld, y + half, ld);
+            } else {
+                const int half = cols / 2;
+                transpose_swap(rows, half, x, y, ld);
+                transpose_swap(rows, cols - half, x + half, y + half * ld, ld);
+            }
+        }
+
+        // In-place transpose of an n x n block: the two diagonal quarters are transposed recursively,
+        // the off-diagonal quarters trade places with each other's transpose
+        template<typename T>
+        void transpose_in_place(int n, T* a, std::ptrdiff_t lda) {
+            if (n <= transpose_leaf) {
+                for (int i = 0; i < n; ++i) {
+                    for (int j = i + 1; j < n; ++j) {
+                        std::swap(a[i * lda + j], a[j * lda + i]);
+                    }
+                }
+                return;
+            }
+            const int half = n / 2;
+            transpose_in_place(half, a, lda);
+            transpose_in_place(n - half, a + half * lda + half, lda);
+            transpose_swap(half, n - half, a + half, a + half * lda, lda);
+        }
+
+    }
+
+}
+
+#endif
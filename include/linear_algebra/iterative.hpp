@@ -0,0 +1,478 @@
+//Contains implementation for iterative Krylov solvers (CG, BiCGSTAB, GMRES) and their preconditioners
+
+#ifndef ITERATIVE_HPP
+#define ITERATIVE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "dynamic_matrix.hpp"
+#include "dynamic_vector.hpp"
+#include "matrix.hpp"
+#include "simd.hpp"
+#include "sparse.hpp"
+
+namespace linear_algebra {
+
+    // Stopping criteria shared by the solvers. Iteration stops once ||b - A x|| <= tolerance * ||b||.
+    template<typename T>
+    struct IterativeOptions {
+        T tolerance = T(1e-10);
+        std::size_t max_iterations = 1000;
+        // Krylov basis size before GMRES restarts
+        std::size_t restart = 30;
+        // Keep the relative residual of every iteration in the result
+        bool record_history = true;
+        // Starting point, zero if left empty
+        DynamicVector<T> initial_guess;
+    };
+
+    template<typename T>
+    struct IterativeResult {
+        DynamicVector<T> x;
+        bool converged = false;
+        std::size_t iterations = 0;
+        // Final relative residual ||b - A x|| / ||b||
+        T residual = T(0);
+        // Relative residual after each iteration, starting with the initial guess
+        std::vector<T> residual_history;
+    };
+
+    // Preconditioners apply z = M^-1 r for some M approximating A
+
+    template<typename T>
+    class IdentityPreconditioner {
+    public:
+        void apply(const DynamicVector<T>& r, DynamicVector<T>& z) const { z = r; }
+    };
+
+    // Diagonal scaling, M = diag(A)
+    template<typename T>
+    class JacobiPreconditioner {
+    public:
+        explicit JacobiPreconditioner(const DynamicMatrix<T>& a);
+        explicit JacobiPreconditioner(const CsrMatrix<T>& a);
+
+        template<int N>
+        explicit JacobiPreconditioner(const Matrix<T, N, N>& a) : JacobiPreconditioner(DynamicMatrix<T>(a)) {}
+
+        void apply(const DynamicVector<T>& r, DynamicVector<T>& z) const;
+
+    private:
+        void set_diagonal(std::size_t i, const T& d);
+
+        std::vector<T> inverse_diagonal;
+    };
+
+    // Incomplete LU without fill-in: L and U keep exactly the sparsity pattern of A,
+    // so the factors cost no more memory than A itself
+    template<typename T>
+    class ILU0Preconditioner {
+    public:
+        explicit ILU0Preconditioner(const CsrMatrix<T>& a);
+        explicit ILU0Preconditioner(const DynamicMatrix<T>& a) : ILU0Preconditioner(CsrMatrix<T>(a)) {}
+
+        void apply(const DynamicVector<T>& r, DynamicVector<T>& z) const;
+
+    private:
+        CsrMatrix<T> factors;
+        // Position of the diagonal entry within each row of factors
+        std::vector<std::size_t> diagonal;
+    };
+
+    namespace detail {
+
+        // y = A x for every kind of operator the solvers accept: anything with a raw
+        // multiply(const T*, T*) (the sparse formats), dense matrices, or a callable op(x, y).
+        // y is preallocated by the solvers and written in place where the operator allows it.
+        template<typename T, typename Op>
+        void apply_operator(const Op& a, const DynamicVector<T>& x, DynamicVector<T>& y) {
+            if constexpr (std::is_invocable_v<const Op&, const DynamicVector<T>&, DynamicVector<T>&>) {
+                a(x, y);
+            } else if constexpr (requires { a.multiply(x.data_ptr(), y.data_ptr()); }) {
+                a.multiply(x.data_ptr(), y.data_ptr());
+            } else if constexpr (requires { multiply_into(y, a, x); }) {
+                multiply_into(y, a, x);
+            } else {
+                y = a * x;
+            }
+        }
+
+        template<typename T, int Rows, int Cols>
+        void apply_operator(const Matrix<T, Rows, Cols>& a, const DynamicVector<T>& x, DynamicVector<T>& y) {
+            if (x.size() != static_cast<std::size_t>(Cols)) {
+                throw std::invalid_argument("Number of columns in the matrix must match the size of the vector");
+            }
+            if (y.size() != static_cast<std::size_t>(Rows)) {
+                throw std::invalid_argument("Number of rows in the matrix must match the size of the result");
+            }
+            for (int i = 0; i < Rows; ++i) {
+                y[i] = simd::dot(a.data_ptr() + static_cast<std::size_t>(i) * Cols, x.data_ptr(), Cols);
+            }
+        }
+
+        template<typename T>
+        T norm2(const DynamicVector<T>& v) {
+            return std::sqrt(simd::sum_squares(v.data_ptr(), v.size()));
+        }
+
+        template<typename T>
+        T dot(const DynamicVector<T>& a, const DynamicVector<T>& b) {
+            return simd::dot(a.data_ptr(), b.data_ptr(), a.size());
+        }
+
+        // y += alpha x
+        template<typename T>
+        void axpy(T alpha, const DynamicVector<T>& x, DynamicVector<T>& y) {
+            for (std::size_t i = 0; i < y.size(); ++i) {
+                y[i] += alpha * x[i];
+            }
+        }
+
+        // Common setup: initial guess, r = b - A x and the history entry for it
+        template<typename T, typename Op>
+        T start_iteration(const Op& a, const DynamicVector<T>& b, const IterativeOptions<T>& options,
+                          IterativeResult<T>& result, DynamicVector<T>& r) {
+            const std::size_t n = b.size();
+            if (options.initial_guess.size() == 0) {
+                result.x = DynamicVector<T>(n);
+                r = b;
+            } else {
+                if (options.initial_guess.size() != n) {
+                    throw std::invalid_argument("Initial guess must match the size of the right-hand side");
+                }
+                result.x = options.initial_guess;
+                DynamicVector<T> ax(n);
+                apply_operator(a, result.x, ax);
+                r = b - ax;
+            }
+            T b_norm = norm2(b);
+            if (b_norm == T(0)) {
+                b_norm = T(1);
+            }
+            result.residual = norm2(r) / b_norm;
+            if (options.record_history) {
+                result.residual_history.push_back(result.residual);
+            }
+            result.converged = result.residual <= options.tolerance;
+            return b_norm;
+        }
+
+        template<typename T>
+        bool record_residual(const IterativeOptions<T>& options, IterativeResult<T>& result, T residual) {
+            result.residual = residual;
+            if (options.record_history) {
+                result.residual_history.push_back(residual);
+            }
+            result.converged = residual <= options.tolerance;
+            return result.converged;
+        }
+
+    }
+
+    // Preconditioned conjugate gradient, for symmetric positive definite A (and M)
+    template<typename Op, typename T, typename Preconditioner = IdentityPreconditioner<T>>
+    IterativeResult<T> conjugate_gradient(const Op& a, const DynamicVector<T>& b, const Preconditioner& m = Preconditioner(),
+                                          const IterativeOptions<T>& options = IterativeOptions<T>()) {
+        IterativeResult<T> result;
+        DynamicVector<T> r;
+        const T b_norm = detail::start_iteration(a, b, options, result, r);
+        if (result.converged) {
+            return result;
+        }
+
+        const std::size_t n = b.size();
+        DynamicVector<T> z(n), p(n), ap(n);
+        m.apply(r, z);
+        p = z;
+        T rz = detail::dot(r, z);
+
+        while (result.iterations < options.max_iterations) {
+            ++result.iterations;
+            detail::apply_operator(a, p, ap);
+            const T pap = detail::dot(p, ap);
+            if (pap == T(0)) {
+                break;
+            }
+            const T alpha = rz / pap;
+            detail::axpy(alpha, p, result.x);
+            detail::axpy(-alpha, ap, r);
+            if (detail::record_residual(options, result, detail::norm2(r) / b_norm)) {
+                break;
+            }
+            m.apply(r, z);
+            const T rz_next = detail::dot(r, z);
+            const T beta = rz_next / rz;
+            rz = rz_next;
+            for (std::size_t i = 0; i < n; ++i) {
+                p[i] = z[i] + beta * p[i];
+            }
+        }
+        return result;
+    }
+
+    // Right-preconditioned BiCGSTAB, for general nonsymmetric A
+    template<typename Op, typename T, typename Preconditioner = IdentityPreconditioner<T>>
+    IterativeResult<T> bicgstab(const Op& a, const DynamicVector<T>& b, const Preconditioner& m = Preconditioner(),
+                                const IterativeOptions<T>& options = IterativeOptions<T>()) {
+        IterativeResult<T> result;
+        DynamicVector<T> r;
+        const T b_norm = detail::start_iteration(a, b, options, result, r);
+        if (result.converged) {
+            return result;
+        }
+
+        const std::size_t n = b.size();
+        const DynamicVector<T> r_hat = r;
+        DynamicVector<T> p(n), v(n), s(n), t(n), p_hat(n), s_hat(n);
+        T rho = T(1), alpha = T(1), omega = T(1);
+
+        while (result.iterations < options.max_iterations) {
+            ++result.iterations;
+            const T rho_next = detail::dot(r_hat, r);
+            if (rho_next == T(0)) {
+                // Breakdown: the shadow residual became orthogonal to r
+                break;
+            }
+            const T beta = (rho_next / rho) * (alpha / omega);
+            rho = rho_next;
+            for (std::size_t i = 0; i < n; ++i) {
+                p[i] = r[i] + beta * (p[i] - omega * v[i]);
+            }
+            m.apply(p, p_hat);
+            detail::apply_operator(a, p_hat, v);
+            const T r_hat_v = detail::dot(r_hat, v);
+            if (r_hat_v == T(0)) {
+                // Breakdown: A p is orthogonal to the shadow residual, no step length exists
+                break;
+            }
+            alpha = rho / r_hat_v;
+            for (std::size_t i = 0; i < n; ++i) {
+                s[i] = r[i] - alpha * v[i];
+            }
+            if (detail::norm2(s) / b_norm <= options.tolerance) {
+                detail::axpy(alpha, p_hat, result.x);
+                detail::record_residual(options, result, detail::norm2(s) / b_norm);
+                break;
+            }
+            m.apply(s, s_hat);
+            detail::apply_operator(a, s_hat, t);
+            const T tt = detail::dot(t, t);
+            omega = tt == T(0) ? T(0) : detail::dot(t, s) / tt;
+            for (std::size_t i = 0; i < n; ++i) {
+                result.x[i] += alpha * p_hat[i] + omega * s_hat[i];
+                r[i] = s[i] - omega * t[i];
+            }
+            if (detail::record_residual(options, result, detail::norm2(r) / b_norm) || omega == T(0)) {
+                break;
+            }
+        }
+        return result;
+    }
+
+    // Restarted, right-preconditioned GMRES(restart) for general A. The least-squares problem on the
+    // Hessenberg matrix is updated with Givens rotations, which gives the residual norm for free
+    // at every inner iteration.
+    template<typename Op, typename T, typename Preconditioner = IdentityPreconditioner<T>>
+    IterativeResult<T> gmres(const Op& a, const DynamicVector<T>& b, const Preconditioner& m = Preconditioner(),
+                             const IterativeOptions<T>& options = IterativeOptions<T>()) {
+        IterativeResult<T> result;
+        DynamicVector<T> r;
+        const T b_norm = detail::start_iteration(a, b, options, result, r);
+        if (result.converged) {
+            return result;
+        }
+
+        const std::size_t n = b.size();
+        const std::size_t restart = std::max<std::size_t>(1, std::min(options.restart, n));
+        std::vector<DynamicVector<T>> basis(restart + 1, DynamicVector<T>(n));
+        // Column-major (restart + 1) x restart Hessenberg matrix
+        std::vector<T> h((restart + 1) * restart);
+        std::vector<T> cs(restart), sn(restart), g(restart + 1), y(restart);
+        DynamicVector<T> w(n), z(n);
+
+        while (result.iterations < options.max_iterations) {
+            T beta = detail::norm2(r);
+            basis[0] = r * (T(1) / beta);
+            std::fill(g.begin(), g.end(), T(0));
+            g[0] = beta;
+
+            std::size_t j = 0;
+            for (; j < restart && result.iterations < options.max_iterations; ++j) {
+                ++result.iterations;
+                m.apply(basis[j], z);
+                detail::apply_operator(a, z, w);
+
+                // Modified Gram-Schmidt against the basis built so far
+                for (std::size_t i = 0; i <= j; ++i) {
+                    const T hij = detail::dot(w, basis[i]);
+                    h[j * (restart + 1) + i] = hij;
+                    detail::axpy(-hij, basis[i], w);
+                }
+                const T h_next = detail::norm2(w);
+                h[j * (restart + 1) + j + 1] = h_next;
+                if (h_next != T(0)) {
+                    basis[j + 1] = w * (T(1) / h_next);
+                }
+
+                // Apply the earlier rotations to the new column, then eliminate its subdiagonal
+                T* col = h.data() + j * (restart + 1);
+                for (std::size_t i = 0; i < j; ++i) {
+                    const T tmp = cs[i] * col[i] + sn[i] * col[i + 1];
+                    col[i + 1] = -sn[i] * col[i] + cs[i] * col[i + 1];
+                    col[i] = tmp;
+                }
+                const T denom = std::hypot(col[j], col[j + 1]);
+                cs[j] = denom == T(0) ? T(1) : col[j] / denom;
+                sn[j] = denom == T(0) ? T(0) : col[j + 1] / denom;
+                col[j] = denom;
+                col[j + 1] = T(0);
+                g[j + 1] = -sn[j] * g[j];
+                g[j] = cs[j] * g[j];
+
+                if (detail::record_residual(options, result, std::abs(g[j + 1]) / b_norm) || h_next == T(0)) {
+                    ++j;
+                    break;
+                }
+            }
+
+            // Solve the j x j triangular system and update x = x + M^-1 V y
+            for (std::size_t i = j; i-- > 0;) {
+                T sum = g[i];
+                for (std::size_t k = i + 1; k < j; ++k) {
+                    sum -= h[k * (restart + 1) + i] * y[k];
+                }
+                y[i] = sum / h[i * (restart + 1) + i];
+            }
+            DynamicVector<T> update(n);
+            for (std::size_t i = 0; i < j; ++i) {
+                detail::axpy(y[i], basis[i], update);
+            }
+            m.apply(update, z);
+            detail::axpy(T(1), z, result.x);
+
+            if (result.converged) {
+                break;
+            }
+            // Restart from the true residual
+            detail::apply_operator(a, result.x, w);
+            r = b - w;
+        }
+        return result;
+    }
+
+    // Jacobi
+    template<typename T>
+    void JacobiPreconditioner<T>::set_diagonal(std::size_t i, const T& d) {
+        if (d == T(0)) {
+            throw std::runtime_error("Jacobi preconditioner needs a nonzero diagonal");
+        }
+        inverse_diagonal[i] = T(1) / d;
+    }
+
+    template<typename T>
+    JacobiPreconditioner<T>::JacobiPreconditioner(const DynamicMatrix<T>& a) : inverse_diagonal(a.rows()) {
+        if (a.rows() != a.cols()) {
+            throw std::invalid_argument("Preconditioners are only defined for square matrices");
+        }
+        for (std::size_t i = 0; i < a.rows(); ++i) {
+            set_diagonal(i, a(i, i));
+        }
+    }
+
+    template<typename T>
+    JacobiPreconditioner<T>::JacobiPreconditioner(const CsrMatrix<T>& a) : inverse_diagonal(a.rows()) {
+        if (a.rows() != a.cols()) {
+            throw std::invalid_argument("Preconditioners are only defined for square matrices");
+        }
+        for (std::size_t i = 0; i < a.rows(); ++i) {
+            set_diagonal(i, a(i, i));
+        }
+    }
+
+    template<typename T>
+    void JacobiPreconditioner<T>::apply(const DynamicVector<T>& r, DynamicVector<T>& z) const {
+        detail::simd::multiply(z.data_ptr(), r.data_ptr(), inverse_diagonal.data(), r.size());
+    }
+
+    // ILU(0)
+    template<typename T>
+    ILU0Preconditioner<T>::ILU0Preconditioner(const CsrMatrix<T>& a) : factors(a), diagonal(a.rows()) {
+        if (a.rows() != a.cols()) {
+            throw std::invalid_argument("Preconditioners are only defined for square matrices");
+        }
+        const std::size_t n = a.rows();
+        const auto& ptr = factors.row_pointers();
+        const auto& idx = factors.col_indices();
+        std::vector<T> values = factors.entries();
+
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto first = idx.begin() + ptr[i];
+            const auto last = idx.begin() + ptr[i + 1];
+            const auto it = std::lower_bound(first, last, i);
+            if (it == last || *it != i) {
+                throw std::runtime_error("ILU(0) needs every diagonal entry to be stored");
+            }
+            diagonal[i] = static_cast<std::size_t>(it - idx.begin());
+        }
+
+        // IKJ elimination restricted to the stored pattern. position[j] maps column j to its slot
+        // in the current row i, or none when row i has no entry there.
+        constexpr std::size_t none = static_cast<std::size_t>(-1);
+        std::vector<std::size_t> position(n, none);
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t p = ptr[i]; p < ptr[i + 1]; ++p) {
+                position[idx[p]] = p;
+            }
+            for (std::size_t p = ptr[i]; p < diagonal[i]; ++p) {
+                const std::size_t k = idx[p];
+                const T pivot = values[diagonal[k]];
+                if (pivot == T(0)) {
+                    throw std::runtime_error("Zero pivot in ILU(0)");
+                }
+                const T l = values[p] / pivot;
+                values[p] = l;
+                for (std::size_t q = diagonal[k] + 1; q < ptr[k + 1]; ++q) {
+                    const std::size_t slot = position[idx[q]];
+                    if (slot != none) {
+                        values[slot] -= l * values[q];
+                    }
+                }
+            }
+            for (std::size_t p = ptr[i]; p < ptr[i + 1]; ++p) {
+                position[idx[p]] = none;
+            }
+        }
+        factors = CsrMatrix<T>(n, n, ptr, idx, std::move(values));
+    }
+
+    template<typename T>
+    void ILU0Preconditioner<T>::apply(const DynamicVector<T>& r, DynamicVector<T>& z) const {
+        const std::size_t n = r.size();
+        const auto& ptr = factors.row_pointers();
+        const auto& idx = factors.col_indices();
+        const auto& values = factors.entries();
+        // Forward substitution with the unit lower factor
+        for (std::size_t i = 0; i < n; ++i) {
+            T sum = r[i];
+            for (std::size_t p = ptr[i]; p < diagonal[i]; ++p) {
+                sum -= values[p] * z[idx[p]];
+            }
+            z[i] = sum;
+        }
+        // Back substitution with the upper factor
+        for (std::size_t i = n; i-- > 0;) {
+            T sum = z[i];
+            for (std::size_t p = diagonal[i] + 1; p < ptr[i + 1]; ++p) {
+                sum -= values[p] * z[idx[p]];
+            }
+            z[i] = sum / values[diagonal[i]];
+        }
+    }
+
+}
+
+#endif
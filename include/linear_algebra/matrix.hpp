@@ -4,11 +4,16 @@
 #define MATRIX_HPP
 
 #include <iostream>
+#include <algorithm>
 #include <array>
 #include <type_traits>
 #include <cmath>
 #include <stdexcept>
+#include "memory.hpp"
 #include "vector.hpp"
+#include "gemm.hpp"
+#include "small_matrix.hpp"
+#include "profile.hpp"
 
 namespace linear_algebra {
 
@@ -16,6 +21,21 @@ namespace linear_algebra {
     template<typename T, int Rows, int Cols>
     class Matrix;
 
+    template<typename T, int N>
+    class LU;
+
+    namespace detail {
+        // Defined in decomposition.hpp
+        template<typename T>
+        bool gauss_jordan_invert(T* a, int n, std::ptrdiff_t lda, int* piv);
+
+        template<typename T>
+        bool integer_determinant(const T* a, int n, std::ptrdiff_t lda, long long& det);
+
+        template<typename T>
+        bool integer_inverse(const T* a, int n, std::ptrdiff_t lda, T* out, std::ptrdiff_t ldo);
+    }
+
     // Traits to check if a matrix is square
     template<typename T, int Rows, int Cols>
     struct is_square_matrix : std::false_type {};
@@ -23,51 +43,77 @@ namespace linear_algebra {
     template<typename T, int N>
     struct is_square_matrix<Matrix<T, N, N>, N, N> : std::true_type {};
 
-    // Concept to check if T is a numeric type
+    // Concept to check if T is a numeric type: a built-in arithmetic type, or a type with the
+    // field operations and ordering the decompositions rely on (e.g. ADVariable)
+    template <typename T>
+    concept Numeric = std::is_arithmetic_v<T> || requires(T a, T b) {
+        a + b; a - b; a * b; a / b; -a; a < b; a == b; T(0);
+    };
+
+    // Determinants of arithmetic matrices are reported as double, other element types keep their type
     template <typename T>
-    concept Numeric = std::is_arithmetic_v<T>;
+    using determinant_t = std::conditional_t<std::is_arithmetic_v<T>, double, T>;
 
 
     // Matrix class definition
     template<typename T, int Rows, int Cols>
-    class Matrix {
+    class Matrix : public MatrixExpression<Matrix<T, Rows, Cols>, T, Rows, Cols> {
     public:
         // Constructors
-        Matrix();
-        Matrix(const std::array<std::array<T, Cols>, Rows>& data);
-        Matrix(const std::initializer_list<std::initializer_list<T>>& init_list);
+        constexpr Matrix();
+        constexpr Matrix(const std::array<std::array<T, Cols>, Rows>& data);
+        constexpr Matrix(const std::initializer_list<std::initializer_list<T>>& init_list);
 
-        // Accessor and mutator functions
-        T& operator()(int row, int col);
-        const T& operator()(int row, int col) const;
+        // Evaluate an element-wise expression (see expression.hpp) in a single pass
+        template<typename E>
+        constexpr Matrix(const MatrixExpression<E, T, Rows, Cols>& expr);
+
+        template<typename E>
+        constexpr Matrix<T, Rows, Cols>& operator=(const MatrixExpression<E, T, Rows, Cols>& expr);
+
+        // Compound assignment updates the storage in one pass, without a temporary Matrix
+        template<typename E>
+        constexpr Matrix<T, Rows, Cols>& operator+=(const MatrixExpression<E, T, Rows, Cols>& expr);
 
-        // Basic operations
-        template<typename U, int R, int C>
-        friend Matrix<U, R, C> operator+(const Matrix<U, R, C>& a, const Matrix<U, R, C>& b);
+        template<typename E>
+        constexpr Matrix<T, Rows, Cols>& operator-=(const MatrixExpression<E, T, Rows, Cols>& expr);
 
-        template<typename U, int R, int C>
-        friend Matrix<U, R, C> operator-(const Matrix<U, R, C>& a, const Matrix<U, R, C>& b);
+        constexpr Matrix<T, Rows, Cols>& operator*=(const T& scalar);
+        constexpr Matrix<T, Rows, Cols>& operator/=(const T& scalar);
 
+        // Right multiplication by a square matrix, A = A B
+        Matrix<T, Rows, Cols>& operator*=(const Matrix<T, Cols, Cols>& other);
+
+        // Accessor and mutator functions
+        constexpr T& operator()(int row, int col);
+        constexpr const T& operator()(int row, int col) const;
+
+        // Contiguous row-major storage, for kernels working on raw memory
+        constexpr T* data_ptr() { return data[0].data(); }
+        constexpr const T* data_ptr() const { return data[0].data(); }
+
+        // Basic operations (+, -, scalar * and /) are lazy expressions defined in expression.hpp
         template<typename U, int R, int C, int otherc>
-        friend Matrix<U, R, otherc> operator*(const Matrix<U, R, C>& a, const Matrix<U, C, otherc>& b);
+        friend constexpr Matrix<U, R, otherc> operator*(const Matrix<U, R, C>& a, const Matrix<U, C, otherc>& b);
 
         //Multiply vector and matrix
  
         template<typename U, int R,int C,size_t S>
-        friend Vector<U, R> operator*(const Matrix<U,R,C>& mat ,const Vector<U, S>& vec);
-
-        // Scalar operations
-        Matrix<T, Rows, Cols> operator*(T scalar) const requires Numeric<T>;
-        Matrix<T, Rows, Cols> operator/(T scalar) const requires Numeric<T>;
+        friend constexpr Vector<U, R> operator*(const Matrix<U,R,C>& mat ,const Vector<U, S>& vec);
 
         // Transpose
-        Matrix<T, Cols, Rows> transpose() const;
+        constexpr Matrix<T, Cols, Rows> transpose() const;
+
+        // Transpose a square matrix without a second buffer
+        Matrix<T, Rows, Cols>& transpose_in_place() requires (Rows == Cols);
 
-        // Inverse (if possible)
-        Matrix<T, Rows, Cols> inverse() const requires Numeric<T>;
+        // Replace a square matrix by its inverse. On a singular matrix this throws and leaves
+        // the contents unspecified.
+        Matrix<T, Rows, Cols>& invert_in_place() requires Numeric<T> && (Rows == Cols);
 
-        // Determinant (if possible)
-        double determinant() const requires Numeric<T>;
+        // Inverse and determinant (if possible); constant-evaluable for sizes up to 4x4
+        constexpr Matrix<T, Rows, Cols> inverse() const requires Numeric<T>;
+        constexpr determinant_t<T> determinant() const requires Numeric<T>;
 
         // Display matrix
         void display() const;
@@ -75,40 +121,41 @@ namespace linear_algebra {
         // Calculate the Frobenius norm of the matrix
         T norm() const requires Numeric<T>;
 
-        //solve linear equations
+        //solve linear equations through an LU factorization, without forming the inverse
         template<size_t N>
-        Vector<T, N> solve_linear_equations(Vector<T, N>& b) requires Numeric<T> && is_square_matrix<Matrix<T, Rows, Cols>, Rows, Cols>::value {
-
-            // Calculate the inverse of the coefficient matrix
-            Matrix<T, N, N> A_inv = this->inverse();
-
-            // Solve the system of linear equations
-            Vector<T, N> x = A_inv * b;
+        Vector<T, N> solve_linear_equations(const Vector<T, N>& b) const requires Numeric<T> && is_square_matrix<Matrix<T, Rows, Cols>, Rows, Cols>::value {
+            static_assert(Rows == N, "Size of the right-hand side must match the matrix");
+            LINEAR_ALGEBRA_PROFILE_OP("matrix_solve", Rows, Cols, 2.0 / 3.0 * Rows * Rows * Rows + 2.0 * Rows * Rows, (Rows * Cols + 2 * N) * sizeof(T));
+            return LU<T, Rows>(*this).solve(b);
+        }
 
-            return x;
+        // Same, overwriting b with the solution
+        template<size_t N>
+        void solve_in_place(Vector<T, N>& b) const requires Numeric<T> && is_square_matrix<Matrix<T, Rows, Cols>, Rows, Cols>::value {
+            static_assert(Rows == N, "Size of the right-hand side must match the matrix");
+            LINEAR_ALGEBRA_PROFILE_OP("matrix_solve", Rows, Cols, 2.0 / 3.0 * Rows * Rows * Rows + 2.0 * Rows * Rows, (Rows * Cols + N) * sizeof(T));
+            LU<T, Rows>(*this).solve_in_place(b);
         }
 
         private:
 
-            std::array<std::array<T, Cols>, Rows> data;
+            template<typename E>
+            constexpr void assign(const MatrixExpression<E, T, Rows, Cols>& expr);
+
+            alignas(storage_alignment<T, static_cast<std::size_t>(Rows) * Cols>) std::array<std::array<T, Cols>, Rows> data;
     };
 
     // Constructors
     template<typename T, int Rows, int Cols>
-    Matrix<T, Rows, Cols>::Matrix() {
-        // Initialize all elements to zero
-        for (int i = 0; i < Rows; ++i) {
-            for (int j = 0; j < Cols; ++j) {
-                data[i][j] = T();
-            }
-        }
+    constexpr Matrix<T, Rows, Cols>::Matrix() : data{} {
+        // Value-initialized: every element is T(), zero for arithmetic types
     }
 
     template<typename T, int Rows, int Cols>
-    Matrix<T, Rows, Cols>::Matrix(const std::array<std::array<T, Cols>, Rows>& data) : data(data) {}
+    constexpr Matrix<T, Rows, Cols>::Matrix(const std::array<std::array<T, Cols>, Rows>& data) : data(data) {}
 
     template<typename T, int Rows, int Cols>
-    Matrix<T, Rows, Cols>::Matrix(const std::initializer_list<std::initializer_list<T>>& init_list) {
+    constexpr Matrix<T, Rows, Cols>::Matrix(const std::initializer_list<std::initializer_list<T>>& init_list) : data{} {
         if (init_list.size() != Rows) {
             throw std::invalid_argument("Invalid number of rows in initializer list");
         }
@@ -127,123 +174,194 @@ namespace linear_algebra {
 
     // Accessor and mutator functions
     template<typename T, int Rows, int Cols>
-    T& Matrix<T, Rows, Cols>::operator()(int row, int col) {
+    constexpr T& Matrix<T, Rows, Cols>::operator()(int row, int col) {
         return data[row][col];
     }
 
     template<typename T, int Rows, int Cols>
-    const T& Matrix<T, Rows, Cols>::operator()(int row, int col) const {
+    constexpr const T& Matrix<T, Rows, Cols>::operator()(int row, int col) const {
         return data[row][col];
     }
 
-    // Scalar operations
     template<typename T, int Rows, int Cols>
-    Matrix<T, Rows, Cols> Matrix<T, Rows, Cols>::operator*(T scalar) const requires Numeric<T> {
-        Matrix<T, Rows, Cols> result;
-        for (int i = 0; i < Rows; ++i) {
-            for (int j = 0; j < Cols; ++j) {
-                result.data[i][j] = data[i][j] * scalar;
+    template<typename E>
+    constexpr Matrix<T, Rows, Cols>::Matrix(const MatrixExpression<E, T, Rows, Cols>& expr) {
+        assign(expr);
+    }
+
+    template<typename T, int Rows, int Cols>
+    template<typename E>
+    constexpr Matrix<T, Rows, Cols>& Matrix<T, Rows, Cols>::operator=(const MatrixExpression<E, T, Rows, Cols>& expr) {
+        // Element-wise expressions only read (i, j) to produce element (i, j), so aliasing is safe
+        assign(expr);
+        return *this;
+    }
+
+    template<typename T, int Rows, int Cols>
+    template<typename E>
+    constexpr void Matrix<T, Rows, Cols>::assign(const MatrixExpression<E, T, Rows, Cols>& expr) {
+        LINEAR_ALGEBRA_PROFILE_OP("matrix_assign", Rows, Cols, 0, Rows * Cols * sizeof(T));
+        if (std::is_constant_evaluated()) {
+            // Flat pointer walks across the row arrays are not allowed in constant evaluation
+            for (int i = 0; i < Rows; ++i) {
+                for (int j = 0; j < Cols; ++j) {
+                    data[i][j] = expr.self()(i, j);
+                }
             }
+        } else {
+            detail::assign_expression(data_ptr(), expr);
         }
-        return result;
     }
 
     template<typename T, int Rows, int Cols>
-    Matrix<T, Rows, Cols> Matrix<T, Rows, Cols>::operator/(T scalar) const requires Numeric<T> {
-        if (scalar == 0) {
-            throw std::runtime_error("Division by zero");
-        }
-        Matrix<T, Rows, Cols> result;
-        for (int i = 0; i < Rows; ++i) {
-            for (int j = 0; j < Cols; ++j) {
-                result.data[i][j] = data[i][j] / scalar;
-            }
+    template<typename E>
+    constexpr Matrix<T, Rows, Cols>& Matrix<T, Rows, Cols>::operator+=(const MatrixExpression<E, T, Rows, Cols>& expr) {
+        // A + B over concrete operands is a single SIMD pass with the destination as first source
+        assign(*this + expr.self());
+        return *this;
+    }
+
+    template<typename T, int Rows, int Cols>
+    template<typename E>
+    constexpr Matrix<T, Rows, Cols>& Matrix<T, Rows, Cols>::operator-=(const MatrixExpression<E, T, Rows, Cols>& expr) {
+        assign(*this - expr.self());
+        return *this;
+    }
+
+    template<typename T, int Rows, int Cols>
+    constexpr Matrix<T, Rows, Cols>& Matrix<T, Rows, Cols>::operator*=(const T& scalar) {
+        assign(*this * scalar);
+        return *this;
+    }
+
+    template<typename T, int Rows, int Cols>
+    constexpr Matrix<T, Rows, Cols>& Matrix<T, Rows, Cols>::operator/=(const T& scalar) {
+        assign(*this / scalar);
+        return *this;
+    }
+
+    template<typename T, int Rows, int Cols>
+    Matrix<T, Rows, Cols>& Matrix<T, Rows, Cols>::operator*=(const Matrix<T, Cols, Cols>& other) {
+        LINEAR_ALGEBRA_PROFILE_OP("matrix_multiply", Rows, Cols, 2.0 * Rows * Cols * Cols, (2 * Rows * Cols + Cols * Cols) * sizeof(T));
+        // Every output row needs the whole input row, so the left operand is read from a copy.
+        // For A *= A the copy serves as both operands.
+        const Matrix<T, Rows, Cols> lhs = *this;
+        const T* rhs = static_cast<const void*>(&other) == static_cast<const void*>(this) ? lhs.data_ptr() : other.data_ptr();
+        data = {};
+        detail::gemm(Rows, Cols, Cols, lhs.data_ptr(), Cols, rhs, Cols, data_ptr(), Cols);
+        return *this;
+    }
+
+    namespace detail {
+
+        // y = A x for a row-major rows x cols block. Each row is an independent dot product,
+        // so large products are split by rows as for DynamicMatrix
+        template<typename T>
+        void matrix_vector(const T* a, int rows, int cols, const T* x, T* y) {
+            parallel_for(0, rows, 256, 2.0 * rows * cols, [&](std::size_t first, std::size_t last) {
+                for (std::size_t i = first; i < last; ++i) {
+                    y[i] = simd::dot(a + i * cols, x, static_cast<size_t>(cols));
+                }
+            });
         }
-        return result;
+
     }
 
      template<typename T, int Rows, int Cols, size_t N>
-     Vector<T, Rows> operator*(const Matrix<T,Rows,Cols>& mat ,const Vector<T, N>& vec)
+     constexpr Vector<T, Rows> operator*(const Matrix<T,Rows,Cols>& mat ,const Vector<T, N>& vec)
      {
         static_assert(Cols == N, "Number of columns in the matrix must match the size of the vector.");
+        LINEAR_ALGEBRA_PROFILE_OP("matrix_vector", Rows, Cols, 2 * Rows * Cols, (Rows * Cols + Rows + Cols) * sizeof(T));
         Vector<T, Rows> result;
-        for (size_t i = 0; i < Rows; ++i) {
-            T sum = 0;
-            for (size_t j = 0; j < Cols; ++j) {
-                sum += mat.data[i][j] * vec[j];
+        if (std::is_constant_evaluated()) {
+            for (size_t i = 0; i < Rows; ++i) {
+                T sum = 0;
+                for (size_t j = 0; j < Cols; ++j) {
+                    sum += mat.data[i][j] * vec[j];
+                }
+                result[i] = sum;
             }
-            result[i] = sum;
+        } else {
+            detail::matrix_vector(mat.data_ptr(), Rows, Cols, vec.data_ptr(), result.data_ptr());
         }
         return result;
      }
 
     // Transpose
     template<typename T, int Rows, int Cols>
-    Matrix<T, Cols, Rows> Matrix<T, Rows, Cols>::transpose() const {
+    constexpr Matrix<T, Cols, Rows> Matrix<T, Rows, Cols>::transpose() const {
+        LINEAR_ALGEBRA_PROFILE_OP("matrix_transpose", Rows, Cols, 0, 2 * Rows * Cols * sizeof(T));
         Matrix<T, Cols, Rows> result;
-        for (int i = 0; i < Rows; ++i) {
-            for (int j = 0; j < Cols; ++j) {
-                result.data[j][i] = data[i][j];
+        if (std::is_constant_evaluated()) {
+            // The tiled kernel may hand bands to the thread pool, which constant evaluation cannot use
+            for (int i = 0; i < Rows; ++i) {
+                for (int j = 0; j < Cols; ++j) {
+                    result(j, i) = data[i][j];
+                }
             }
+        } else {
+            detail::transpose(Rows, Cols, data_ptr(), Cols, result.data_ptr(), Rows);
         }
         return result;
     }
 
-    // Inverse (if possible)
     template<typename T, int Rows, int Cols>
-    Matrix<T, Rows, Cols> Matrix<T, Rows, Cols>::inverse() const requires Numeric<T> {
-        static_assert(is_square_matrix<Matrix<T, Rows, Cols>, Rows, Cols>::value, "Inverse is only defined for square matrices");
-
-
-        T det = determinant();
-        if (det == T(0)) {
-
-            throw std::runtime_error("Matrix is singular, inverse doesn't exist");
-        }
-
-
-        Matrix<T, Rows, Cols> adjugate;
-        for (int i = 0; i < Rows; ++i) {
-            for (int j = 0; j < Cols; ++j) {
-
-                Matrix<T, Rows - 1, Cols - 1> minor;
-                for (int m = 0, p = 0; m < Rows; ++m) {
-                    if (m == i) continue;
-                    for (int n = 0, q = 0; n < Cols; ++n) {
-                        if (n == j) continue;
-                        minor(p, q++) = data[m][n];
-                    }
-                    ++p;
-                }
-
-                T sign = ((i + j) % 2 == 0) ? T(1) : T(-1);
-
-                T minor_det = minor.determinant();
+    Matrix<T, Rows, Cols>& Matrix<T, Rows, Cols>::transpose_in_place() requires (Rows == Cols) {
+        LINEAR_ALGEBRA_PROFILE_OP("matrix_transpose", Rows, Cols, 0, 2 * Rows * Cols * sizeof(T));
+        detail::transpose_in_place(Rows, data_ptr(), Cols);
+        return *this;
+    }
 
-                adjugate(j, i) = sign * minor_det;
+    template<typename T, int Rows, int Cols>
+    Matrix<T, Rows, Cols>& Matrix<T, Rows, Cols>::invert_in_place() requires Numeric<T> && (Rows == Cols) {
+        if constexpr (Rows > detail::small_matrix_limit && std::is_floating_point_v<T>) {
+            LINEAR_ALGEBRA_PROFILE_OP("matrix_inverse", Rows, Cols, 2.0 * Rows * Rows * Rows, 2 * Rows * Cols * sizeof(T));
+            std::array<int, Rows> piv;
+            if (!detail::gauss_jordan_invert(data_ptr(), Rows, Cols, piv.data())) {
+                throw std::runtime_error("Matrix is singular, inverse doesn't exist");
             }
+        } else {
+            // The cofactor kernels read every entry after writing the first, integers are inverted
+            // exactly and other element types (such as ADVariable) have their own LU, so these all
+            // go through inverse()
+            *this = inverse();
         }
+        return *this;
+    }
 
-        Matrix<T, Rows, Cols> inversed;
-        for (int i = 0; i < Rows; ++i) {
-            for (int j = 0; j < Cols; ++j) {
-                inversed(i, j) = adjugate(i, j) / det;
+    // Inverse (if possible). Floating-point matrices up to 4x4 use the closed-form cofactor
+    // kernels, larger ones (and other non-integer element types) go through an LU factorization.
+    // Integer matrices are inverted exactly and each entry rounded to the nearest integer, as the
+    // integer LU solves are; if the exact values overflow, the LU path computes them in double.
+    template<typename T, int Rows, int Cols>
+    constexpr Matrix<T, Rows, Cols> Matrix<T, Rows, Cols>::inverse() const requires Numeric<T> {
+        static_assert(is_square_matrix<Matrix<T, Rows, Cols>, Rows, Cols>::value, "Inverse is only defined for square matrices");
+        LINEAR_ALGEBRA_PROFILE_OP("matrix_inverse", Rows, Cols, 2.0 * Rows * Rows * Rows, 2 * Rows * Cols * sizeof(T));
+        if constexpr (Rows <= detail::small_matrix_limit && std::is_floating_point_v<T>) {
+            Matrix<T, Rows, Cols> result;
+            const T det = detail::small_inverse<T, Rows>([&](int i, int j) { return data[i][j]; },
+                                                         [&](int i, int j, const T& value) { result.data[i][j] = value; });
+            if (det == T(0)) {
+                throw std::runtime_error("Matrix is singular, inverse doesn't exist");
+            }
+            return result;
+        } else if constexpr (std::is_integral_v<T>) {
+            Matrix<T, Rows, Cols> result;
+            if (!detail::integer_inverse(data_ptr(), Rows, Cols, result.data_ptr(), Cols)) {
+                return LU<T, Rows>(*this).inverse();
             }
+            return result;
+        } else {
+            return LU<T, Rows>(*this).inverse();
         }
-
-        return inversed;
     }
 
     // Calculate the Frobenius norm of the matrix
     template<typename T, int Rows, int Cols>
     T Matrix<T, Rows, Cols>::norm() const requires Numeric<T> {
-        T sum = T();
-        for (int i = 0; i < Rows; ++i) {
-            for (int j = 0; j < Cols; ++j) {
-                sum += data[i][j] * data[i][j];
-            }
-        }
-        return std::sqrt(sum);
+        LINEAR_ALGEBRA_PROFILE_OP("matrix_norm", Rows, Cols, 2 * Rows * Cols, Rows * Cols * sizeof(T));
+        using std::sqrt;
+        return sqrt(detail::simd::sum_squares(data_ptr(), static_cast<size_t>(Rows) * Cols));
     }
 
     // Display matrix
@@ -257,81 +375,121 @@ namespace linear_algebra {
         }
     }
 
+    // Determinant (if possible). Arithmetic matrices up to 4x4 use the closed-form expansion,
+    // evaluated in determinant_t<T>; larger ones are computed from an LU factorization in O(n^3),
+    // or by exact fraction-free elimination for integer matrices.
     template<typename T, int Rows, int Cols>
-    double determinant_helper(const Matrix<T, Rows, Cols>& mat, const int n) requires Numeric<T> {
-        double det = 0;
-        if (n == 1) {
-            return mat(0, 0); // For a 1x1 matrix, determinant is the single element
-        } else if (n == 2) {
-            return mat(0, 0) * mat(1, 1) - mat(0, 1) * mat(1, 0); // For a 2x2 matrix, use the standard formula
+    constexpr determinant_t<T> Matrix<T, Rows, Cols>::determinant() const requires Numeric<T> {
+        static_assert(is_square_matrix<Matrix<T, Rows, Cols>, Rows, Cols>::value, "Determinant is only defined for square matrices");
+        LINEAR_ALGEBRA_PROFILE_OP("matrix_determinant", Rows, Cols, 2.0 / 3.0 * Rows * Rows * Rows, Rows * Cols * sizeof(T));
+        if constexpr (Rows <= detail::small_matrix_limit && std::is_arithmetic_v<T>) {
+            using D = determinant_t<T>;
+            return detail::small_determinant<D, Rows>([&](int i, int j) { return static_cast<D>(data[i][j]); });
+        } else if constexpr (std::is_integral_v<T>) {
+            long long det;
+            if (!detail::integer_determinant(data_ptr(), Rows, Cols, det)) {
+                return LU<T, Rows>(*this).determinant();
+            }
+            return static_cast<determinant_t<T>>(det);
         } else {
-            Matrix<T, Rows, Cols> submat;
-            for (int x = 0; x < n; x++) {
-                int subi = 0;
-                for (int i = 1; i < n; i++) {
-                    int subj = 0;
-                    for (int j = 0; j < n; j++) {
-                        if (j == x)
-                            continue;
-                        submat(subi, subj) = mat(i, j);
-                        subj++;
+            return LU<T, Rows>(*this).determinant();
+        }
+    }
+
+    template<typename T, int Rows, int Cols, int OtherCols>
+    constexpr Matrix<T, Rows, OtherCols> operator*(const Matrix<T, Rows, Cols>& a, const Matrix<T, Cols, OtherCols>& b) {
+        // Compatibility of the inner dimensions is enforced by the signature
+        LINEAR_ALGEBRA_PROFILE_OP("matrix_multiply", Rows, OtherCols, 2.0 * Rows * Cols * OtherCols,
+                                  (Rows * Cols + Cols * OtherCols + Rows * OtherCols) * sizeof(T));
+        Matrix<T, Rows, OtherCols> result;
+        if (std::is_constant_evaluated()) {
+            // Constant evaluation cannot run the packed kernel (thread_local buffers, flat row-major
+            // pointer walks across the nested arrays), so it takes a plain element loop
+            for (int i = 0; i < Rows; ++i) {
+                for (int p = 0; p < Cols; ++p) {
+                    for (int j = 0; j < OtherCols; ++j) {
+                        result(i, j) += a(i, p) * b(p, j);
                     }
-                    subi++;
                 }
-                det += (pow(-1, x) * mat(0, x) * determinant_helper(submat, n - 1));
             }
+            return result;
         }
-        return det;
-    }
-
-    // Determinant (if possible)
-    template<typename T, int Rows, int Cols>
-    double Matrix<T, Rows, Cols>::determinant() const requires Numeric<T> {
-        static_assert(is_square_matrix<Matrix<T, Rows, Cols>, Rows, Cols>::value, "Determinant is only defined for square matrices");
-        return determinant_helper(*this, Rows);
+        detail::gemm(Rows, OtherCols, Cols, a.data_ptr(), Cols, b.data_ptr(), OtherCols, result.data_ptr(), OtherCols);
+        return result;
     }
 
-    template<typename T, int Rows, int Cols>
-     Matrix<T, Rows, Cols> operator+(const Matrix<T, Rows, Cols>& a, const Matrix<T, Rows, Cols>& b){
-            Matrix<T, Rows, Cols> result;
-            for (int i = 0; i < Rows; ++i) {
-                for (int j = 0; j < Cols; ++j) {
-                    result.data[i][j] = a.data[i][j] + b.data[i][j];
+    // A^T B without forming A^T: A is read through its strides while the kernel packs it
+    template<typename T, int Inner, int Rows, int Cols>
+    constexpr Matrix<T, Rows, Cols> transpose_multiply(const Matrix<T, Inner, Rows>& a, const Matrix<T, Inner, Cols>& b) {
+        LINEAR_ALGEBRA_PROFILE_OP("matrix_transpose_multiply", Rows, Cols, 2.0 * Rows * Inner * Cols,
+                                  (Inner * Rows + Inner * Cols + Rows * Cols) * sizeof(T));
+        Matrix<T, Rows, Cols> result;
+        if (std::is_constant_evaluated()) {
+            for (int p = 0; p < Inner; ++p) {
+                for (int i = 0; i < Rows; ++i) {
+                    for (int j = 0; j < Cols; ++j) {
+                        result(i, j) += a(p, i) * b(p, j);
+                    }
                 }
             }
             return result;
         }
+        detail::gemm(Transpose::Yes, Transpose::No, Rows, Cols, Inner, a.data_ptr(), Rows, b.data_ptr(), Cols, result.data_ptr(), Cols);
+        return result;
+    }
 
-
-    template<typename T, int Rows, int Cols>
-    Matrix<T, Rows, Cols> operator-(const Matrix<T, Rows, Cols>& a, const Matrix<T, Rows, Cols>& b)
-     {
-            Matrix<T, Rows, Cols> result;
+    // A B^T without forming B^T
+    template<typename T, int Rows, int Inner, int Cols>
+    constexpr Matrix<T, Rows, Cols> multiply_transpose(const Matrix<T, Rows, Inner>& a, const Matrix<T, Cols, Inner>& b) {
+        LINEAR_ALGEBRA_PROFILE_OP("matrix_multiply_transpose", Rows, Cols, 2.0 * Rows * Inner * Cols,
+                                  (Rows * Inner + Cols * Inner + Rows * Cols) * sizeof(T));
+        Matrix<T, Rows, Cols> result;
+        if (std::is_constant_evaluated()) {
             for (int i = 0; i < Rows; ++i) {
                 for (int j = 0; j < Cols; ++j) {
-                    result.data[i][j] = a.data[i][j] - b.data[i][j];
+                    for (int p = 0; p < Inner; ++p) {
+                        result(i, j) += a(i, p) * b(j, p);
+                    }
                 }
             }
             return result;
         }
+        detail::gemm(Transpose::No, Transpose::Yes, Rows, Cols, Inner, a.data_ptr(), Inner, b.data_ptr(), Inner, result.data_ptr(), Cols);
+        return result;
+    }
 
-    template<typename T, int Rows, int Cols,int OtherCols>
-    Matrix<T, Rows, OtherCols> operator*(const Matrix<T, Rows, Cols>& a, const Matrix<T, Cols, OtherCols>& b) {
-    // Check if the matrices are compatible for multiplication
-    static_assert(Cols == OtherCols, "Number of columns in the first matrix must match the number of rows in the second matrix");
-
+    // dst = A B written straight into dst's storage. dst must not be one of the operands.
+    template<typename T, int Rows, int Cols, int OtherCols>
+    void multiply_into(Matrix<T, Rows, OtherCols>& dst, const Matrix<T, Rows, Cols>& a, const Matrix<T, Cols, OtherCols>& b) {
+        if (static_cast<const void*>(&dst) == static_cast<const void*>(&a) || static_cast<const void*>(&dst) == static_cast<const void*>(&b)) {
+            throw std::invalid_argument("Output of multiply_into must not alias an operand");
+        }
+        LINEAR_ALGEBRA_PROFILE_OP("matrix_multiply", Rows, OtherCols, 2.0 * Rows * Cols * OtherCols,
+                                  (Rows * Cols + Cols * OtherCols + Rows * OtherCols) * sizeof(T));
+        std::fill_n(dst.data_ptr(), static_cast<size_t>(Rows) * OtherCols, T());
+        detail::gemm(Rows, OtherCols, Cols, a.data_ptr(), Cols, b.data_ptr(), OtherCols, dst.data_ptr(), OtherCols);
+    }
 
-    Matrix<T, Rows, OtherCols> result;
-    for (int i = 0; i < Rows; ++i) {
-        for (int j = 0; j < OtherCols; ++j) {
-            for (int k = 0; k < Cols; ++k) {
-                result.data[i][j] += a.data[i][k] * b.data[k][j];
-            }
+    // dst = A x, one dot product per row, split by rows across the pool for large matrices
+    template<typename T, int Rows, int Cols, size_t N, size_t M>
+    void multiply_into(Vector<T, M>& dst, const Matrix<T, Rows, Cols>& a, const Vector<T, N>& x) {
+        static_assert(Cols == N, "Number of columns in the matrix must match the size of the vector.");
+        static_assert(Rows == M, "Size of the output vector must match the number of rows in the matrix.");
+        if (static_cast<const void*>(&dst) == static_cast<const void*>(&x)) {
+            throw std::invalid_argument("Output of multiply_into must not alias an operand");
         }
+        LINEAR_ALGEBRA_PROFILE_OP("matrix_vector", Rows, Cols, 2 * Rows * Cols, (Rows * Cols + Rows + Cols) * sizeof(T));
+        detail::matrix_vector(a.data_ptr(), Rows, Cols, x.data_ptr(), dst.data_ptr());
+    }
+
+    // Products involving unevaluated expressions materialize the operands first
+    template<typename L, typename R, typename T, int Rows, int Cols, int OtherCols>
+    Matrix<T, Rows, OtherCols> operator*(const MatrixExpression<L, T, Rows, Cols>& a, const MatrixExpression<R, T, Cols, OtherCols>& b) {
+        return a.eval() * b.eval();
     }
-    return result;
-}
 
 }
 
+#include "decomposition.hpp"
+
 #endif 
\ No newline at end of file
@@ -0,0 +1,425 @@
+//Contains implementation for the binary matrix file format, its streaming writer and memory-mapped reader
+
+#ifndef MATRIX_FILE_HPP
+#define MATRIX_FILE_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "view.hpp"
+
+namespace linear_algebra {
+
+    // File layout: a 64-byte header followed by rows * cols elements in native byte order, so the
+    // payload starts on a cache-line boundary of the (page-aligned) mapping and is used in place.
+    enum class DType : std::uint32_t { Float32 = 1, Float64 = 2, Int32 = 3, Int64 = 4 };
+
+    enum class Layout : std::uint32_t { RowMajor = 0, ColumnMajor = 1 };
+
+    struct MatrixFileHeader {
+        char magic[8];              // "LAMATRX" followed by a zero byte
+        std::uint32_t version;
+        DType dtype;
+        Layout layout;
+        std::uint32_t header_size;  // offset of the payload
+        std::uint64_t rows;
+        std::uint64_t cols;
+        std::uint64_t checksum;     // 64-bit FNV-1a of the payload bytes
+        std::uint8_t reserved[16];
+    };
+
+    static_assert(sizeof(MatrixFileHeader) == 64, "Matrix file header must stay 64 bytes");
+
+    inline constexpr std::uint32_t matrix_file_version = 1;
+
+    template<typename T>
+    struct dtype_of;
+
+    template<> struct dtype_of<float> { static constexpr DType value = DType::Float32; };
+    template<> struct dtype_of<double> { static constexpr DType value = DType::Float64; };
+    template<> struct dtype_of<std::int32_t> { static constexpr DType value = DType::Int32; };
+    template<> struct dtype_of<std::int64_t> { static constexpr DType value = DType::Int64; };
+
+    namespace detail {
+
+        inline constexpr char matrix_file_magic[8] = {'L', 'A', 'M', 'A', 'T', 'R', 'X', '\0'};
+
+        // Incremental 64-bit FNV-1a, so the streaming writer hashes each chunk as it goes
+        class Fnv1a {
+        public:
+            void update(const void* data, std::size_t bytes) {
+                const auto* p = static_cast<const unsigned char*>(data);
+                for (std::size_t i = 0; i < bytes; ++i) {
+                    hash = (hash ^ p[i]) * 0x100000001b3ULL;
+                }
+            }
+
+            std::uint64_t value() const { return hash; }
+
+            // Hash of bytes zero bytes: each one only multiplies by the prime, so this is
+            // offset * prime^bytes, evaluated by squaring instead of touching the data
+            static std::uint64_t zeros(std::uint64_t bytes) {
+                std::uint64_t result = 0xcbf29ce484222325ULL;
+                std::uint64_t factor = 0x100000001b3ULL;
+                for (; bytes != 0; bytes >>= 1) {
+                    if (bytes & 1) {
+                        result *= factor;
+                    }
+                    factor *= factor;
+                }
+                return result;
+            }
+
+        private:
+            std::uint64_t hash = 0xcbf29ce484222325ULL;
+        };
+
+        inline std::runtime_error file_error(const std::string& what, const std::string& path) {
+            return std::runtime_error(what + " '" + path + "': " + std::strerror(errno));
+        }
+
+        template<typename T>
+        MatrixFileHeader make_header(std::size_t rows, std::size_t cols, Layout layout) {
+            MatrixFileHeader header{};
+            std::memcpy(header.magic, matrix_file_magic, sizeof(header.magic));
+            header.version = matrix_file_version;
+            header.dtype = dtype_of<T>::value;
+            header.layout = layout;
+            header.header_size = sizeof(MatrixFileHeader);
+            header.rows = rows;
+            header.cols = cols;
+            return header;
+        }
+
+    }
+
+    // Writes a matrix file element by element in storage order (rows for RowMajor, columns for
+    // ColumnMajor) without holding the matrix in memory. close() fills in the header.
+    template<typename T>
+    class MatrixFileWriter {
+    public:
+        MatrixFileWriter(const std::string& path, std::size_t rows, std::size_t cols, Layout layout = Layout::RowMajor);
+        ~MatrixFileWriter();
+
+        MatrixFileWriter(const MatrixFileWriter&) = delete;
+        MatrixFileWriter& operator=(const MatrixFileWriter&) = delete;
+
+        // Append count elements
+        void write(const T* values, std::size_t count);
+
+        // Append one row (RowMajor) or column (ColumnMajor), possibly strided
+        template<typename V>
+        void write(const VectorView<V>& values);
+
+        // Number of elements written so far
+        std::size_t written() const { return count; }
+
+        // Finish the file; throws if fewer or more than rows * cols elements were written
+        void close();
+
+    private:
+        std::string path;
+        std::ofstream out;
+        MatrixFileHeader header;
+        detail::Fnv1a hash;
+        std::size_t count = 0;
+    };
+
+    // Read-only or read-write memory mapping of a matrix file. Opening only validates the header,
+    // the payload is paged in on first touch, so the cost does not grow with the file size.
+    template<typename T>
+    class MappedMatrix {
+    public:
+        explicit MappedMatrix(const std::string& path, bool writable = false);
+        ~MappedMatrix();
+
+        MappedMatrix(const MappedMatrix&) = delete;
+        MappedMatrix& operator=(const MappedMatrix&) = delete;
+        MappedMatrix(MappedMatrix&& other) noexcept;
+        MappedMatrix& operator=(MappedMatrix&& other) noexcept;
+
+        // New zero-filled file of the given shape, mapped read-write
+        static MappedMatrix create(const std::string& path, std::size_t rows, std::size_t cols, Layout layout = Layout::RowMajor);
+
+        std::size_t rows() const { return static_cast<std::size_t>(header().rows); }
+        std::size_t cols() const { return static_cast<std::size_t>(header().cols); }
+        Layout layout() const { return header().layout; }
+
+        // The mapped payload as a matrix, column-major files come out as a transposed-stride view
+        MatrixView<const T> view() const;
+        MatrixView<T> mutable_view();
+
+        // Recompute the payload checksum and compare it with the header
+        bool verify() const;
+
+        // Store the checksum of the current payload, after writing through mutable_view()
+        void update_checksum();
+
+        // Flush modified pages to the file
+        void sync();
+
+    private:
+        const MatrixFileHeader& header() const { return *static_cast<const MatrixFileHeader*>(mapping); }
+        T* payload() const { return reinterpret_cast<T*>(static_cast<char*>(mapping) + header().header_size); }
+        std::uint64_t payload_checksum() const;
+        void map(const std::string& path, bool writable);
+        void unmap();
+
+        void* mapping = nullptr;
+        std::size_t length = 0;
+        bool writable = false;
+    };
+
+    // MatrixFileWriter
+    template<typename T>
+    MatrixFileWriter<T>::MatrixFileWriter(const std::string& path, std::size_t rows, std::size_t cols, Layout layout)
+        : path(path), out(path, std::ios::binary | std::ios::trunc), header(detail::make_header<T>(rows, cols, layout)) {
+        if (!out) {
+            throw detail::file_error("Cannot open matrix file for writing", path);
+        }
+        // Placeholder header, rewritten by close() once the checksum is known
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+
+    template<typename T>
+    MatrixFileWriter<T>::~MatrixFileWriter() {
+        if (out.is_open()) {
+            // An unfinished file keeps its zero checksum and fails verification; errors cannot
+            // propagate out of a destructor
+            try {
+                close();
+            } catch (...) {
+            }
+        }
+    }
+
+    template<typename T>
+    void MatrixFileWriter<T>::write(const T* values, std::size_t n) {
+        if (count + n > header.rows * header.cols) {
+            throw std::invalid_argument("More elements written than the matrix holds");
+        }
+        out.write(reinterpret_cast<const char*>(values), static_cast<std::streamsize>(n * sizeof(T)));
+        if (!out) {
+            throw detail::file_error("Cannot write matrix file", path);
+        }
+        hash.update(values, n * sizeof(T));
+        count += n;
+    }
+
+    template<typename T>
+    template<typename V>
+    void MatrixFileWriter<T>::write(const VectorView<V>& values) {
+        if (values.is_contiguous()) {
+            write(values.data_ptr(), values.size());
+            return;
+        }
+        // Gather strided elements through a small buffer
+        constexpr std::size_t chunk = 1024;
+        T buffer[chunk];
+        for (std::size_t first = 0; first < values.size(); first += chunk) {
+            const std::size_t n = std::min(chunk, values.size() - first);
+            for (std::size_t i = 0; i < n; ++i) {
+                buffer[i] = values[first + i];
+            }
+            write(buffer, n);
+        }
+    }
+
+    template<typename T>
+    void MatrixFileWriter<T>::close() {
+        const bool complete = count == header.rows * header.cols;
+        if (complete) {
+            header.checksum = hash.value();
+            out.seekp(0);
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        }
+        out.close();
+        if (!complete) {
+            throw std::runtime_error("Matrix file '" + path + "' closed before all elements were written");
+        }
+        if (!out) {
+            throw detail::file_error("Cannot finish matrix file", path);
+        }
+    }
+
+    // MappedMatrix
+    template<typename T>
+    MappedMatrix<T>::MappedMatrix(const std::string& path, bool writable) {
+        map(path, writable);
+    }
+
+    template<typename T>
+    MappedMatrix<T>::~MappedMatrix() {
+        unmap();
+    }
+
+    template<typename T>
+    MappedMatrix<T>::MappedMatrix(MappedMatrix&& other) noexcept
+        : mapping(std::exchange(other.mapping, nullptr)), length(std::exchange(other.length, 0)), writable(other.writable) {}
+
+    template<typename T>
+    MappedMatrix<T>& MappedMatrix<T>::operator=(MappedMatrix&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            mapping = std::exchange(other.mapping, nullptr);
+            length = std::exchange(other.length, 0);
+            writable = other.writable;
+        }
+        return *this;
+    }
+
+    template<typename T>
+    MappedMatrix<T> MappedMatrix<T>::create(const std::string& path, std::size_t rows, std::size_t cols, Layout layout) {
+        MatrixFileHeader header = detail::make_header<T>(rows, cols, layout);
+        const std::uint64_t payload_bytes = static_cast<std::uint64_t>(rows) * cols * sizeof(T);
+        header.checksum = detail::Fnv1a::zeros(payload_bytes);
+        {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            if (!out) {
+                throw detail::file_error("Cannot create matrix file", path);
+            }
+        }
+        // Extending the file leaves a hole that reads as zeros, nothing is written for the payload
+        std::error_code error;
+        std::filesystem::resize_file(path, sizeof(header) + payload_bytes, error);
+        if (error) {
+            throw std::runtime_error("Cannot size matrix file '" + path + "': " + error.message());
+        }
+        return MappedMatrix(path, true);
+    }
+
+    template<typename T>
+    void MappedMatrix<T>::map(const std::string& path, bool write_access) {
+        const int fd = ::open(path.c_str(), write_access ? O_RDWR : O_RDONLY);
+        if (fd < 0) {
+            throw detail::file_error("Cannot open matrix file", path);
+        }
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw detail::file_error("Cannot stat matrix file", path);
+        }
+        length = static_cast<std::size_t>(info.st_size);
+        if (length < sizeof(MatrixFileHeader)) {
+            ::close(fd);
+            throw std::runtime_error("Matrix file '" + path + "' is too short");
+        }
+        void* p = ::mmap(nullptr, length, write_access ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) {
+            length = 0;
+            throw detail::file_error("Cannot map matrix file", path);
+        }
+        mapping = p;
+        writable = write_access;
+
+        const MatrixFileHeader& h = header();
+        std::string problem;
+        if (std::memcmp(h.magic, detail::matrix_file_magic, sizeof(h.magic)) != 0) {
+            problem = "is not a matrix file";
+        } else if (h.version != matrix_file_version) {
+            problem = "has an unsupported version";
+        } else if (h.dtype != dtype_of<T>::value) {
+            problem = "holds a different element type";
+        } else if (h.layout != Layout::RowMajor && h.layout != Layout::ColumnMajor) {
+            problem = "has an unknown layout";
+        } else if (h.header_size < sizeof(MatrixFileHeader) || h.header_size % alignof(T) != 0 || h.header_size > length
+                   // Bound rows * cols by the payload before multiplying, a crafted header could wrap the product
+                   || (h.cols != 0 && h.rows > (length - h.header_size) / sizeof(T) / h.cols)
+                   || length != h.header_size + h.rows * h.cols * sizeof(T)) {
+            problem = "has a size that does not match its header";
+        }
+        if (!problem.empty()) {
+            unmap();
+            throw std::runtime_error("Matrix file '" + path + "' " + problem);
+        }
+    }
+
+    template<typename T>
+    void MappedMatrix<T>::unmap() {
+        if (mapping != nullptr) {
+            ::munmap(mapping, length);
+            mapping = nullptr;
+            length = 0;
+        }
+    }
+
+    template<typename T>
+    MatrixView<const T> MappedMatrix<T>::view() const {
+        if (layout() == Layout::ColumnMajor) {
+            return MatrixView<const T>(payload(), rows(), cols(), 1, static_cast<std::ptrdiff_t>(rows()));
+        }
+        return MatrixView<const T>(payload(), rows(), cols());
+    }
+
+    template<typename T>
+    MatrixView<T> MappedMatrix<T>::mutable_view() {
+        if (!writable) {
+            throw std::runtime_error("Matrix file is mapped read-only");
+        }
+        if (layout() == Layout::ColumnMajor) {
+            return MatrixView<T>(payload(), rows(), cols(), 1, static_cast<std::ptrdiff_t>(rows()));
+        }
+        return MatrixView<T>(payload(), rows(), cols());
+    }
+
+    template<typename T>
+    std::uint64_t MappedMatrix<T>::payload_checksum() const {
+        detail::Fnv1a hash;
+        hash.update(payload(), rows() * cols() * sizeof(T));
+        return hash.value();
+    }
+
+    template<typename T>
+    bool MappedMatrix<T>::verify() const {
+        return payload_checksum() == header().checksum;
+    }
+
+    template<typename T>
+    void MappedMatrix<T>::update_checksum() {
+        if (!writable) {
+            throw std::runtime_error("Matrix file is mapped read-only");
+        }
+        static_cast<MatrixFileHeader*>(mapping)->checksum = payload_checksum();
+    }
+
+    template<typename T>
+    void MappedMatrix<T>::sync() {
+        if (mapping != nullptr && ::msync(mapping, length, MS_SYNC) != 0) {
+            throw std::runtime_error(std::string("Cannot sync matrix file: ") + std::strerror(errno));
+        }
+    }
+
+    // Save any matrix view (Matrix, DynamicMatrix, blocks, transposed views) in row-major order
+    template<typename V>
+    void save_matrix(const std::string& path, const MatrixView<V>& mat) {
+        MatrixFileWriter<std::remove_const_t<V>> writer(path, mat.rows(), mat.cols());
+        for (std::size_t i = 0; i < mat.rows(); ++i) {
+            writer.write(mat.row(i));
+        }
+        writer.close();
+    }
+
+    // Load a whole file into memory; use MappedMatrix to work on it in place instead
+    template<typename T>
+    DynamicMatrix<T> load_matrix(const std::string& path) {
+        return MappedMatrix<T>(path).view().eval();
+    }
+
+}
+
+#endif
@@ -0,0 +1,226 @@
+//Contains implementation for aligned allocation of heap-backed storage and the scoped workspace arena
+
+#ifndef MEMORY_HPP
+#define MEMORY_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+namespace linear_algebra {
+
+    // Default alignment of heap buffers, one cache line (also the widest SIMD register)
+    inline constexpr std::size_t default_alignment = 64;
+
+    namespace detail {
+
+        // Widest power of two up to default_alignment that divides bytes (and is at least minimum)
+        constexpr std::size_t storage_alignment(std::size_t bytes, std::size_t minimum) {
+            std::size_t alignment = minimum;
+            while (alignment * 2 <= default_alignment && bytes % (alignment * 2) == 0) {
+                alignment *= 2;
+            }
+            return alignment;
+        }
+
+    }
+
+    // Alignment of in-object storage for Count elements of T. Objects whose size is a multiple of
+    // a SIMD register start on a register (or cache line) boundary, so full-width loads never
+    // straddle one; sizes that are not are left at natural alignment instead of being padded.
+    template<typename T, std::size_t Count>
+    inline constexpr std::size_t storage_alignment = detail::storage_alignment(Count * sizeof(T), alignof(T));
+
+    // Bump-pointer arena for the buffers of temporaries. Allocation advances an offset, freeing is
+    // a no-op except for the most recent allocation (temporaries tend to die in reverse order), and
+    // reset() makes the whole arena available again in O(1). When a pass needs more than the
+    // current block a new one is chained on; the next reset() merges them into a single block of
+    // the combined size, so from the second pass on a loop of the same shape never reaches malloc.
+    // A workspace is used by one thread at a time.
+    class Workspace {
+    public:
+        explicit Workspace(std::size_t initial_bytes = std::size_t(1) << 20) {
+            if (initial_bytes > 0) {
+                add_block(initial_bytes);
+            }
+        }
+
+        ~Workspace() { release(); }
+
+        Workspace(const Workspace&) = delete;
+        Workspace& operator=(const Workspace&) = delete;
+
+        void* allocate(std::size_t bytes, std::size_t alignment) {
+            if (!blocks.empty()) {
+                Block& block = blocks.back();
+                const std::size_t start = align_up(block.data, offset, alignment);
+                if (start + bytes <= block.size) {
+                    offset = start + bytes;
+                    used_bytes += bytes;
+                    high_water_bytes = std::max(high_water_bytes, used_bytes);
+                    return block.data + start;
+                }
+            }
+            const std::size_t previous = blocks.empty() ? 0 : blocks.back().size;
+            add_block(std::max(2 * previous, bytes + alignment));
+            return allocate(bytes, alignment);
+        }
+
+        void deallocate(void* p, std::size_t bytes) noexcept {
+            // Only the top of the current block can be given back; anything else waits for reset()
+            if (!blocks.empty() && static_cast<std::byte*>(p) + bytes == blocks.back().data + offset) {
+                offset -= bytes;
+            }
+            used_bytes -= std::min(used_bytes, bytes);
+        }
+
+        // Invalidates every buffer handed out since the last reset
+        void reset() {
+            if (blocks.size() > 1) {
+                std::size_t total = 0;
+                for (const Block& block : blocks) {
+                    total += block.size;
+                }
+                release();
+                add_block(total);
+            }
+            offset = 0;
+            used_bytes = 0;
+        }
+
+        std::size_t capacity() const {
+            std::size_t total = 0;
+            for (const Block& block : blocks) {
+                total += block.size;
+            }
+            return total;
+        }
+
+        // Bytes currently handed out, and the most ever handed out at once
+        std::size_t used() const { return used_bytes; }
+        std::size_t high_water() const { return high_water_bytes; }
+
+        // Blocks requested from the system so far; constant once a loop has reached steady state
+        std::size_t system_allocations() const { return block_allocations; }
+
+    private:
+        struct Block {
+            std::byte* data;
+            std::size_t size;
+        };
+
+        static std::size_t align_up(const std::byte* base, std::size_t offset, std::size_t alignment) {
+            const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(base) + offset;
+            return offset + ((alignment - address % alignment) % alignment);
+        }
+
+        void add_block(std::size_t bytes) {
+            std::byte* data = static_cast<std::byte*>(::operator new(bytes, std::align_val_t(default_alignment)));
+            blocks.push_back({data, bytes});
+            offset = 0;
+            ++block_allocations;
+        }
+
+        void release() noexcept {
+            for (const Block& block : blocks) {
+                ::operator delete(block.data, std::align_val_t(default_alignment));
+            }
+            blocks.clear();
+        }
+
+        std::vector<Block> blocks;
+        std::size_t offset = 0;
+        std::size_t used_bytes = 0;
+        std::size_t high_water_bytes = 0;
+        std::size_t block_allocations = 0;
+    };
+
+    namespace detail {
+
+        // Workspace that allocators constructed on this thread draw from, null for the heap
+        inline Workspace*& current_workspace() {
+            thread_local Workspace* workspace = nullptr;
+            return workspace;
+        }
+
+    }
+
+    // Routes the dynamic containers created on this thread into a workspace for the lifetime of
+    // the scope and resets the workspace when it ends, so one scope per loop iteration recycles
+    // the same memory. Containers created inside must not outlive the scope; to keep a result,
+    // assign it to a container created outside (copies reuse the destination's own storage).
+    // Passing nullptr suspends an enclosing scope, e.g. to create such a container.
+    class WorkspaceScope {
+    public:
+        explicit WorkspaceScope(Workspace* workspace) : workspace(workspace), previous(detail::current_workspace()) {
+            detail::current_workspace() = workspace;
+        }
+
+        explicit WorkspaceScope(Workspace& workspace) : WorkspaceScope(&workspace) {}
+
+        ~WorkspaceScope() {
+            detail::current_workspace() = previous;
+            if (workspace != nullptr && workspace != previous) {
+                workspace->reset();
+            }
+        }
+
+        WorkspaceScope(const WorkspaceScope&) = delete;
+        WorkspaceScope& operator=(const WorkspaceScope&) = delete;
+
+    private:
+        Workspace* workspace;
+        Workspace* previous;
+    };
+
+    // Standard allocator returning memory aligned to Alignment bytes. It binds to the thread's
+    // current workspace when constructed (see WorkspaceScope) and to the heap otherwise. Copies of
+    // a container bind to whatever is current at the time of the copy, and assignments (copy or
+    // move) keep the destination's binding, so assigning a workspace temporary to a heap container
+    // copies the elements into heap storage.
+    template<typename T, std::size_t Alignment = default_alignment>
+    class AlignedAllocator {
+    public:
+        using value_type = T;
+
+        template<typename U>
+        struct rebind {
+            using other = AlignedAllocator<U, Alignment>;
+        };
+
+        AlignedAllocator() noexcept : workspace(detail::current_workspace()) {}
+
+        template<typename U>
+        AlignedAllocator(const AlignedAllocator<U, Alignment>& other) noexcept : workspace(other.bound_workspace()) {}
+
+        T* allocate(std::size_t n) {
+            if (workspace != nullptr) {
+                return static_cast<T*>(workspace->allocate(n * sizeof(T), Alignment));
+            }
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+        }
+
+        void deallocate(T* p, std::size_t n) noexcept {
+            if (workspace != nullptr) {
+                workspace->deallocate(p, n * sizeof(T));
+            } else {
+                ::operator delete(p, std::align_val_t(Alignment));
+            }
+        }
+
+        AlignedAllocator select_on_container_copy_construction() const noexcept { return AlignedAllocator(); }
+
+        Workspace* bound_workspace() const noexcept { return workspace; }
+
+        template<typename U>
+        bool operator==(const AlignedAllocator<U, Alignment>& other) const noexcept { return workspace == other.bound_workspace(); }
+
+    private:
+        Workspace* workspace;
+    };
+
+}
+
+#endif
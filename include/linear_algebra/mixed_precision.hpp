@@ -0,0 +1,280 @@
+//Contains implementation for 16-bit storage types and the mixed-precision solver with iterative refinement
+
+#ifndef MIXED_PRECISION_HPP
+#define MIXED_PRECISION_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "matrix.hpp"
+#include "vector.hpp"
+
+namespace linear_algebra {
+
+    // Storage-only 16-bit floating-point types: values are converted to float (round to nearest
+    // even) on the way in and widened back to float for any arithmetic.
+
+    // bfloat16: the upper half of a float, same range with an 8-bit significand
+    class bfloat16 {
+    public:
+        constexpr bfloat16() : bits(0) {}
+
+        constexpr explicit bfloat16(float value) : bits(from_float(value)) {}
+
+        constexpr explicit operator float() const {
+            return std::bit_cast<float>(static_cast<std::uint32_t>(bits) << 16);
+        }
+
+        constexpr std::uint16_t raw() const { return bits; }
+
+    private:
+        static constexpr std::uint16_t from_float(float value) {
+            const std::uint32_t x = std::bit_cast<std::uint32_t>(value);
+            if ((x & 0x7FFFFFFFu) > 0x7F800000u) {
+                // Keep NaN a (quiet) NaN instead of letting the rounding carry turn it into infinity
+                return static_cast<std::uint16_t>((x >> 16) | 0x0040u);
+            }
+            return static_cast<std::uint16_t>((x + 0x7FFFu + ((x >> 16) & 1u)) >> 16);
+        }
+
+        std::uint16_t bits;
+    };
+
+    // IEEE 754 binary16: 11-bit significand, largest finite value 65504
+    class float16 {
+    public:
+        constexpr float16() : bits(0) {}
+
+        constexpr explicit float16(float value) : bits(from_float(value)) {}
+
+        constexpr explicit operator float() const {
+            const std::uint32_t sign = static_cast<std::uint32_t>(bits & 0x8000u) << 16;
+            const std::uint32_t exponent = (bits >> 10) & 0x1Fu;
+            const std::uint32_t mantissa = bits & 0x3FFu;
+            if (exponent == 0) {
+                // Zero or subnormal, mantissa * 2^-24 is exact in float
+                const float magnitude = static_cast<float>(mantissa) * 5.9604644775390625e-8f;
+                return sign ? -magnitude : magnitude;
+            }
+            if (exponent == 31) {
+                return std::bit_cast<float>(sign | 0x7F800000u | (mantissa << 13));
+            }
+            return std::bit_cast<float>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+        }
+
+        constexpr std::uint16_t raw() const { return bits; }
+
+    private:
+        static constexpr std::uint16_t from_float(float value) {
+            std::uint32_t x = std::bit_cast<std::uint32_t>(value);
+            const std::uint16_t sign = static_cast<std::uint16_t>((x >> 16) & 0x8000u);
+            x &= 0x7FFFFFFFu;
+            if (x >= 0x7F800000u) {
+                return sign | (x > 0x7F800000u ? 0x7E00u : 0x7C00u);
+            }
+            if (x >= 0x477FF000u) {
+                // 65520 and above round to infinity
+                return sign | 0x7C00u;
+            }
+            if (x < 0x38800000u) {
+                // Below the smallest normal half: the significand is |value| * 2^24 rounded to an
+                // integer, and a carry into 1024 correctly yields the smallest normal encoding
+                const float scaled = std::bit_cast<float>(x) * 16777216.0f;
+                std::uint32_t m = static_cast<std::uint32_t>(scaled);
+                const float remainder = scaled - static_cast<float>(m);
+                if (remainder > 0.5f || (remainder == 0.5f && (m & 1u))) {
+                    ++m;
+                }
+                return static_cast<std::uint16_t>(sign | m);
+            }
+            // Rebias the exponent from 127 to 15 and round the 13 dropped bits to nearest even
+            x += 0xC8000FFFu + ((x >> 13) & 1u);
+            return static_cast<std::uint16_t>(sign | (x >> 13));
+        }
+
+        std::uint16_t bits;
+    };
+
+    static_assert(sizeof(bfloat16) == 2 && sizeof(float16) == 2, "16-bit storage types must not be padded");
+
+    struct RefinementOptions {
+        // Converged once ||b - A x||_inf <= tolerance * ||A||_inf * ||x||_inf, by default
+        // sqrt(N) * double epsilon (the LAPACK dsgesv criterion)
+        double tolerance = -1.0;
+        int max_iterations = 30;
+        // Solve again with a double-precision factorization if refinement does not converge,
+        // which happens when cond(A) approaches 1 / (unit roundoff of the factor storage)
+        bool fallback_to_double = true;
+    };
+
+    template<int N>
+    struct RefinementResult {
+        Vector<double, N> x;
+        // Correction steps applied after the initial low-precision solve
+        int iterations = 0;
+        // Normwise backward error ||b - A x||_inf / (||A||_inf ||x||_inf + ||b||_inf) of x
+        double backward_error = 0.0;
+        bool converged = false;
+        // x came from the double-precision fallback
+        bool used_fallback = false;
+    };
+
+    // LU factorization computed in float and kept in Storage (float, bfloat16 or float16), used to
+    // solve A x = b to double-precision accuracy: each step computes the residual r = b - A x in
+    // double, solves A d = r with the cheap factors and updates x += d in double. Every step reduces
+    // the error by about cond(A) * u_storage, so well-conditioned systems converge in a few steps.
+    template<typename T, int N, typename Storage = float>
+    class MixedPrecisionLU {
+    public:
+        explicit MixedPrecisionLU(const Matrix<T, N, N>& a);
+
+        // True if a zero pivot was met in the low-precision factorization
+        bool is_singular() const { return singular; }
+
+        RefinementResult<N> solve(const Vector<double, N>& b, const RefinementOptions& options = {}) const;
+
+        // Bytes held by the factors, half those of a float factorization with 16-bit storage
+        std::size_t factor_bytes() const { return factors.size() * sizeof(Storage); }
+
+    private:
+        // One low-precision solve of A d = r
+        Vector<double, N> correction(const Vector<double, N>& r) const;
+
+        Matrix<T, N, N> a;
+        std::vector<Storage> factors;
+        std::array<int, N> piv;
+        // The factors are of A / scale, which keeps the entries of U inside the float16 range
+        double scale;
+        bool singular;
+    };
+
+    template<typename T, int N, typename Storage>
+    MixedPrecisionLU<T, N, Storage>::MixedPrecisionLU(const Matrix<T, N, N>& a) : a(a), factors(static_cast<std::size_t>(N) * N), piv{} {
+        static_assert(std::is_same_v<Storage, float> || std::is_same_v<Storage, bfloat16> || std::is_same_v<Storage, float16>,
+                      "Factors are stored as float, bfloat16 or float16");
+        double max_abs = 0.0;
+        for (int i = 0; i < N; ++i) {
+            for (int j = 0; j < N; ++j) {
+                max_abs = std::max(max_abs, std::abs(static_cast<double>(a(i, j))));
+            }
+        }
+        scale = max_abs > 0.0 ? max_abs : 1.0;
+
+        std::vector<float> work(factors.size());
+        for (int i = 0; i < N; ++i) {
+            for (int j = 0; j < N; ++j) {
+                work[static_cast<std::size_t>(i) * N + j] = static_cast<float>(static_cast<double>(a(i, j)) / scale);
+            }
+        }
+        int sign = 1;
+        singular = !detail::lu_factor(work.data(), N, N, piv.data(), sign);
+        for (std::size_t i = 0; i < work.size(); ++i) {
+            factors[i] = Storage(work[i]);
+            if constexpr (!std::is_same_v<Storage, float>) {
+                // A pivot that rounds to zero in storage would turn the solves into divisions by zero
+                const std::size_t n = static_cast<std::size_t>(N);
+                if (i % n == i / n && static_cast<float>(factors[i]) == 0.0f) {
+                    singular = true;
+                }
+            }
+        }
+    }
+
+    template<typename T, int N, typename Storage>
+    Vector<double, N> MixedPrecisionLU<T, N, Storage>::correction(const Vector<double, N>& r) const {
+        std::array<float, N> d;
+        for (int i = 0; i < N; ++i) {
+            d[i] = static_cast<float>(r[i]);
+        }
+        detail::lu_solve(factors.data(), N, N, piv.data(), d.data(), 1, 1);
+        Vector<double, N> result;
+        for (int i = 0; i < N; ++i) {
+            result[i] = static_cast<double>(d[i]) / scale;
+        }
+        return result;
+    }
+
+    template<typename T, int N, typename Storage>
+    RefinementResult<N> MixedPrecisionLU<T, N, Storage>::solve(const Vector<double, N>& b, const RefinementOptions& options) const {
+        const double tolerance = options.tolerance < 0.0 ? std::sqrt(static_cast<double>(N)) * std::numeric_limits<double>::epsilon()
+                                                          : options.tolerance;
+        double a_norm = 0.0;
+        for (int i = 0; i < N; ++i) {
+            double row = 0.0;
+            for (int j = 0; j < N; ++j) {
+                row += std::abs(static_cast<double>(a(i, j)));
+            }
+            a_norm = std::max(a_norm, row);
+        }
+        double b_norm = 0.0;
+        for (int i = 0; i < N; ++i) {
+            b_norm = std::max(b_norm, std::abs(b[i]));
+        }
+
+        RefinementResult<N> result;
+        Vector<double, N> r;
+        // Residual in double, returns ||r||_inf and fills the backward error
+        auto residual = [&]() {
+            double r_norm = 0.0;
+            double x_norm = 0.0;
+            for (int i = 0; i < N; ++i) {
+                double sum = b[i];
+                for (int j = 0; j < N; ++j) {
+                    sum -= static_cast<double>(a(i, j)) * result.x[j];
+                }
+                r[i] = sum;
+                r_norm = std::max(r_norm, std::abs(sum));
+                x_norm = std::max(x_norm, std::abs(result.x[i]));
+            }
+            const double denominator = a_norm * x_norm + b_norm;
+            result.backward_error = denominator > 0.0 ? r_norm / denominator : 0.0;
+            return r_norm <= tolerance * a_norm * x_norm;
+        };
+
+        if (!singular) {
+            result.x = correction(b);
+            result.converged = residual();
+            double previous = std::numeric_limits<double>::infinity();
+            // Stop early when a step no longer halves the backward error: the factors are then too
+            // inaccurate for this matrix and further steps only cost time
+            while (!result.converged && result.iterations < options.max_iterations
+                   && result.backward_error < 0.5 * previous) {
+                previous = result.backward_error;
+                const Vector<double, N> d = correction(r);
+                for (int i = 0; i < N; ++i) {
+                    result.x[i] += d[i];
+                }
+                ++result.iterations;
+                result.converged = residual();
+            }
+        }
+        if (!result.converged && options.fallback_to_double) {
+            Matrix<double, N, N> a_double;
+            for (int i = 0; i < N; ++i) {
+                for (int j = 0; j < N; ++j) {
+                    a_double(i, j) = static_cast<double>(a(i, j));
+                }
+            }
+            result.x = LU<double, N>(a_double).solve(b);
+            result.used_fallback = true;
+            result.converged = residual();
+        }
+        return result;
+    }
+
+    // Solve A x = b to double accuracy with float (or 16-bit) factors and double residuals
+    template<typename Storage = float, typename T, int N, size_t M>
+    RefinementResult<N> solve_mixed_precision(const Matrix<T, N, N>& a, const Vector<double, M>& b, const RefinementOptions& options = {}) {
+        static_assert(M == N, "Size of the right-hand side must match the matrix");
+        return MixedPrecisionLU<T, N, Storage>(a).solve(b, options);
+    }
+
+}
+
+#endif
@@ -0,0 +1,180 @@
+//Contains implementation for the out-of-core tiled multiply of disk-backed matrices
+
+#ifndef OUT_OF_CORE_HPP
+#define OUT_OF_CORE_HPP
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "memory.hpp"
+#include "gemm.hpp"
+#include "view.hpp"
+#include "matrix_file.hpp"
+
+namespace linear_algebra {
+
+    struct OutOfCoreOptions {
+        // Bytes available for tile buffers (one C tile and two sets of A and B tiles)
+        std::size_t memory_budget = std::size_t(256) << 20;
+        // Load the next pair of tiles on a background thread while the current pair is multiplied
+        bool prefetch = true;
+        // Refresh the checksum of the output file at the end (one extra pass over C)
+        bool update_checksum = true;
+    };
+
+    struct OutOfCoreStats {
+        std::size_t tile = 0;          // edge of the square tiles
+        std::size_t tile_loads = 0;    // pairs of A and B tiles read
+        double wait_seconds = 0.0;     // time the multiply stalled waiting for tiles
+    };
+
+    namespace detail {
+
+        // Largest square tile whose five buffers fit the budget, rounded down to a multiple of
+        // the GEMM cache block when it is that large
+        template<typename T>
+        std::size_t out_of_core_tile(std::size_t budget) {
+            const double elements = static_cast<double>(budget) / (5.0 * sizeof(T));
+            std::size_t tile = static_cast<std::size_t>(std::sqrt(elements));
+            constexpr std::size_t block = gemm_blocking<T>::MC;
+            if (tile >= block) {
+                tile -= tile % block;
+            }
+            if (tile == 0) {
+                throw std::invalid_argument("Memory budget is too small for a single tile");
+            }
+            return tile;
+        }
+
+        // Copy a block of a (possibly strided) view into a contiguous row-major buffer.
+        // Runs on the prefetch thread, so it stays off the shared thread pool.
+        template<typename T>
+        void load_tile(const MatrixView<const T>& src, T* dst) {
+            for (std::size_t i = 0; i < src.rows(); ++i) {
+                T* row = dst + i * src.cols();
+                if (src.is_row_major()) {
+                    std::copy(&src(i, 0), &src(i, 0) + src.cols(), row);
+                } else {
+                    for (std::size_t j = 0; j < src.cols(); ++j) {
+                        row[j] = src(i, j);
+                    }
+                }
+            }
+        }
+
+        template<typename T>
+        void store_tile(const T* src, const MatrixView<T>& dst) {
+            for (std::size_t i = 0; i < dst.rows(); ++i) {
+                const T* row = src + i * dst.cols();
+                for (std::size_t j = 0; j < dst.cols(); ++j) {
+                    dst(i, j) = row[j];
+                }
+            }
+        }
+
+    }
+
+    // C = A B for matrices that live in files. C is computed one square tile at a time: the tile
+    // is accumulated in memory over the tiles of a block row of A and a block column of B with the
+    // in-memory GEMM kernel, then written to C. With prefetching the next pair of input tiles is
+    // read on a background thread while the current pair is multiplied. Only the tile buffers are
+    // allocated, their total stays within options.memory_budget; the mapped file pages are clean
+    // page cache that the kernel can evict at any time.
+    template<typename T>
+    OutOfCoreStats multiply_out_of_core(const MappedMatrix<T>& a, const MappedMatrix<T>& b, MappedMatrix<T>& c,
+                                        const OutOfCoreOptions& options = {}) {
+        const std::size_t m = a.rows();
+        const std::size_t k = a.cols();
+        const std::size_t n = b.cols();
+        if (b.rows() != k || c.rows() != m || c.cols() != n) {
+            throw std::invalid_argument("Number of columns in the first matrix must match the number of rows in the second matrix");
+        }
+
+        OutOfCoreStats stats;
+        stats.tile = std::min(detail::out_of_core_tile<T>(options.memory_budget), std::max({m, n, k, std::size_t(1)}));
+        const std::size_t t = stats.tile;
+        const std::size_t m_tiles = (m + t - 1) / t;
+        const std::size_t n_tiles = (n + t - 1) / t;
+        const std::size_t k_tiles = (k + t - 1) / t;
+        const std::size_t steps = m_tiles * n_tiles * k_tiles;
+        if (steps == 0) {
+            return stats;
+        }
+
+        const MatrixView<const T> av = a.view();
+        const MatrixView<const T> bv = b.view();
+        const MatrixView<T> cv = c.mutable_view();
+
+        using Buffer = std::vector<T, AlignedAllocator<T>>;
+        std::array<Buffer, 2> a_tiles{Buffer(t * t), Buffer(t * t)};
+        std::array<Buffer, 2> b_tiles{Buffer(t * t), Buffer(t * t)};
+        Buffer c_tile(t * t, T());
+
+        // Step s multiplies A(ic, pc) by B(pc, jc); consecutive steps walk pc fastest so each C
+        // tile is finished before the next one starts
+        auto coordinates = [&](std::size_t s) {
+            return std::array<std::size_t, 3>{s / (n_tiles * k_tiles), (s / k_tiles) % n_tiles, s % k_tiles};
+        };
+        auto extent = [t](std::size_t index, std::size_t total) { return std::min(t, total - index * t); };
+        auto load = [&](std::size_t s, std::size_t slot) {
+            const auto [ic, jc, pc] = coordinates(s);
+            detail::load_tile(av.block(ic * t, pc * t, extent(ic, m), extent(pc, k)), a_tiles[slot].data());
+            detail::load_tile(bv.block(pc * t, jc * t, extent(pc, k), extent(jc, n)), b_tiles[slot].data());
+        };
+
+        std::future<void> pending;
+        if (options.prefetch) {
+            pending = std::async(std::launch::async, load, 0, 0);
+        }
+        for (std::size_t s = 0; s < steps; ++s) {
+            const std::size_t slot = s % 2;
+            const auto start = std::chrono::steady_clock::now();
+            if (options.prefetch) {
+                pending.get();
+                if (s + 1 < steps) {
+                    pending = std::async(std::launch::async, load, s + 1, 1 - slot);
+                }
+            } else {
+                load(s, slot);
+            }
+            stats.wait_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            ++stats.tile_loads;
+
+            const auto [ic, jc, pc] = coordinates(s);
+            const int mb = static_cast<int>(extent(ic, m));
+            const int nb = static_cast<int>(extent(jc, n));
+            const int kb = static_cast<int>(extent(pc, k));
+            detail::gemm(mb, nb, kb, a_tiles[slot].data(), kb, b_tiles[slot].data(), nb, c_tile.data(), nb);
+
+            if (pc + 1 == k_tiles) {
+                detail::store_tile(c_tile.data(), cv.block(ic * t, jc * t, mb, nb));
+                std::fill(c_tile.begin(), c_tile.end(), T());
+            }
+        }
+
+        if (options.update_checksum) {
+            c.update_checksum();
+        }
+        c.sync();
+        return stats;
+    }
+
+    // Same product on file paths; C is created (or overwritten) with the product's shape
+    template<typename T>
+    OutOfCoreStats multiply_out_of_core(const std::string& a_path, const std::string& b_path, const std::string& c_path,
+                                        const OutOfCoreOptions& options = {}) {
+        MappedMatrix<T> a(a_path);
+        MappedMatrix<T> b(b_path);
+        MappedMatrix<T> c = MappedMatrix<T>::create(c_path, a.rows(), b.cols());
+        return multiply_out_of_core(a, b, c, options);
+    }
+
+}
+
+#endif
@@ -0,0 +1,317 @@
+//Contains implementation for the optional thread-pool backend used by large matrix operations
+
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace linear_algebra {
+
+    // Work-stealing thread pool. Each worker owns a deque: it pops its own work from the back
+    // and steals from the front of the others when it runs dry. The thread submitting a batch
+    // also executes tasks until the batch completes.
+    class ThreadPool {
+    public:
+        explicit ThreadPool(unsigned threads);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        // Number of threads taking part in a batch, including the submitting thread
+        unsigned size() const { return static_cast<unsigned>(workers.size()) + 1; }
+
+        // Call func(i) for every i in [0, tasks) and wait for all of them.
+        // The first exception thrown by a task is rethrown here once the batch has finished.
+        void run(std::size_t tasks, const std::function<void(std::size_t)>& func);
+
+    private:
+        struct Batch {
+            const std::function<void(std::size_t)>* func;
+            std::atomic<std::size_t> remaining;
+            std::mutex mutex;
+            std::condition_variable done;
+            std::exception_ptr error;
+        };
+
+        struct Task {
+            Batch* batch;
+            std::size_t index;
+        };
+
+        struct Queue {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        bool pop_local(std::size_t queue, Task& task);
+        bool steal(std::size_t thief, Task& task);
+        void execute(const Task& task);
+        void worker_loop(std::size_t id);
+
+        std::vector<std::thread> workers;
+        std::vector<std::unique_ptr<Queue>> queues;
+        std::mutex wake_mutex;
+        std::condition_variable wake;
+        std::atomic<std::size_t> pending{0};
+        bool stopping = false;
+    };
+
+    namespace detail {
+
+        // True on pool worker threads, and on a submitting thread while it executes tasks;
+        // nested parallel regions then run inline
+        inline bool& inside_pool_worker() {
+            thread_local bool inside = false;
+            return inside;
+        }
+
+        // Marks the current thread as a pool worker for its lifetime, restoring the previous state after
+        class PoolWorkerScope {
+        public:
+            PoolWorkerScope() : previous(inside_pool_worker()) { inside_pool_worker() = true; }
+            ~PoolWorkerScope() { inside_pool_worker() = previous; }
+
+            PoolWorkerScope(const PoolWorkerScope&) = delete;
+            PoolWorkerScope& operator=(const PoolWorkerScope&) = delete;
+
+        private:
+            bool previous;
+        };
+
+    }
+
+    inline ThreadPool::ThreadPool(unsigned threads) {
+        const unsigned worker_count = threads > 1 ? threads - 1 : 0;
+        // One queue per worker plus one for the submitting thread
+        for (unsigned i = 0; i <= worker_count; ++i) {
+            queues.push_back(std::make_unique<Queue>());
+        }
+        for (unsigned i = 0; i < worker_count; ++i) {
+            workers.emplace_back([this, i] { worker_loop(i + 1); });
+        }
+    }
+
+    inline ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    inline bool ThreadPool::pop_local(std::size_t queue, Task& task) {
+        Queue& q = *queues[queue];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.tasks.empty()) {
+            return false;
+        }
+        task = q.tasks.back();
+        q.tasks.pop_back();
+        return true;
+    }
+
+    inline bool ThreadPool::steal(std::size_t thief, Task& task) {
+        for (std::size_t offset = 1; offset < queues.size(); ++offset) {
+            Queue& q = *queues[(thief + offset) % queues.size()];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (!q.tasks.empty()) {
+                task = q.tasks.front();
+                q.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    inline void ThreadPool::execute(const Task& task) {
+        pending.fetch_sub(1);
+        Batch& batch = *task.batch;
+        try {
+            (*batch.func)(task.index);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(batch.mutex);
+            if (!batch.error) {
+                batch.error = std::current_exception();
+            }
+        }
+        // Completion is signalled under the batch mutex so the submitter cannot return
+        // (and destroy the batch) while this thread still touches it
+        std::lock_guard<std::mutex> lock(batch.mutex);
+        if (batch.remaining.fetch_sub(1) == 1) {
+            batch.done.notify_all();
+        }
+    }
+
+    inline void ThreadPool::worker_loop(std::size_t id) {
+        detail::inside_pool_worker() = true;
+        while (true) {
+            Task task;
+            if (pop_local(id, task) || steal(id, task)) {
+                execute(task);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(wake_mutex);
+            wake.wait(lock, [this] { return stopping || pending.load() > 0; });
+            if (stopping) {
+                return;
+            }
+        }
+    }
+
+    inline void ThreadPool::run(std::size_t tasks, const std::function<void(std::size_t)>& func) {
+        if (tasks == 0) {
+            return;
+        }
+        if (workers.empty() || tasks == 1 || detail::inside_pool_worker()) {
+            for (std::size_t i = 0; i < tasks; ++i) {
+                func(i);
+            }
+            return;
+        }
+
+        Batch batch;
+        batch.func = &func;
+        batch.remaining = tasks;
+
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex);
+            pending.fetch_add(tasks);
+        }
+
+        // Deal the tasks out round-robin so every worker starts with local work
+        for (std::size_t i = 0; i < tasks; ++i) {
+            Queue& q = *queues[i % queues.size()];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            q.tasks.push_back(Task{&batch, i});
+        }
+        wake.notify_all();
+
+        // Help out while there is work to take, then wait for the tasks still running elsewhere.
+        // Tasks run here must not start a nested batch: it would share this thread's per-thread
+        // buffers (such as the packed GEMM panels) with tasks of this batch still in flight.
+        while (true) {
+            Task task;
+            if (pop_local(0, task) || steal(0, task)) {
+                detail::PoolWorkerScope scope;
+                execute(task);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(batch.mutex);
+            batch.done.wait(lock, [&batch] { return batch.remaining.load() == 0; });
+            break;
+        }
+
+        if (batch.error) {
+            std::rethrow_exception(batch.error);
+        }
+    }
+
+    namespace detail {
+
+        inline unsigned threads_from_environment() {
+            if (const char* value = std::getenv("LINEAR_ALGEBRA_NUM_THREADS")) {
+                const int requested = std::atoi(value);
+                if (requested > 0) {
+                    return static_cast<unsigned>(requested);
+                }
+            }
+            return 1;
+        }
+
+        struct ParallelSettings {
+            ParallelSettings() : threads(threads_from_environment()) {}
+
+            std::atomic<unsigned> threads;
+            // Operations estimated below this many floating point operations stay on the calling thread
+            std::atomic<std::size_t> threshold = std::size_t(1) << 20;
+            // Guarded by mutex; batches hold their own reference, so resizing never destroys a pool in use
+            std::shared_ptr<ThreadPool> pool;
+            std::mutex mutex;
+        };
+
+        inline ParallelSettings& parallel_settings() {
+            static ParallelSettings settings;
+            return settings;
+        }
+
+    }
+
+    // Number of threads used for large operations. 1 (the default unless LINEAR_ALGEBRA_NUM_THREADS
+    // is set) keeps everything on the calling thread; 0 selects the hardware concurrency.
+    inline void set_num_threads(unsigned threads) {
+        auto& settings = detail::parallel_settings();
+        std::lock_guard<std::mutex> lock(settings.mutex);
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        if (threads != settings.threads.load()) {
+            settings.threads = threads;
+            // Batches still running keep the old pool alive until they finish
+            settings.pool.reset();
+        }
+    }
+
+    inline unsigned get_num_threads() {
+        return detail::parallel_settings().threads;
+    }
+
+    // Work estimate (in floating point operations) below which operations are not split
+    inline void set_parallel_threshold(std::size_t flops) {
+        detail::parallel_settings().threshold = flops;
+    }
+
+    inline std::size_t get_parallel_threshold() {
+        return detail::parallel_settings().threshold;
+    }
+
+    // Shared pool sized by set_num_threads, created on first use. The caller shares ownership,
+    // so a concurrent set_num_threads cannot destroy the pool while it is still running a batch.
+    inline std::shared_ptr<ThreadPool> default_thread_pool() {
+        auto& settings = detail::parallel_settings();
+        std::lock_guard<std::mutex> lock(settings.mutex);
+        if (!settings.pool) {
+            settings.pool = std::make_shared<ThreadPool>(settings.threads.load());
+        }
+        return settings.pool;
+    }
+
+    // Split [begin, end) into blocks of `grain` indices and call func(block_begin, block_end) for each.
+    // The blocks depend only on the range and grain, never on the thread count, and callers write
+    // disjoint outputs per block, so results are identical for any number of threads.
+    // Work estimated below the parallel threshold runs as one call on the calling thread.
+    template<typename Func>
+    void parallel_for(std::size_t begin, std::size_t end, std::size_t grain, double work, Func&& func) {
+        if (begin >= end) {
+            return;
+        }
+        grain = std::max<std::size_t>(grain, 1);
+        const std::size_t blocks = (end - begin + grain - 1) / grain;
+        if (blocks == 1 || get_num_threads() <= 1 || work < static_cast<double>(get_parallel_threshold())
+            || detail::inside_pool_worker()) {
+            func(begin, end);
+            return;
+        }
+        default_thread_pool()->run(blocks, [&](std::size_t block) {
+            const std::size_t first = begin + block * grain;
+            func(first, std::min(end, first + grain));
+        });
+    }
+
+}
+
+#endif
@@ -0,0 +1,250 @@
+//Contains implementation for the opt-in operation profiler (call counts, time, FLOPs and bytes per operation and shape)
+
+#ifndef PROFILE_HPP
+#define PROFILE_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+// The operators in matrix.hpp, vector.hpp and auto_differentiation.hpp are instrumented with
+// LINEAR_ALGEBRA_PROFILE_OP. Unless LINEAR_ALGEBRA_PROFILE is defined before the first include
+// the macro expands to nothing, its arguments are never evaluated and there is no cost at all.
+// With it defined every instrumented call is timed and recorded in Profiler::instance().
+#if defined(LINEAR_ALGEBRA_PROFILE)
+#define LINEAR_ALGEBRA_PROFILE_CONCAT_IMPL(a, b) a##b
+#define LINEAR_ALGEBRA_PROFILE_CONCAT(a, b) LINEAR_ALGEBRA_PROFILE_CONCAT_IMPL(a, b)
+#define LINEAR_ALGEBRA_PROFILE_OP(name, rows, cols, flops, bytes) \
+    const ::linear_algebra::detail::ProfileScope LINEAR_ALGEBRA_PROFILE_CONCAT(profile_scope_, __LINE__)(name, rows, cols, flops, bytes)
+#else
+#define LINEAR_ALGEBRA_PROFILE_OP(name, rows, cols, flops, bytes) static_cast<void>(0)
+#endif
+
+namespace linear_algebra {
+
+    struct OperationProfile {
+        std::string name;
+        long long rows = 0;
+        long long cols = 0;
+        std::size_t calls = 0;
+        double seconds = 0.0;        // inclusive wall time, nested operations are counted in both
+        double min_seconds = 0.0;
+        double max_seconds = 0.0;
+        double flops = 0.0;
+        double bytes = 0.0;          // compulsory traffic: operands read plus results written
+    };
+
+    // Process-wide registry of profiled calls. Totals are kept per (operation, shape); the
+    // individual calls are additionally kept as trace events when tracing is enabled.
+    class Profiler {
+    public:
+        static Profiler& instance() {
+            static Profiler profiler;
+            return profiler;
+        }
+
+        void record(const char* name, long long rows, long long cols, double flops, double bytes,
+                    std::int64_t start_ns, std::int64_t end_ns);
+
+        // Per-call events for write_chrome_trace; off by default since they grow with every call
+        void set_trace_enabled(bool enabled, std::size_t max_events = std::size_t(1) << 20);
+
+        // Totals sorted by descending time
+        std::vector<OperationProfile> summary() const;
+
+        // Fixed-width table of summary() with GFLOP/s and GB/s
+        void write_summary(std::ostream& os) const;
+
+        // Chrome trace event format, loadable in chrome://tracing or Perfetto
+        void write_chrome_trace(std::ostream& os) const;
+
+        void reset();
+
+        // Trace events dropped after max_events was reached
+        std::size_t dropped_events() const;
+
+        static std::int64_t now_ns() {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+    private:
+        Profiler() : epoch_ns(now_ns()) {}
+
+        struct Totals {
+            std::size_t calls = 0;
+            std::int64_t total_ns = 0;
+            std::int64_t min_ns = 0;
+            std::int64_t max_ns = 0;
+            double flops = 0.0;
+            double bytes = 0.0;
+        };
+
+        struct Event {
+            const char* name;
+            long long rows;
+            long long cols;
+            std::int64_t start_ns;
+            std::int64_t duration_ns;
+            std::size_t thread;
+        };
+
+        mutable std::mutex mutex;
+        // Keyed by the name literal's address, which is cheap to hash; summary() merges
+        // equal names that ended up with distinct addresses in different translation units
+        std::map<std::tuple<const char*, long long, long long>, Totals> totals;
+        std::vector<Event> events;
+        bool trace = false;
+        std::size_t max_events = 0;
+        std::size_t dropped = 0;
+        std::int64_t epoch_ns;
+    };
+
+    inline void Profiler::record(const char* name, long long rows, long long cols, double flops, double bytes,
+                                 std::int64_t start_ns, std::int64_t end_ns) {
+        const std::int64_t duration = end_ns - start_ns;
+        std::lock_guard<std::mutex> lock(mutex);
+        Totals& t = totals[{name, rows, cols}];
+        t.min_ns = t.calls == 0 ? duration : std::min(t.min_ns, duration);
+        t.max_ns = std::max(t.max_ns, duration);
+        ++t.calls;
+        t.total_ns += duration;
+        t.flops += flops;
+        t.bytes += bytes;
+        if (trace) {
+            if (events.size() < max_events) {
+                events.push_back({name, rows, cols, start_ns, duration, std::hash<std::thread::id>{}(std::this_thread::get_id())});
+            } else {
+                ++dropped;
+            }
+        }
+    }
+
+    inline void Profiler::set_trace_enabled(bool enabled, std::size_t max_events) {
+        std::lock_guard<std::mutex> lock(mutex);
+        trace = enabled;
+        this->max_events = max_events;
+    }
+
+    inline std::vector<OperationProfile> Profiler::summary() const {
+        std::map<std::tuple<std::string, long long, long long>, OperationProfile> merged;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const auto& [key, t] : totals) {
+                const auto& [name, rows, cols] = key;
+                OperationProfile& p = merged[{name, rows, cols}];
+                p.min_seconds = p.calls == 0 ? t.min_ns * 1e-9 : std::min(p.min_seconds, t.min_ns * 1e-9);
+                p.max_seconds = std::max(p.max_seconds, t.max_ns * 1e-9);
+                p.name = name;
+                p.rows = rows;
+                p.cols = cols;
+                p.calls += t.calls;
+                p.seconds += t.total_ns * 1e-9;
+                p.flops += t.flops;
+                p.bytes += t.bytes;
+            }
+        }
+        std::vector<OperationProfile> result;
+        result.reserve(merged.size());
+        for (auto& entry : merged) {
+            result.push_back(std::move(entry.second));
+        }
+        std::sort(result.begin(), result.end(), [](const OperationProfile& a, const OperationProfile& b) { return a.seconds > b.seconds; });
+        return result;
+    }
+
+    inline void Profiler::write_summary(std::ostream& os) const {
+        const std::vector<OperationProfile> profiles = summary();
+        const std::ios_base::fmtflags flags = os.flags();
+        const std::streamsize precision = os.precision();
+        os << std::left << std::setw(22) << "operation" << std::setw(12) << "shape" << std::right << std::setw(10) << "calls"
+           << std::setw(14) << "total ms" << std::setw(14) << "mean us" << std::setw(12) << "GFLOP/s" << std::setw(10) << "GB/s" << '\n';
+        for (const OperationProfile& p : profiles) {
+            const std::string shape = std::to_string(p.rows) + "x" + std::to_string(p.cols);
+            const double mean = p.seconds / static_cast<double>(p.calls);
+            os << std::left << std::setw(22) << p.name << std::setw(12) << shape << std::right << std::setw(10) << p.calls
+               << std::fixed << std::setprecision(3) << std::setw(14) << p.seconds * 1e3 << std::setw(14) << mean * 1e6
+               << std::setprecision(2) << std::setw(12) << (p.seconds > 0 ? p.flops / p.seconds * 1e-9 : 0.0)
+               << std::setw(10) << (p.seconds > 0 ? p.bytes / p.seconds * 1e-9 : 0.0) << '\n';
+        }
+        os.flags(flags);
+        os.precision(precision);
+    }
+
+    inline void Profiler::write_chrome_trace(std::ostream& os) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        // Thread ids are hashed to arbitrary values; number them in order of first appearance
+        std::map<std::size_t, std::size_t> thread_numbers;
+        os << "{\"traceEvents\":[";
+        for (std::size_t i = 0; i < events.size(); ++i) {
+            const Event& e = events[i];
+            const std::size_t tid = thread_numbers.try_emplace(e.thread, thread_numbers.size()).first->second;
+            os << (i == 0 ? "\n" : ",\n")
+               << "{\"name\":\"" << e.name << "\",\"cat\":\"linear_algebra\",\"ph\":\"X\",\"pid\":0,\"tid\":" << tid
+               << ",\"ts\":" << static_cast<double>(e.start_ns - epoch_ns) * 1e-3
+               << ",\"dur\":" << static_cast<double>(e.duration_ns) * 1e-3
+               << ",\"args\":{\"rows\":" << e.rows << ",\"cols\":" << e.cols << "}}";
+        }
+        os << "\n],\"displayTimeUnit\":\"ns\"}\n";
+    }
+
+    inline void Profiler::reset() {
+        std::lock_guard<std::mutex> lock(mutex);
+        totals.clear();
+        events.clear();
+        dropped = 0;
+    }
+
+    inline std::size_t Profiler::dropped_events() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return dropped;
+    }
+
+    namespace detail {
+
+        // Times its own lifetime and records it on destruction. A literal type, so it can sit in
+        // constexpr functions; nothing is recorded during constant evaluation.
+        class ProfileScope {
+        public:
+            template<typename R, typename C, typename F, typename B>
+            constexpr ProfileScope(const char* name, R rows, C cols, F flops, B bytes)
+                : name(name), rows(static_cast<long long>(rows)), cols(static_cast<long long>(cols)),
+                  flops(static_cast<double>(flops)), bytes(static_cast<double>(bytes)), start_ns(0) {
+                if (!std::is_constant_evaluated()) {
+                    start_ns = Profiler::now_ns();
+                }
+            }
+
+            ProfileScope(const ProfileScope&) = delete;
+            ProfileScope& operator=(const ProfileScope&) = delete;
+
+            constexpr ~ProfileScope() {
+                if (!std::is_constant_evaluated()) {
+                    Profiler::instance().record(name, rows, cols, flops, bytes, start_ns, Profiler::now_ns());
+                }
+            }
+
+        private:
+            const char* name;
+            long long rows;
+            long long cols;
+            double flops;
+            double bytes;
+            std::int64_t start_ns;
+        };
+
+    }
+
+}
+
+#endif
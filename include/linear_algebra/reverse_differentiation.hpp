@@ -0,0 +1,310 @@
+//Contains implementation for reverse-mode automatic differentiation on a tape
+
+#ifndef REVERSE_DIFFERENTIATION_HPP
+#define REVERSE_DIFFERENTIATION_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace linear_algebra {
+
+    template <typename T>
+    class ReverseVariable;
+
+    // Wengert list of the operations of one evaluation. Every node records the indices of its
+    // arguments and the local partial derivative with respect to each, so a single backward
+    // sweep from an output yields the derivative with respect to every input.
+    // Nodes, argument indices and partials live in three flat arrays used as an arena:
+    // recording never allocates per node, and clear() rewinds the tape but keeps its memory
+    // for the next evaluation.
+    template <typename T>
+    class Tape {
+    public:
+        Tape() = default;
+
+        // Nodes refer to the tape by address
+        Tape(const Tape&) = delete;
+        Tape& operator=(const Tape&) = delete;
+
+        // Reserve room for a number of nodes and of argument entries across them
+        void reserve(std::size_t nodes, std::size_t arguments);
+
+        // Register an independent input
+        ReverseVariable<T> variable(const T& value);
+
+        std::size_t size() const { return nodes.size(); }
+
+        // Forget every recorded node, keeping the allocated storage
+        void clear();
+
+        // Backward sweep: adjoint of every node with respect to output, indexed by node
+        std::vector<T> gradient(const ReverseVariable<T>& output) const;
+
+        // Record a node with n arguments, with partials[i] = d(node) / d(args[i])
+        std::size_t record(const std::size_t* args, const T* partials, std::size_t n);
+
+    private:
+        struct Node {
+            std::size_t first_argument;
+            std::size_t argument_count;
+        };
+
+        std::vector<Node> nodes;
+        std::vector<std::size_t> arguments;
+        std::vector<T> partials;
+    };
+
+    // Value recorded on a tape. Arithmetic between variables appends nodes to their tape;
+    // plain scalars act as constants and record nothing of their own.
+    template <typename T>
+    class ReverseVariable {
+    public:
+        ReverseVariable(Tape<T>& tape, std::size_t index, const T& value)
+            : tape(&tape), index(index), value(value) {}
+
+        T getValue() const { return value; }
+        std::size_t getIndex() const { return index; }
+        Tape<T>& getTape() const { return *tape; }
+
+        // Derivative of this variable in a gradient computed by Tape::gradient
+        T getAdjoint(const std::vector<T>& adjoints) const { return adjoints[index]; }
+
+    private:
+        Tape<T>* tape;
+        std::size_t index;
+        T value;
+    };
+
+    template <typename T>
+    void Tape<T>::reserve(std::size_t node_count, std::size_t argument_count) {
+        nodes.reserve(node_count);
+        arguments.reserve(argument_count);
+        partials.reserve(argument_count);
+    }
+
+    template <typename T>
+    ReverseVariable<T> Tape<T>::variable(const T& value) {
+        return ReverseVariable<T>(*this, record(nullptr, nullptr, 0), value);
+    }
+
+    template <typename T>
+    void Tape<T>::clear() {
+        nodes.clear();
+        arguments.clear();
+        partials.clear();
+    }
+
+    template <typename T>
+    std::size_t Tape<T>::record(const std::size_t* args, const T* local_partials, std::size_t n) {
+        nodes.push_back(Node{arguments.size(), n});
+        arguments.insert(arguments.end(), args, args + n);
+        partials.insert(partials.end(), local_partials, local_partials + n);
+        return nodes.size() - 1;
+    }
+
+    template <typename T>
+    std::vector<T> Tape<T>::gradient(const ReverseVariable<T>& output) const {
+        if (&output.getTape() != this || output.getIndex() >= nodes.size()) {
+            throw std::invalid_argument("Variable was not recorded on this tape");
+        }
+        std::vector<T> adjoints(nodes.size(), T(0));
+        adjoints[output.getIndex()] = T(1);
+        // Nodes are recorded after their arguments, so one reverse pass visits every node
+        // after all of its uses
+        for (std::size_t i = output.getIndex() + 1; i-- > 0;) {
+            const T adjoint = adjoints[i];
+            if (adjoint == T(0)) {
+                continue;
+            }
+            const Node& node = nodes[i];
+            for (std::size_t a = 0; a < node.argument_count; ++a) {
+                adjoints[arguments[node.first_argument + a]] += adjoint * partials[node.first_argument + a];
+            }
+        }
+        return adjoints;
+    }
+
+    namespace detail {
+
+        template <typename T>
+        void check_same_tape(const ReverseVariable<T>& lhs, const ReverseVariable<T>& rhs) {
+            if (&lhs.getTape() != &rhs.getTape()) {
+                throw std::invalid_argument("Variables belong to different tapes");
+            }
+        }
+
+        template <typename T>
+        ReverseVariable<T> unary_node(const ReverseVariable<T>& x, const T& value, const T& partial) {
+            const std::size_t arg = x.getIndex();
+            return ReverseVariable<T>(x.getTape(), x.getTape().record(&arg, &partial, 1), value);
+        }
+
+        template <typename T>
+        ReverseVariable<T> binary_node(const ReverseVariable<T>& lhs, const ReverseVariable<T>& rhs, const T& value,
+                                       const T& lhs_partial, const T& rhs_partial) {
+            check_same_tape(lhs, rhs);
+            const std::size_t args[2] = {lhs.getIndex(), rhs.getIndex()};
+            const T local[2] = {lhs_partial, rhs_partial};
+            return ReverseVariable<T>(lhs.getTape(), lhs.getTape().record(args, local, 2), value);
+        }
+
+    }
+
+    // Overloaded arithmetic operations for ReverseVariable
+    template <typename T>
+    ReverseVariable<T> operator+(const ReverseVariable<T>& lhs, const ReverseVariable<T>& rhs) {
+        return detail::binary_node(lhs, rhs, lhs.getValue() + rhs.getValue(), T(1), T(1));
+    }
+
+    template <typename T>
+    ReverseVariable<T> operator-(const ReverseVariable<T>& lhs, const ReverseVariable<T>& rhs) {
+        return detail::binary_node(lhs, rhs, lhs.getValue() - rhs.getValue(), T(1), T(-1));
+    }
+
+    template <typename T>
+    ReverseVariable<T> operator*(const ReverseVariable<T>& lhs, const ReverseVariable<T>& rhs) {
+        return detail::binary_node(lhs, rhs, lhs.getValue() * rhs.getValue(), rhs.getValue(), lhs.getValue());
+    }
+
+    template <typename T>
+    ReverseVariable<T> operator/(const ReverseVariable<T>& lhs, const ReverseVariable<T>& rhs) {
+        const T inv = T(1) / rhs.getValue();
+        return detail::binary_node(lhs, rhs, lhs.getValue() * inv, inv, -lhs.getValue() * inv * inv);
+    }
+
+    template <typename T>
+    ReverseVariable<T> operator-(const ReverseVariable<T>& x) {
+        return detail::unary_node(x, -x.getValue(), T(-1));
+    }
+
+    // Mixed operations with constants
+    template <typename T>
+    ReverseVariable<T> operator+(const ReverseVariable<T>& lhs, const std::type_identity_t<T>& rhs) {
+        return detail::unary_node(lhs, lhs.getValue() + rhs, T(1));
+    }
+
+    template <typename T>
+    ReverseVariable<T> operator+(const std::type_identity_t<T>& lhs, const ReverseVariable<T>& rhs) {
+        return rhs + lhs;
+    }
+
+    template <typename T>
+    ReverseVariable<T> operator-(const ReverseVariable<T>& lhs, const std::type_identity_t<T>& rhs) {
+        return detail::unary_node(lhs, lhs.getValue() - rhs, T(1));
+    }
+
+    template <typename T>
+    ReverseVariable<T> operator-(const std::type_identity_t<T>& lhs, const ReverseVariable<T>& rhs) {
+        return detail::unary_node(rhs, lhs - rhs.getValue(), T(-1));
+    }
+
+    template <typename T>
+    ReverseVariable<T> operator*(const ReverseVariable<T>& lhs, const std::type_identity_t<T>& rhs) {
+        return detail::unary_node(lhs, lhs.getValue() * rhs, rhs);
+    }
+
+    template <typename T>
+    ReverseVariable<T> operator*(const std::type_identity_t<T>& lhs, const ReverseVariable<T>& rhs) {
+        return rhs * lhs;
+    }
+
+    template <typename T>
+    ReverseVariable<T> operator/(const ReverseVariable<T>& lhs, const std::type_identity_t<T>& rhs) {
+        return detail::unary_node(lhs, lhs.getValue() / rhs, T(1) / rhs);
+    }
+
+    template <typename T>
+    ReverseVariable<T> operator/(const std::type_identity_t<T>& lhs, const ReverseVariable<T>& rhs) {
+        const T inv = T(1) / rhs.getValue();
+        return detail::unary_node(rhs, lhs * inv, -lhs * inv * inv);
+    }
+
+    // Elementary functions with reverse-mode support
+    template <typename T>
+    ReverseVariable<T> exp(const ReverseVariable<T>& x) {
+        const T value = std::exp(x.getValue());
+        return detail::unary_node(x, value, value);
+    }
+
+    template <typename T>
+    ReverseVariable<T> log(const ReverseVariable<T>& x) {
+        return detail::unary_node(x, std::log(x.getValue()), T(1) / x.getValue());
+    }
+
+    template <typename T>
+    ReverseVariable<T> sin(const ReverseVariable<T>& x) {
+        return detail::unary_node(x, std::sin(x.getValue()), std::cos(x.getValue()));
+    }
+
+    template <typename T>
+    ReverseVariable<T> cos(const ReverseVariable<T>& x) {
+        return detail::unary_node(x, std::cos(x.getValue()), -std::sin(x.getValue()));
+    }
+
+    template <typename T>
+    ReverseVariable<T> sqrt(const ReverseVariable<T>& x) {
+        const T value = std::sqrt(x.getValue());
+        return detail::unary_node(x, value, T(0.5) / value);
+    }
+
+    template <typename T>
+    ReverseVariable<T> pow(const ReverseVariable<T>& x, const std::type_identity_t<T>& exponent) {
+        return detail::unary_node(x, std::pow(x.getValue(), exponent), exponent * std::pow(x.getValue(), exponent - T(1)));
+    }
+
+    // Sum of many variables as a single n-ary node rather than a chain of binary ones
+    template <typename T>
+    ReverseVariable<T> sum(const std::vector<ReverseVariable<T>>& terms) {
+        if (terms.empty()) {
+            throw std::invalid_argument("Sum of an empty set of variables");
+        }
+        Tape<T>& tape = terms.front().getTape();
+        std::vector<std::size_t> args;
+        args.reserve(terms.size());
+        T value = T(0);
+        for (const auto& term : terms) {
+            detail::check_same_tape(terms.front(), term);
+            args.push_back(term.getIndex());
+            value += term.getValue();
+        }
+        const std::vector<T> ones(terms.size(), T(1));
+        return ReverseVariable<T>(tape, tape.record(args.data(), ones.data(), args.size()), value);
+    }
+
+    // Variadic form of the n-ary sum
+    template <typename T, typename... Args>
+    ReverseVariable<T> sum(const ReverseVariable<T>& first, const Args&... rest) {
+        return sum(std::vector<ReverseVariable<T>>{first, rest...});
+    }
+
+    // Dot product of two equally long lists of variables as a single n-ary node
+    template <typename T>
+    ReverseVariable<T> dot(const std::vector<ReverseVariable<T>>& lhs, const std::vector<ReverseVariable<T>>& rhs) {
+        if (lhs.empty() || lhs.size() != rhs.size()) {
+            throw std::invalid_argument("Dot product needs two non-empty lists of equal length");
+        }
+        Tape<T>& tape = lhs.front().getTape();
+        std::vector<std::size_t> args;
+        std::vector<T> local;
+        args.reserve(2 * lhs.size());
+        local.reserve(2 * lhs.size());
+        T value = T(0);
+        for (std::size_t i = 0; i < lhs.size(); ++i) {
+            detail::check_same_tape(lhs.front(), lhs[i]);
+            detail::check_same_tape(lhs.front(), rhs[i]);
+            args.push_back(lhs[i].getIndex());
+            local.push_back(rhs[i].getValue());
+            args.push_back(rhs[i].getIndex());
+            local.push_back(lhs[i].getValue());
+            value += lhs[i].getValue() * rhs[i].getValue();
+        }
+        return ReverseVariable<T>(tape, tape.record(args.data(), local.data(), args.size()), value);
+    }
+
+}
+
+#endif
@@ -0,0 +1,452 @@
+//Contains implementation for SIMD element-wise and reduction kernels with runtime CPU dispatch
+
+#ifndef SIMD_HPP
+#define SIMD_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__)) && !defined(LINEAR_ALGEBRA_NO_SIMD)
+#define LINEAR_ALGEBRA_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace linear_algebra {
+
+    // Instruction sets the kernels can be dispatched to, in increasing order of width
+    enum class SimdLevel { Scalar, SSE, AVX2, AVX512 };
+
+    namespace detail::simd {
+
+        // Widest instruction set supported by the running CPU (and OS), detected once
+        inline SimdLevel detect_level() {
+#if defined(LINEAR_ALGEBRA_X86_SIMD)
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f")) {
+                return SimdLevel::AVX512;
+            }
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+                return SimdLevel::AVX2;
+            }
+            return SimdLevel::SSE;
+#else
+            return SimdLevel::Scalar;
+#endif
+        }
+
+        // Read by every kernel call, possibly on pool workers while set_simd_level writes it.
+        // Relaxed ordering is enough: each call only needs some valid level.
+        inline std::atomic<SimdLevel>& active_level() {
+            static std::atomic<SimdLevel> level{detect_level()};
+            return level;
+        }
+
+        // Arrays shorter than this skip the dispatch and use an inline loop
+        inline constexpr std::size_t dispatch_threshold = 16;
+
+        template<typename T>
+        inline constexpr bool is_simd_type = std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+        // Portable kernels. The dot product keeps four independent accumulators so the
+        // additions are not serialized on one register, as a vector unit would.
+        template<typename T>
+        constexpr T dot_scalar(const T* a, const T* b, std::size_t n) {
+            T acc0 = T(), acc1 = T(), acc2 = T(), acc3 = T();
+            // The tail bound is computed up front so the remainder loop visibly runs fewer than
+            // four times; GCC cannot see that from i + 4 <= n when n is a constant
+            const std::size_t body = n - n % 4;
+            std::size_t i = 0;
+            for (; i < body; i += 4) {
+                acc0 += a[i] * b[i];
+                acc1 += a[i + 1] * b[i + 1];
+                acc2 += a[i + 2] * b[i + 2];
+                acc3 += a[i + 3] * b[i + 3];
+            }
+            for (; i < n; ++i) {
+                acc0 += a[i] * b[i];
+            }
+            return (acc0 + acc1) + (acc2 + acc3);
+        }
+
+        template<typename T, typename Op>
+        constexpr void binary_scalar(T* dst, const T* a, const T* b, std::size_t n, Op op) {
+            for (std::size_t i = 0; i < n; ++i) {
+                dst[i] = op(a[i], b[i]);
+            }
+        }
+
+        template<typename T>
+        constexpr void scale_scalar(T* dst, const T* a, T s, std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) {
+                dst[i] = a[i] * s;
+            }
+        }
+
+        struct add_op {
+            template<typename T>
+            constexpr T operator()(const T& a, const T& b) const { return a + b; }
+        };
+
+        struct sub_op {
+            template<typename T>
+            constexpr T operator()(const T& a, const T& b) const { return a - b; }
+        };
+
+        struct mul_op {
+            template<typename T>
+            constexpr T operator()(const T& a, const T& b) const { return a * b; }
+        };
+
+#if defined(LINEAR_ALGEBRA_X86_SIMD)
+
+        // Each instruction set gets a register traits struct per element type, compiled for that target
+        // so the intrinsics inline.
+
+        namespace sse {
+
+            struct f32 {
+                using reg = __m128;
+                static constexpr std::size_t width = 4;
+                static reg load(const float* p) { return _mm_loadu_ps(p); }
+                static void store(float* p, reg v) { _mm_storeu_ps(p, v); }
+                static reg set1(float s) { return _mm_set1_ps(s); }
+                static reg zero() { return _mm_setzero_ps(); }
+                static reg add(reg a, reg b) { return _mm_add_ps(a, b); }
+                static reg sub(reg a, reg b) { return _mm_sub_ps(a, b); }
+                static reg mul(reg a, reg b) { return _mm_mul_ps(a, b); }
+                static reg fmadd(reg a, reg b, reg c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+                static float reduce(reg v) {
+                    __m128 sums = _mm_add_ps(v, _mm_movehl_ps(v, v));
+                    sums = _mm_add_ss(sums, _mm_shuffle_ps(sums, sums, 1));
+                    return _mm_cvtss_f32(sums);
+                }
+            };
+
+            struct f64 {
+                using reg = __m128d;
+                static constexpr std::size_t width = 2;
+                static reg load(const double* p) { return _mm_loadu_pd(p); }
+                static void store(double* p, reg v) { _mm_storeu_pd(p, v); }
+                static reg set1(double s) { return _mm_set1_pd(s); }
+                static reg zero() { return _mm_setzero_pd(); }
+                static reg add(reg a, reg b) { return _mm_add_pd(a, b); }
+                static reg sub(reg a, reg b) { return _mm_sub_pd(a, b); }
+                static reg mul(reg a, reg b) { return _mm_mul_pd(a, b); }
+                static reg fmadd(reg a, reg b, reg c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+                static double reduce(reg v) {
+                    return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v)));
+                }
+            };
+
+        }
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2,fma"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#endif
+
+        namespace avx2 {
+
+            struct f32 {
+                using reg = __m256;
+                static constexpr std::size_t width = 8;
+                static reg load(const float* p) { return _mm256_loadu_ps(p); }
+                static void store(float* p, reg v) { _mm256_storeu_ps(p, v); }
+                static reg set1(float s) { return _mm256_set1_ps(s); }
+                static reg zero() { return _mm256_setzero_ps(); }
+                static reg add(reg a, reg b) { return _mm256_add_ps(a, b); }
+                static reg sub(reg a, reg b) { return _mm256_sub_ps(a, b); }
+                static reg mul(reg a, reg b) { return _mm256_mul_ps(a, b); }
+                static reg fmadd(reg a, reg b, reg c) { return _mm256_fmadd_ps(a, b, c); }
+                static float reduce(reg v) {
+                    return sse::f32::reduce(_mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1)));
+                }
+            };
+
+            struct f64 {
+                using reg = __m256d;
+                static constexpr std::size_t width = 4;
+                static reg load(const double* p) { return _mm256_loadu_pd(p); }
+                static void store(double* p, reg v) { _mm256_storeu_pd(p, v); }
+                static reg set1(double s) { return _mm256_set1_pd(s); }
+                static reg zero() { return _mm256_setzero_pd(); }
+                static reg add(reg a, reg b) { return _mm256_add_pd(a, b); }
+                static reg sub(reg a, reg b) { return _mm256_sub_pd(a, b); }
+                static reg mul(reg a, reg b) { return _mm256_mul_pd(a, b); }
+                static reg fmadd(reg a, reg b, reg c) { return _mm256_fmadd_pd(a, b, c); }
+                static double reduce(reg v) {
+                    return sse::f64::reduce(_mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1)));
+                }
+            };
+
+        }
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#pragma clang attribute push(__attribute__((target("avx512f,avx2,fma"))), apply_to = function)
+#else
+#pragma GCC pop_options
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx2,fma")
+#endif
+
+        namespace avx512 {
+
+            struct f32 {
+                using reg = __m512;
+                static constexpr std::size_t width = 16;
+                static reg load(const float* p) { return _mm512_loadu_ps(p); }
+                static void store(float* p, reg v) { _mm512_storeu_ps(p, v); }
+                static reg set1(float s) { return _mm512_set1_ps(s); }
+                static reg zero() { return _mm512_setzero_ps(); }
+                static reg add(reg a, reg b) { return _mm512_add_ps(a, b); }
+                static reg sub(reg a, reg b) { return _mm512_sub_ps(a, b); }
+                static reg mul(reg a, reg b) { return _mm512_mul_ps(a, b); }
+                static reg fmadd(reg a, reg b, reg c) { return _mm512_fmadd_ps(a, b, c); }
+                static float reduce(reg v) {
+                    alignas(64) float lanes[16];
+                    _mm512_store_ps(lanes, v);
+                    return avx2::f32::reduce(_mm256_add_ps(_mm256_load_ps(lanes), _mm256_load_ps(lanes + 8)));
+                }
+            };
+
+            struct f64 {
+                using reg = __m512d;
+                static constexpr std::size_t width = 8;
+                static reg load(const double* p) { return _mm512_loadu_pd(p); }
+                static void store(double* p, reg v) { _mm512_storeu_pd(p, v); }
+                static reg set1(double s) { return _mm512_set1_pd(s); }
+                static reg zero() { return _mm512_setzero_pd(); }
+                static reg add(reg a, reg b) { return _mm512_add_pd(a, b); }
+                static reg sub(reg a, reg b) { return _mm512_sub_pd(a, b); }
+                static reg mul(reg a, reg b) { return _mm512_mul_pd(a, b); }
+                static reg fmadd(reg a, reg b, reg c) { return _mm512_fmadd_pd(a, b, c); }
+                static double reduce(reg v) {
+                    alignas(64) double lanes[8];
+                    _mm512_store_pd(lanes, v);
+                    return avx2::f64::reduce(_mm256_add_pd(_mm256_load_pd(lanes), _mm256_load_pd(lanes + 4)));
+                }
+            };
+
+        }
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+        // Kernels over a register traits struct R. They are always inlined into the per-target entry
+        // points below, which are their only callers, so the vector types never cross an ABI boundary.
+        // Reductions use four independent accumulators to hide the add latency.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+        template<typename R, typename T>
+        __attribute__((always_inline)) inline T dot_kernel(const T* a, const T* b, std::size_t n) {
+            constexpr std::size_t W = R::width;
+            auto acc0 = R::zero(), acc1 = R::zero(), acc2 = R::zero(), acc3 = R::zero();
+            const std::size_t unrolled = n - n % (4 * W);
+            const std::size_t body = n - n % W;
+            std::size_t i = 0;
+            for (; i < unrolled; i += 4 * W) {
+                acc0 = R::fmadd(R::load(a + i), R::load(b + i), acc0);
+                acc1 = R::fmadd(R::load(a + i + W), R::load(b + i + W), acc1);
+                acc2 = R::fmadd(R::load(a + i + 2 * W), R::load(b + i + 2 * W), acc2);
+                acc3 = R::fmadd(R::load(a + i + 3 * W), R::load(b + i + 3 * W), acc3);
+            }
+            for (; i < body; i += W) {
+                acc0 = R::fmadd(R::load(a + i), R::load(b + i), acc0);
+            }
+            T result = R::reduce(R::add(R::add(acc0, acc1), R::add(acc2, acc3)));
+            for (; i < n; ++i) {
+                result += a[i] * b[i];
+            }
+            return result;
+        }
+
+        template<typename R, typename T, typename Op>
+        __attribute__((always_inline)) inline void binary_kernel(T* dst, const T* a, const T* b, std::size_t n, Op op) {
+            constexpr std::size_t W = R::width;
+            const std::size_t body = n - n % W;
+            std::size_t i = 0;
+            for (; i < body; i += W) {
+                if constexpr (std::is_same_v<Op, add_op>) {
+                    R::store(dst + i, R::add(R::load(a + i), R::load(b + i)));
+                } else if constexpr (std::is_same_v<Op, sub_op>) {
+                    R::store(dst + i, R::sub(R::load(a + i), R::load(b + i)));
+                } else {
+                    R::store(dst + i, R::mul(R::load(a + i), R::load(b + i)));
+                }
+            }
+            for (; i < n; ++i) {
+                dst[i] = op(a[i], b[i]);
+            }
+        }
+
+        template<typename R, typename T>
+        __attribute__((always_inline)) inline void scale_kernel(T* dst, const T* a, T s, std::size_t n) {
+            constexpr std::size_t W = R::width;
+            const auto factor = R::set1(s);
+            const std::size_t body = n - n % W;
+            std::size_t i = 0;
+            for (; i < body; i += W) {
+                R::store(dst + i, R::mul(R::load(a + i), factor));
+            }
+            for (; i < n; ++i) {
+                dst[i] = a[i] * s;
+            }
+        }
+
+#pragma GCC diagnostic pop
+
+        // Per-target entry points, each compiled for its own instruction set
+        template<typename T>
+        using simd_traits_sse = std::conditional_t<std::is_same_v<T, float>, sse::f32, sse::f64>;
+
+        template<typename T>
+        using simd_traits_avx2 = std::conditional_t<std::is_same_v<T, float>, avx2::f32, avx2::f64>;
+
+        template<typename T>
+        using simd_traits_avx512 = std::conditional_t<std::is_same_v<T, float>, avx512::f32, avx512::f64>;
+
+        template<typename T>
+        T dot_sse(const T* a, const T* b, std::size_t n) {
+            return dot_kernel<simd_traits_sse<T>>(a, b, n);
+        }
+
+        template<typename T, typename Op>
+        void binary_sse(T* dst, const T* a, const T* b, std::size_t n, Op op) {
+            binary_kernel<simd_traits_sse<T>>(dst, a, b, n, op);
+        }
+
+        template<typename T>
+        void scale_sse(T* dst, const T* a, T s, std::size_t n) {
+            scale_kernel<simd_traits_sse<T>>(dst, a, s, n);
+        }
+
+        template<typename T>
+        __attribute__((target("avx2,fma"))) T dot_avx2(const T* a, const T* b, std::size_t n) {
+            return dot_kernel<simd_traits_avx2<T>>(a, b, n);
+        }
+
+        template<typename T, typename Op>
+        __attribute__((target("avx2,fma"))) void binary_avx2(T* dst, const T* a, const T* b, std::size_t n, Op op) {
+            binary_kernel<simd_traits_avx2<T>>(dst, a, b, n, op);
+        }
+
+        template<typename T>
+        __attribute__((target("avx2,fma"))) void scale_avx2(T* dst, const T* a, T s, std::size_t n) {
+            scale_kernel<simd_traits_avx2<T>>(dst, a, s, n);
+        }
+
+        template<typename T>
+        __attribute__((target("avx512f,avx2,fma"))) T dot_avx512(const T* a, const T* b, std::size_t n) {
+            return dot_kernel<simd_traits_avx512<T>>(a, b, n);
+        }
+
+        template<typename T, typename Op>
+        __attribute__((target("avx512f,avx2,fma"))) void binary_avx512(T* dst, const T* a, const T* b, std::size_t n, Op op) {
+            binary_kernel<simd_traits_avx512<T>>(dst, a, b, n, op);
+        }
+
+        template<typename T>
+        __attribute__((target("avx512f,avx2,fma"))) void scale_avx512(T* dst, const T* a, T s, std::size_t n) {
+            scale_kernel<simd_traits_avx512<T>>(dst, a, s, n);
+        }
+
+#endif
+
+        // Dispatching entry points. Types other than float and double use the portable loops, as does
+        // constant evaluation, so the entry points stay usable in constexpr code.
+
+        template<typename T>
+        constexpr T dot(const T* a, const T* b, std::size_t n) {
+#if defined(LINEAR_ALGEBRA_X86_SIMD)
+            if constexpr (is_simd_type<T>) {
+                if (n >= dispatch_threshold && !std::is_constant_evaluated()) {
+                    switch (active_level().load(std::memory_order_relaxed)) {
+                        case SimdLevel::AVX512: return dot_avx512(a, b, n);
+                        case SimdLevel::AVX2: return dot_avx2(a, b, n);
+                        case SimdLevel::SSE: return dot_sse(a, b, n);
+                        case SimdLevel::Scalar: break;
+                    }
+                }
+            }
+#endif
+            return dot_scalar(a, b, n);
+        }
+
+        template<typename T>
+        constexpr T sum_squares(const T* a, std::size_t n) {
+            return dot(a, a, n);
+        }
+
+        template<typename T, typename Op>
+        constexpr void binary(T* dst, const T* a, const T* b, std::size_t n, Op op) {
+#if defined(LINEAR_ALGEBRA_X86_SIMD)
+            if constexpr (is_simd_type<T>) {
+                if (n >= dispatch_threshold && !std::is_constant_evaluated()) {
+                    switch (active_level().load(std::memory_order_relaxed)) {
+                        case SimdLevel::AVX512: binary_avx512(dst, a, b, n, op); return;
+                        case SimdLevel::AVX2: binary_avx2(dst, a, b, n, op); return;
+                        case SimdLevel::SSE: binary_sse(dst, a, b, n, op); return;
+                        case SimdLevel::Scalar: break;
+                    }
+                }
+            }
+#endif
+            binary_scalar(dst, a, b, n, op);
+        }
+
+        template<typename T>
+        constexpr void add(T* dst, const T* a, const T* b, std::size_t n) {
+            binary(dst, a, b, n, add_op{});
+        }
+
+        template<typename T>
+        constexpr void subtract(T* dst, const T* a, const T* b, std::size_t n) {
+            binary(dst, a, b, n, sub_op{});
+        }
+
+        template<typename T>
+        constexpr void multiply(T* dst, const T* a, const T* b, std::size_t n) {
+            binary(dst, a, b, n, mul_op{});
+        }
+
+        template<typename T>
+        constexpr void scale(T* dst, const T* a, T s, std::size_t n) {
+#if defined(LINEAR_ALGEBRA_X86_SIMD)
+            if constexpr (is_simd_type<T>) {
+                if (n >= dispatch_threshold && !std::is_constant_evaluated()) {
+                    switch (active_level().load(std::memory_order_relaxed)) {
+                        case SimdLevel::AVX512: scale_avx512(dst, a, s, n); return;
+                        case SimdLevel::AVX2: scale_avx2(dst, a, s, n); return;
+                        case SimdLevel::SSE: scale_sse(dst, a, s, n); return;
+                        case SimdLevel::Scalar: break;
+                    }
+                }
+            }
+#endif
+            scale_scalar(dst, a, s, n);
+        }
+
+    }
+
+    // Instruction set the kernels currently dispatch to
+    inline SimdLevel simd_level() {
+        return detail::simd::active_level().load(std::memory_order_relaxed);
+    }
+
+    // Restrict dispatch to a narrower instruction set (e.g. for benchmarking); requests wider
+    // than what the CPU supports are clamped
+    inline void set_simd_level(SimdLevel level) {
+        const SimdLevel supported = detail::simd::detect_level();
+        detail::simd::active_level().store(level > supported ? supported : level, std::memory_order_relaxed);
+    }
+
+}
+
+#endif
@@ -0,0 +1,119 @@
+//Contains implementation for closed-form determinant and inverse kernels of 1x1 to 4x4 matrices
+
+#ifndef SMALL_MATRIX_HPP
+#define SMALL_MATRIX_HPP
+
+namespace linear_algebra {
+
+    namespace detail {
+
+        // Largest size handled by the closed-form kernels
+        constexpr int small_matrix_limit = 4;
+
+        // Closed-form determinant and inverse of one N x N matrix, N <= 4. a(i, j) reads an element
+        // and out(i, j, value) writes one, so the same formulas serve any storage layout: Matrix
+        // calls them on its own storage, the batched kernels inline them into a loop over entries.
+        template<typename T, int N, typename In>
+        constexpr T small_determinant(const In& a) {
+            if constexpr (N == 1) {
+                return a(0, 0);
+            } else if constexpr (N == 2) {
+                return a(0, 0) * a(1, 1) - a(0, 1) * a(1, 0);
+            } else if constexpr (N == 3) {
+                return a(0, 0) * (a(1, 1) * a(2, 2) - a(1, 2) * a(2, 1))
+                     - a(0, 1) * (a(1, 0) * a(2, 2) - a(1, 2) * a(2, 0))
+                     + a(0, 2) * (a(1, 0) * a(2, 1) - a(1, 1) * a(2, 0));
+            } else {
+                static_assert(N == 4, "Closed-form kernels cover sizes up to 4");
+                const T s0 = a(0, 0) * a(1, 1) - a(1, 0) * a(0, 1);
+                const T s1 = a(0, 0) * a(1, 2) - a(1, 0) * a(0, 2);
+                const T s2 = a(0, 0) * a(1, 3) - a(1, 0) * a(0, 3);
+                const T s3 = a(0, 1) * a(1, 2) - a(1, 1) * a(0, 2);
+                const T s4 = a(0, 1) * a(1, 3) - a(1, 1) * a(0, 3);
+                const T s5 = a(0, 2) * a(1, 3) - a(1, 2) * a(0, 3);
+                const T c5 = a(2, 2) * a(3, 3) - a(3, 2) * a(2, 3);
+                const T c4 = a(2, 1) * a(3, 3) - a(3, 1) * a(2, 3);
+                const T c3 = a(2, 1) * a(3, 2) - a(3, 1) * a(2, 2);
+                const T c2 = a(2, 0) * a(3, 3) - a(3, 0) * a(2, 3);
+                const T c1 = a(2, 0) * a(3, 2) - a(3, 0) * a(2, 2);
+                const T c0 = a(2, 0) * a(3, 1) - a(3, 0) * a(2, 1);
+                return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+            }
+        }
+
+        // Writes A^-1 through out and returns det(A); a zero determinant yields non-finite entries
+        template<typename T, int N, typename In, typename Out>
+        constexpr T small_inverse(const In& a, const Out& out) {
+            if constexpr (N == 1) {
+                const T det = a(0, 0);
+                out(0, 0, T(1) / det);
+                return det;
+            } else if constexpr (N == 2) {
+                const T det = a(0, 0) * a(1, 1) - a(0, 1) * a(1, 0);
+                const T inv = T(1) / det;
+                const T a00 = a(0, 0), a01 = a(0, 1), a10 = a(1, 0), a11 = a(1, 1);
+                out(0, 0, a11 * inv);
+                out(0, 1, -a01 * inv);
+                out(1, 0, -a10 * inv);
+                out(1, 1, a00 * inv);
+                return det;
+            } else if constexpr (N == 3) {
+                const T c00 = a(1, 1) * a(2, 2) - a(1, 2) * a(2, 1);
+                const T c01 = a(1, 2) * a(2, 0) - a(1, 0) * a(2, 2);
+                const T c02 = a(1, 0) * a(2, 1) - a(1, 1) * a(2, 0);
+                const T det = a(0, 0) * c00 + a(0, 1) * c01 + a(0, 2) * c02;
+                const T inv = T(1) / det;
+                const T c10 = a(0, 2) * a(2, 1) - a(0, 1) * a(2, 2);
+                const T c11 = a(0, 0) * a(2, 2) - a(0, 2) * a(2, 0);
+                const T c12 = a(0, 1) * a(2, 0) - a(0, 0) * a(2, 1);
+                const T c20 = a(0, 1) * a(1, 2) - a(0, 2) * a(1, 1);
+                const T c21 = a(0, 2) * a(1, 0) - a(0, 0) * a(1, 2);
+                const T c22 = a(0, 0) * a(1, 1) - a(0, 1) * a(1, 0);
+                // The inverse is the transposed cofactor matrix over the determinant
+                out(0, 0, c00 * inv); out(0, 1, c10 * inv); out(0, 2, c20 * inv);
+                out(1, 0, c01 * inv); out(1, 1, c11 * inv); out(1, 2, c21 * inv);
+                out(2, 0, c02 * inv); out(2, 1, c12 * inv); out(2, 2, c22 * inv);
+                return det;
+            } else {
+                static_assert(N == 4, "Closed-form kernels cover sizes up to 4");
+                // 2x2 minors of the top two rows (s) and bottom two rows (c) are shared by
+                // the determinant and all sixteen cofactors
+                const T s0 = a(0, 0) * a(1, 1) - a(1, 0) * a(0, 1);
+                const T s1 = a(0, 0) * a(1, 2) - a(1, 0) * a(0, 2);
+                const T s2 = a(0, 0) * a(1, 3) - a(1, 0) * a(0, 3);
+                const T s3 = a(0, 1) * a(1, 2) - a(1, 1) * a(0, 2);
+                const T s4 = a(0, 1) * a(1, 3) - a(1, 1) * a(0, 3);
+                const T s5 = a(0, 2) * a(1, 3) - a(1, 2) * a(0, 3);
+                const T c5 = a(2, 2) * a(3, 3) - a(3, 2) * a(2, 3);
+                const T c4 = a(2, 1) * a(3, 3) - a(3, 1) * a(2, 3);
+                const T c3 = a(2, 1) * a(3, 2) - a(3, 1) * a(2, 2);
+                const T c2 = a(2, 0) * a(3, 3) - a(3, 0) * a(2, 3);
+                const T c1 = a(2, 0) * a(3, 2) - a(3, 0) * a(2, 2);
+                const T c0 = a(2, 0) * a(3, 1) - a(3, 0) * a(2, 1);
+                const T det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+                const T inv = T(1) / det;
+                out(0, 0, ( a(1, 1) * c5 - a(1, 2) * c4 + a(1, 3) * c3) * inv);
+                out(0, 1, (-a(0, 1) * c5 + a(0, 2) * c4 - a(0, 3) * c3) * inv);
+                out(0, 2, ( a(3, 1) * s5 - a(3, 2) * s4 + a(3, 3) * s3) * inv);
+                out(0, 3, (-a(2, 1) * s5 + a(2, 2) * s4 - a(2, 3) * s3) * inv);
+                out(1, 0, (-a(1, 0) * c5 + a(1, 2) * c2 - a(1, 3) * c1) * inv);
+                out(1, 1, ( a(0, 0) * c5 - a(0, 2) * c2 + a(0, 3) * c1) * inv);
+                out(1, 2, (-a(3, 0) * s5 + a(3, 2) * s2 - a(3, 3) * s1) * inv);
+                out(1, 3, ( a(2, 0) * s5 - a(2, 2) * s2 + a(2, 3) * s1) * inv);
+                out(2, 0, ( a(1, 0) * c4 - a(1, 1) * c2 + a(1, 3) * c0) * inv);
+                out(2, 1, (-a(0, 0) * c4 + a(0, 1) * c2 - a(0, 3) * c0) * inv);
+                out(2, 2, ( a(3, 0) * s4 - a(3, 1) * s2 + a(3, 3) * s0) * inv);
+                out(2, 3, (-a(2, 0) * s4 + a(2, 1) * s2 - a(2, 3) * s0) * inv);
+                out(3, 0, (-a(1, 0) * c3 + a(1, 1) * c1 - a(1, 2) * c0) * inv);
+                out(3, 1, ( a(0, 0) * c3 - a(0, 1) * c1 + a(0, 2) * c0) * inv);
+                out(3, 2, (-a(3, 0) * s3 + a(3, 1) * s1 - a(3, 2) * s0) * inv);
+                out(3, 3, ( a(2, 0) * s3 - a(2, 1) * s1 + a(2, 2) * s0) * inv);
+                return det;
+            }
+        }
+
+    }
+
+}
+
+#endif
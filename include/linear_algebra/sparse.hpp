@@ -0,0 +1,438 @@
+//Contains implementation for sparse matrix formats (COO, CSR, CSC) and their products
+
+#ifndef SPARSE_HPP
+#define SPARSE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "matrix.hpp"
+#include "dynamic_matrix.hpp"
+#include "dynamic_vector.hpp"
+#include "parallel.hpp"
+
+namespace linear_algebra {
+
+    template<typename T>
+    class CsrMatrix;
+
+    template<typename T>
+    class CscMatrix;
+
+    // Coordinate (triplet) format, meant for assembly: entries can be added in any order and
+    // repeated (row, col) pairs are summed when converting to a compressed format
+    template<typename T>
+    class CooMatrix {
+    public:
+        CooMatrix() = default;
+        CooMatrix(std::size_t rows, std::size_t cols) : row_count(rows), col_count(cols) {}
+
+        std::size_t rows() const { return row_count; }
+        std::size_t cols() const { return col_count; }
+
+        // Number of stored triplets, duplicates included
+        std::size_t nonzeros() const { return values.size(); }
+
+        void reserve(std::size_t entries);
+
+        // Add value at (row, col), accumulating onto earlier entries at the same position
+        void add(std::size_t row, std::size_t col, const T& value);
+
+        const std::vector<std::size_t>& row_indices() const { return row_idx; }
+        const std::vector<std::size_t>& col_indices() const { return col_idx; }
+        const std::vector<T>& entries() const { return values; }
+
+    private:
+        std::size_t row_count = 0;
+        std::size_t col_count = 0;
+        std::vector<std::size_t> row_idx;
+        std::vector<std::size_t> col_idx;
+        std::vector<T> values;
+    };
+
+    // Compressed sparse row format. Row i holds the entries col_idx[row_ptr[i] .. row_ptr[i + 1])
+    // with strictly increasing column indices.
+    template<typename T>
+    class CsrMatrix {
+    public:
+        CsrMatrix() = default;
+        CsrMatrix(std::size_t rows, std::size_t cols);
+        CsrMatrix(std::size_t rows, std::size_t cols, std::vector<std::size_t> row_ptr,
+                  std::vector<std::size_t> col_idx, std::vector<T> values);
+
+        // Conversions; explicit zeros of dense sources are dropped
+        explicit CsrMatrix(const CooMatrix<T>& coo);
+
+        template<int Rows, int Cols>
+        explicit CsrMatrix(const Matrix<T, Rows, Cols>& mat);
+
+        explicit CsrMatrix(const DynamicMatrix<T>& mat);
+
+        std::size_t rows() const { return row_count; }
+        std::size_t cols() const { return col_count; }
+        std::size_t nonzeros() const { return values.size(); }
+
+        const std::vector<std::size_t>& row_pointers() const { return row_ptr; }
+        const std::vector<std::size_t>& col_indices() const { return col_idx; }
+        const std::vector<T>& entries() const { return values; }
+
+        // Value at (row, col), zero if it is not stored (binary search within the row)
+        T operator()(std::size_t row, std::size_t col) const;
+
+        // y = A x on raw storage of cols() and rows() elements
+        void multiply(const T* x, T* y) const;
+
+        // Sparse matrix-vector products
+        DynamicVector<T> operator*(const DynamicVector<T>& vec) const;
+
+        template<size_t N>
+        DynamicVector<T> operator*(const Vector<T, N>& vec) const;
+
+        // Sparse-sparse product (Gustavson's row-by-row algorithm)
+        CsrMatrix<T> operator*(const CsrMatrix<T>& other) const;
+
+        CsrMatrix<T> transpose() const;
+
+        DynamicMatrix<T> to_dense() const;
+
+        // Display matrix as (row, col) value triplets
+        void display() const;
+
+    private:
+        std::size_t row_count = 0;
+        std::size_t col_count = 0;
+        std::vector<std::size_t> row_ptr;
+        std::vector<std::size_t> col_idx;
+        std::vector<T> values;
+    };
+
+    // Compressed sparse column format, the transpose layout of CSR: column j holds the entries
+    // row_idx[col_ptr[j] .. col_ptr[j + 1]). Suited to column access and to A^T x products.
+    template<typename T>
+    class CscMatrix {
+    public:
+        CscMatrix() = default;
+        explicit CscMatrix(const CsrMatrix<T>& csr);
+        explicit CscMatrix(const CooMatrix<T>& coo) : CscMatrix(CsrMatrix<T>(coo)) {}
+
+        std::size_t rows() const { return row_count; }
+        std::size_t cols() const { return col_count; }
+        std::size_t nonzeros() const { return values.size(); }
+
+        const std::vector<std::size_t>& col_pointers() const { return col_ptr; }
+        const std::vector<std::size_t>& row_indices() const { return row_idx; }
+        const std::vector<T>& entries() const { return values; }
+
+        // y = A x, scattering each column into the result
+        void multiply(const T* x, T* y) const;
+
+        DynamicVector<T> operator*(const DynamicVector<T>& vec) const;
+
+        CsrMatrix<T> to_csr() const;
+
+        DynamicMatrix<T> to_dense() const { return to_csr().to_dense(); }
+
+    private:
+        std::size_t row_count = 0;
+        std::size_t col_count = 0;
+        std::vector<std::size_t> col_ptr;
+        std::vector<std::size_t> row_idx;
+        std::vector<T> values;
+    };
+
+    namespace detail {
+
+        // Transpose compressed storage: (major, minor) pointers/indices become (minor, major).
+        // A counting sort over the minor index keeps the output indices sorted within each slice.
+        template<typename T>
+        void compressed_transpose(std::size_t major_count, std::size_t minor_count,
+                                  const std::vector<std::size_t>& ptr, const std::vector<std::size_t>& idx, const std::vector<T>& values,
+                                  std::vector<std::size_t>& out_ptr, std::vector<std::size_t>& out_idx, std::vector<T>& out_values) {
+            out_ptr.assign(minor_count + 1, 0);
+            out_idx.resize(idx.size());
+            out_values.resize(values.size());
+            for (std::size_t p = 0; p < idx.size(); ++p) {
+                ++out_ptr[idx[p] + 1];
+            }
+            std::partial_sum(out_ptr.begin(), out_ptr.end(), out_ptr.begin());
+            std::vector<std::size_t> next(out_ptr.begin(), out_ptr.end() - 1);
+            for (std::size_t i = 0; i < major_count; ++i) {
+                for (std::size_t p = ptr[i]; p < ptr[i + 1]; ++p) {
+                    const std::size_t dst = next[idx[p]]++;
+                    out_idx[dst] = i;
+                    out_values[dst] = values[p];
+                }
+            }
+        }
+
+    }
+
+    // COO
+    template<typename T>
+    void CooMatrix<T>::reserve(std::size_t entries) {
+        row_idx.reserve(entries);
+        col_idx.reserve(entries);
+        values.reserve(entries);
+    }
+
+    template<typename T>
+    void CooMatrix<T>::add(std::size_t row, std::size_t col, const T& value) {
+        if (row >= row_count || col >= col_count) {
+            throw std::out_of_range("Sparse entry lies outside the matrix");
+        }
+        row_idx.push_back(row);
+        col_idx.push_back(col);
+        values.push_back(value);
+    }
+
+    // CSR
+    template<typename T>
+    CsrMatrix<T>::CsrMatrix(std::size_t rows, std::size_t cols)
+        : row_count(rows), col_count(cols), row_ptr(rows + 1, 0) {}
+
+    template<typename T>
+    CsrMatrix<T>::CsrMatrix(std::size_t rows, std::size_t cols, std::vector<std::size_t> row_ptr,
+                            std::vector<std::size_t> col_idx, std::vector<T> values)
+        : row_count(rows), col_count(cols), row_ptr(std::move(row_ptr)), col_idx(std::move(col_idx)), values(std::move(values)) {
+        if (this->row_ptr.size() != rows + 1 || this->col_idx.size() != this->values.size() || this->row_ptr.back() != this->values.size()) {
+            throw std::invalid_argument("Inconsistent compressed sparse row arrays");
+        }
+        // Every product indexes x by col_idx and walks the rows by row_ptr, element lookup and ILU(0)
+        // binary-search each row, so the arrays are checked once here
+        if (this->row_ptr.front() != 0 || !std::is_sorted(this->row_ptr.begin(), this->row_ptr.end())) {
+            throw std::invalid_argument("Row pointers must start at zero and be non-decreasing");
+        }
+        for (std::size_t i = 0; i < rows; ++i) {
+            for (std::size_t p = this->row_ptr[i]; p < this->row_ptr[i + 1]; ++p) {
+                if (this->col_idx[p] >= cols) {
+                    throw std::invalid_argument("Sparse column index lies outside the matrix");
+                }
+                if (p > this->row_ptr[i] && this->col_idx[p] <= this->col_idx[p - 1]) {
+                    throw std::invalid_argument("Column indices must be strictly increasing within each row");
+                }
+            }
+        }
+    }
+
+    template<typename T>
+    CsrMatrix<T>::CsrMatrix(const CooMatrix<T>& coo) : row_count(coo.rows()), col_count(coo.cols()) {
+        const auto& rows_in = coo.row_indices();
+        const auto& cols_in = coo.col_indices();
+        const auto& values_in = coo.entries();
+
+        // Counting sort of the triplets by row
+        std::vector<std::size_t> bucket(row_count + 1, 0);
+        for (std::size_t r : rows_in) {
+            ++bucket[r + 1];
+        }
+        std::partial_sum(bucket.begin(), bucket.end(), bucket.begin());
+        std::vector<std::size_t> order(coo.nonzeros());
+        std::vector<std::size_t> next(bucket.begin(), bucket.end() - 1);
+        for (std::size_t p = 0; p < coo.nonzeros(); ++p) {
+            order[next[rows_in[p]]++] = p;
+        }
+
+        // Order each row by column and sum duplicates while compacting; the stable sort keeps
+        // duplicates in insertion order so the sums do not depend on the sort implementation
+        row_ptr.assign(row_count + 1, 0);
+        col_idx.reserve(coo.nonzeros());
+        values.reserve(coo.nonzeros());
+        for (std::size_t i = 0; i < row_count; ++i) {
+            const auto first = order.begin() + bucket[i];
+            const auto last = order.begin() + bucket[i + 1];
+            std::stable_sort(first, last, [&](std::size_t x, std::size_t y) { return cols_in[x] < cols_in[y]; });
+            for (auto it = first; it != last; ++it) {
+                if (col_idx.size() > row_ptr[i] && col_idx.back() == cols_in[*it]) {
+                    values.back() += values_in[*it];
+                } else {
+                    col_idx.push_back(cols_in[*it]);
+                    values.push_back(values_in[*it]);
+                }
+            }
+            row_ptr[i + 1] = col_idx.size();
+        }
+    }
+
+    template<typename T>
+    template<int Rows, int Cols>
+    CsrMatrix<T>::CsrMatrix(const Matrix<T, Rows, Cols>& mat) : row_count(Rows), col_count(Cols), row_ptr(Rows + 1, 0) {
+        for (int i = 0; i < Rows; ++i) {
+            for (int j = 0; j < Cols; ++j) {
+                if (mat(i, j) != T(0)) {
+                    col_idx.push_back(j);
+                    values.push_back(mat(i, j));
+                }
+            }
+            row_ptr[i + 1] = values.size();
+        }
+    }
+
+    template<typename T>
+    CsrMatrix<T>::CsrMatrix(const DynamicMatrix<T>& mat) : row_count(mat.rows()), col_count(mat.cols()), row_ptr(mat.rows() + 1, 0) {
+        for (std::size_t i = 0; i < row_count; ++i) {
+            for (std::size_t j = 0; j < col_count; ++j) {
+                if (mat(i, j) != T(0)) {
+                    col_idx.push_back(j);
+                    values.push_back(mat(i, j));
+                }
+            }
+            row_ptr[i + 1] = values.size();
+        }
+    }
+
+    template<typename T>
+    T CsrMatrix<T>::operator()(std::size_t row, std::size_t col) const {
+        if (row >= row_count || col >= col_count) {
+            throw std::out_of_range("Sparse entry lies outside the matrix");
+        }
+        const auto first = col_idx.begin() + row_ptr[row];
+        const auto last = col_idx.begin() + row_ptr[row + 1];
+        const auto it = std::lower_bound(first, last, col);
+        return it != last && *it == col ? values[it - col_idx.begin()] : T(0);
+    }
+
+    template<typename T>
+    void CsrMatrix<T>::multiply(const T* x, T* y) const {
+        // Rows are independent dot products; the work estimate follows the stored entries
+        parallel_for(0, row_count, 1024, 2.0 * nonzeros(), [&](std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; ++i) {
+                T sum = T(0);
+                for (std::size_t p = row_ptr[i]; p < row_ptr[i + 1]; ++p) {
+                    sum += values[p] * x[col_idx[p]];
+                }
+                y[i] = sum;
+            }
+        });
+    }
+
+    template<typename T>
+    DynamicVector<T> CsrMatrix<T>::operator*(const DynamicVector<T>& vec) const {
+        if (vec.size() != col_count) {
+            throw std::invalid_argument("Number of columns in the matrix must match the size of the vector");
+        }
+        DynamicVector<T> result(row_count);
+        multiply(vec.data_ptr(), result.data_ptr());
+        return result;
+    }
+
+    template<typename T>
+    template<size_t N>
+    DynamicVector<T> CsrMatrix<T>::operator*(const Vector<T, N>& vec) const {
+        if (N != col_count) {
+            throw std::invalid_argument("Number of columns in the matrix must match the size of the vector");
+        }
+        DynamicVector<T> result(row_count);
+        multiply(vec.data_ptr(), result.data_ptr());
+        return result;
+    }
+
+    template<typename T>
+    CsrMatrix<T> CsrMatrix<T>::operator*(const CsrMatrix<T>& other) const {
+        if (col_count != other.row_count) {
+            throw std::invalid_argument("Number of columns in the first matrix must match the number of rows in the second matrix");
+        }
+        // Row i of the product is the combination of the rows of other selected by row i of this.
+        // A dense accumulator indexed by column gathers the sums; marker[j] == i flags column j
+        // as already touched by row i, so no clearing is needed between rows.
+        std::vector<std::size_t> result_ptr(row_count + 1, 0);
+        std::vector<std::size_t> result_idx;
+        std::vector<T> result_values;
+        std::vector<T> accumulator(other.col_count, T(0));
+        std::vector<std::size_t> marker(other.col_count, row_count);
+        std::vector<std::size_t> touched;
+
+        for (std::size_t i = 0; i < row_count; ++i) {
+            touched.clear();
+            for (std::size_t p = row_ptr[i]; p < row_ptr[i + 1]; ++p) {
+                const std::size_t k = col_idx[p];
+                const T a = values[p];
+                for (std::size_t q = other.row_ptr[k]; q < other.row_ptr[k + 1]; ++q) {
+                    const std::size_t j = other.col_idx[q];
+                    if (marker[j] != i) {
+                        marker[j] = i;
+                        accumulator[j] = T(0);
+                        touched.push_back(j);
+                    }
+                    accumulator[j] += a * other.values[q];
+                }
+            }
+            std::sort(touched.begin(), touched.end());
+            for (std::size_t j : touched) {
+                result_idx.push_back(j);
+                result_values.push_back(accumulator[j]);
+            }
+            result_ptr[i + 1] = result_idx.size();
+        }
+        return CsrMatrix<T>(row_count, other.col_count, std::move(result_ptr), std::move(result_idx), std::move(result_values));
+    }
+
+    template<typename T>
+    CsrMatrix<T> CsrMatrix<T>::transpose() const {
+        std::vector<std::size_t> t_ptr, t_idx;
+        std::vector<T> t_values;
+        detail::compressed_transpose(row_count, col_count, row_ptr, col_idx, values, t_ptr, t_idx, t_values);
+        return CsrMatrix<T>(col_count, row_count, std::move(t_ptr), std::move(t_idx), std::move(t_values));
+    }
+
+    template<typename T>
+    DynamicMatrix<T> CsrMatrix<T>::to_dense() const {
+        DynamicMatrix<T> result(row_count, col_count);
+        for (std::size_t i = 0; i < row_count; ++i) {
+            for (std::size_t p = row_ptr[i]; p < row_ptr[i + 1]; ++p) {
+                result(i, col_idx[p]) = values[p];
+            }
+        }
+        return result;
+    }
+
+    template<typename T>
+    void CsrMatrix<T>::display() const {
+        for (std::size_t i = 0; i < row_count; ++i) {
+            for (std::size_t p = row_ptr[i]; p < row_ptr[i + 1]; ++p) {
+                std::cout << "(" << i << ", " << col_idx[p] << ")\t" << values[p] << std::endl;
+            }
+        }
+    }
+
+    // CSC
+    template<typename T>
+    CscMatrix<T>::CscMatrix(const CsrMatrix<T>& csr) : row_count(csr.rows()), col_count(csr.cols()) {
+        detail::compressed_transpose(row_count, col_count, csr.row_pointers(), csr.col_indices(), csr.entries(), col_ptr, row_idx, values);
+    }
+
+    template<typename T>
+    void CscMatrix<T>::multiply(const T* x, T* y) const {
+        std::fill(y, y + row_count, T(0));
+        for (std::size_t j = 0; j < col_count; ++j) {
+            const T xj = x[j];
+            for (std::size_t p = col_ptr[j]; p < col_ptr[j + 1]; ++p) {
+                y[row_idx[p]] += values[p] * xj;
+            }
+        }
+    }
+
+    template<typename T>
+    DynamicVector<T> CscMatrix<T>::operator*(const DynamicVector<T>& vec) const {
+        if (vec.size() != col_count) {
+            throw std::invalid_argument("Number of columns in the matrix must match the size of the vector");
+        }
+        DynamicVector<T> result(row_count);
+        multiply(vec.data_ptr(), result.data_ptr());
+        return result;
+    }
+
+    template<typename T>
+    CsrMatrix<T> CscMatrix<T>::to_csr() const {
+        std::vector<std::size_t> ptr, idx;
+        std::vector<T> csr_values;
+        detail::compressed_transpose(col_count, row_count, col_ptr, row_idx, values, ptr, idx, csr_values);
+        return CsrMatrix<T>(row_count, col_count, std::move(ptr), std::move(idx), std::move(csr_values));
+    }
+
+}
+
+#endif
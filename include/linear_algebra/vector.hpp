@@ -7,36 +7,60 @@
 #include <type_traits> 
 #include <ostream>
 #include <functional>
+#include <stdexcept>
+#include "memory.hpp"
+#include "expression.hpp"
+#include "profile.hpp"
 
 namespace linear_algebra {
 
     template<typename T, size_t N>
-    class Vector {
+    class Vector : public VectorExpression<Vector<T, N>, T, N> {
     public:
         // Constructors
-        Vector();
-        Vector(const T (&arr)[N]);
+        constexpr Vector();
+        constexpr Vector(const T (&arr)[N]);
 
-        // Basic operations
-        Vector<T, N> operator+(const Vector<T, N>& other) const;
-        Vector<T, N> operator-(const Vector<T, N>& other) const;
-        Vector<T, N> operator*(T scalar) const;
+        // Evaluate an element-wise expression (see expression.hpp) in a single pass
+        template<typename E>
+        constexpr Vector(const VectorExpression<E, T, N>& expr);
 
-        T& operator[]( int index) {
+        template<typename E>
+        constexpr Vector<T, N>& operator=(const VectorExpression<E, T, N>& expr);
+
+        // Basic operations (+, -, scalar *) are lazy expressions defined in expression.hpp
+
+        // Compound assignment updates the storage in one pass, without a temporary Vector
+        template<typename E>
+        constexpr Vector<T, N>& operator+=(const VectorExpression<E, T, N>& expr);
+
+        template<typename E>
+        constexpr Vector<T, N>& operator-=(const VectorExpression<E, T, N>& expr);
+
+        constexpr Vector<T, N>& operator*=(const T& scalar);
+        constexpr Vector<T, N>& operator/=(const T& scalar);
+
+        constexpr T& operator[]( int index) {
             return data[index];
         }
 
-        const T& operator[]( int index) const {
+        constexpr const T& operator[]( int index) const {
             return data[index];
         }
-        T dot(const Vector<T, N>& other) const;
+
+        // Contiguous storage, for kernels working on raw memory
+        constexpr T* data_ptr() { return data; }
+        constexpr const T* data_ptr() const { return data; }
+
+        constexpr T dot(const Vector<T, N>& other) const;
 
         // Cross product (for 3D vectors)
         template<typename U = T>
-        Vector<T, 3> cross(const Vector<U, 3>& other) const;
+        constexpr Vector<T, 3> cross(const Vector<U, 3>& other) const;
 
         // Normalization
         Vector<T, N> normalize() const;
+        Vector<T, N>& normalize_in_place();
 
         // Magnitude
         T magnitude() const;
@@ -45,17 +69,15 @@ namespace linear_algebra {
         friend std::ostream& operator<<(std::ostream& os, const Vector<U, S>& vec);
 
         template<typename... Vectors>
-        static Vector<T, N> add(const Vector<T, N>& first, const Vectors&... others);
+        static constexpr Vector<T, N> add(const Vector<T, N>& first, const Vectors&... others);
 
         template <typename... ScalarVectorPairs>
-        static Vector<T, N> linearCombination(const ScalarVectorPairs&... scalarVectorPairs);
+        static constexpr Vector<T, N> linearCombination(const ScalarVectorPairs&... scalarVectorPairs);
 
         auto square() const {
             return [this]<typename U>(Vector<U, N> v) {
                 Vector<U, N> result;
-                for (size_t i = 0; i < N; ++i) {
-                    result[i] = v[i] * v[i];
-                }
+                detail::simd::multiply(result.data_ptr(), v.data_ptr(), v.data_ptr(), N);
                 return result;
             }(*this);
         }
@@ -63,9 +85,8 @@ namespace linear_algebra {
         auto cube() const {
             return [this]<typename U>(Vector<U, N> v) {
                 Vector<U, N> result;
-                for (size_t i = 0; i < N; ++i) {
-                    result[i] = v[i] * v[i] * v[i];
-                }
+                detail::simd::multiply(result.data_ptr(), v.data_ptr(), v.data_ptr(), N);
+                detail::simd::multiply(result.data_ptr(), result.data_ptr(), v.data_ptr(), N);
                 return result;
             }(*this);
         }
@@ -82,20 +103,17 @@ namespace linear_algebra {
     
         
     private:
-        T data[N];
+        alignas(storage_alignment<T, N>) T data[N];
     };
 
     // Constructors
     template<typename T, size_t N>
-    Vector<T, N>::Vector() {
-        // Initialize all elements to zero
-        for (size_t i = 0; i < N; ++i) {
-            data[i] = T();
-        }
+    constexpr Vector<T, N>::Vector() : data{} {
+        // Value-initialized: every element is T(), zero for arithmetic types
     }
 
     template<typename T, size_t N>
-    Vector<T, N>::Vector(const T (&arr)[N]) {
+    constexpr Vector<T, N>::Vector(const T (&arr)[N]) {
         // Copy the array into the vector data
         for (size_t i = 0; i < N; ++i) {
             data[i] = arr[i];
@@ -103,68 +121,93 @@ namespace linear_algebra {
     }
 
     template<typename T, size_t N>
-    template<typename... Vectors>
-    Vector<T, N> Vector<T, N>::add(const Vector<T, N>& first, const Vectors&... others) {
-        Vector<T, N> result = first;
-        (void)std::initializer_list<int>{(result = result + others, 0)...};
-        return result;
+    template<typename E>
+    constexpr Vector<T, N>::Vector(const VectorExpression<E, T, N>& expr) {
+        LINEAR_ALGEBRA_PROFILE_OP("vector_assign", N, 1, 0, N * sizeof(T));
+        detail::assign_expression(data, expr);
     }
 
-    template<typename T, size_t N> 
-     std::ostream& operator<<(std::ostream& os, const Vector<T, N>& vec){
-        os << "(";
-        for (size_t i = 0; i < N; ++i) {
-            os << vec[i];
-            if (i != N - 1) {
-                os << ", ";
-            }
-        }
-        os << ")";
-        return os;
-        }
+    template<typename T, size_t N>
+    template<typename E>
+    constexpr Vector<T, N>& Vector<T, N>::operator=(const VectorExpression<E, T, N>& expr) {
+        LINEAR_ALGEBRA_PROFILE_OP("vector_assign", N, 1, 0, N * sizeof(T));
+        // Element-wise expressions only read index i to produce element i, so aliasing is safe
+        detail::assign_expression(data, expr);
+        return *this;
+    }
 
-    // Basic operations
     template<typename T, size_t N>
-    Vector<T, N> Vector<T, N>::operator+(const Vector<T, N>& other) const {
-        Vector<T, N> result;
-        for (size_t i = 0; i < N; ++i) {
-            result.data[i] = data[i] + other.data[i];
-        }
-        return result;
+    template<typename E>
+    constexpr Vector<T, N>& Vector<T, N>::operator+=(const VectorExpression<E, T, N>& expr) {
+        // v + w over concrete operands is a single SIMD pass with the destination as first source
+        return *this = *this + expr.self();
     }
 
     template<typename T, size_t N>
-    Vector<T, N> Vector<T, N>::operator-(const Vector<T, N>& other) const {
-        Vector<T, N> result;
+    template<typename E>
+    constexpr Vector<T, N>& Vector<T, N>::operator-=(const VectorExpression<E, T, N>& expr) {
+        return *this = *this - expr.self();
+    }
+
+    template<typename T, size_t N>
+    constexpr Vector<T, N>& Vector<T, N>::operator*=(const T& scalar) {
+        return *this = *this * scalar;
+    }
+
+    template<typename T, size_t N>
+    constexpr Vector<T, N>& Vector<T, N>::operator/=(const T& scalar) {
+        if (scalar == T(0)) {
+            throw std::runtime_error("Division by zero");
+        }
         for (size_t i = 0; i < N; ++i) {
-            result.data[i] = data[i] - other.data[i];
+            data[i] /= scalar;
         }
-        return result;
+        return *this;
     }
 
+    // Sum of any number of vectors, fused into one pass over the data
     template<typename T, size_t N>
-    Vector<T, N> Vector<T, N>::operator*(T scalar) const {
+    template<typename... Vectors>
+    constexpr Vector<T, N> Vector<T, N>::add(const Vector<T, N>& first, const Vectors&... others) {
+        LINEAR_ALGEBRA_PROFILE_OP("vector_add", N, 1, sizeof...(Vectors) * N, (sizeof...(Vectors) + 2) * N * sizeof(T));
         Vector<T, N> result;
         for (size_t i = 0; i < N; ++i) {
-            result.data[i] = data[i] * scalar;
+            result.data[i] = (first.data[i] + ... + others[i]);
         }
         return result;
     }
 
-    template<typename T, size_t N>
-    T Vector<T, N>::dot(const Vector<T, N>& other) const {
-        T result = T();
+    template<typename T, size_t N> 
+     std::ostream& operator<<(std::ostream& os, const Vector<T, N>& vec){
+        os << "(";
         for (size_t i = 0; i < N; ++i) {
-            result += data[i] * other.data[i];
+            os << vec[i];
+            if (i != N - 1) {
+                os << ", ";
+            }
         }
-        return result;
+        os << ")";
+        return os;
+        }
+
+    // Unevaluated expressions are printed through a temporary Vector
+    template<typename E, typename T, size_t N>
+    std::ostream& operator<<(std::ostream& os, const VectorExpression<E, T, N>& expr) {
+        return os << expr.eval();
+    }
+
+    template<typename T, size_t N>
+    constexpr T Vector<T, N>::dot(const Vector<T, N>& other) const {
+        LINEAR_ALGEBRA_PROFILE_OP("vector_dot", N, 1, 2 * N, 2 * N * sizeof(T));
+        return detail::simd::dot(data, other.data, N);
     }
 
     // Cross product, specialized only for 3D vectors
     template<typename T, size_t N>
     template<typename U>
-    Vector<T, 3> Vector<T, N>::cross(const Vector<U, 3>& other) const {
+    constexpr Vector<T, 3> Vector<T, N>::cross(const Vector<U, 3>& other) const {
         static_assert(N == 3, "Cross product is only defined for 3D vectors");
+        LINEAR_ALGEBRA_PROFILE_OP("vector_cross", 3, 1, 9, 9 * sizeof(T));
         Vector<T, 3> result;
         result.data[0] = data[1] * other.data[2] - data[2] * other.data[1];
         result.data[1] = data[2] * other.data[0] - data[0] * other.data[2];
@@ -182,32 +225,40 @@ namespace linear_algebra {
         return *this * (T(1) / mag);
     }
 
+    template<typename T, size_t N>
+    Vector<T, N>& Vector<T, N>::normalize_in_place() {
+        T mag = magnitude();
+        if (mag != T(0)) {
+            *this *= T(1) / mag;
+        }
+        return *this;
+    }
+
     // Magnitude
     template<typename T, size_t N>
     T Vector<T, N>::magnitude() const {
-        T sum_sq = T();
-        for (size_t i = 0; i < N; ++i) {
-            sum_sq += data[i] * data[i];
-        }
-        return std::sqrt(sum_sq);
+        LINEAR_ALGEBRA_PROFILE_OP("vector_norm", N, 1, 2 * N, N * sizeof(T));
+        using std::sqrt;
+        return sqrt(detail::simd::sum_squares(data, N));
     }
 
     // Linear combination
     template<typename T, size_t N>
     template <typename... ScalarVectorPairs>
-    Vector<T, N> Vector<T, N>::linearCombination(const ScalarVectorPairs&... scalarVectorPairs) {
+    constexpr Vector<T, N> Vector<T, N>::linearCombination(const ScalarVectorPairs&... scalarVectorPairs) {
+        LINEAR_ALGEBRA_PROFILE_OP("vector_linear_combination", N, 1, sizeof...(ScalarVectorPairs) * N, (sizeof...(ScalarVectorPairs) / 2 + 1) * N * sizeof(T));
         Vector<T, N> result;
         linearCombinationHelper(result, scalarVectorPairs...);
         return result;
     }
 
     template<typename T, size_t N>
-    void linearCombinationHelper(Vector<T, N>& result) {
+    constexpr void linearCombinationHelper(Vector<T, N>& result) {
         // no pairs
     }
 
     template<typename T, size_t N, typename... Rest>
-    void linearCombinationHelper(Vector<T, N>& result, T scalar, const Vector<T, N>& vec, const Rest&... rest) {
+    constexpr void linearCombinationHelper(Vector<T, N>& result, T scalar, const Vector<T, N>& vec, const Rest&... rest) {
         for (size_t i = 0; i < N; ++i) {
             result[i] += scalar * vec[i];
         }
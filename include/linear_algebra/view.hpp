@@ -0,0 +1,328 @@
+//Contains implementation for non-owning strided views over matrices, vectors and external buffers
+
+#ifndef VIEW_HPP
+#define VIEW_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include "simd.hpp"
+#include "gemm.hpp"
+#include "matrix.hpp"
+#include "vector.hpp"
+#include "dynamic_matrix.hpp"
+#include "dynamic_vector.hpp"
+
+namespace linear_algebra {
+
+    // Non-owning view of size elements placed stride apart. T may be const for a read-only view.
+    // Copies are shallow and the viewed memory must outlive the view.
+    template<typename T>
+    class VectorView {
+    public:
+        using value_type = std::remove_const_t<T>;
+
+        VectorView() = default;
+        VectorView(T* data, std::size_t size, std::ptrdiff_t stride = 1) : data(data), count(size), step(stride) {}
+
+        template<size_t N>
+        VectorView(Vector<value_type, N>& vec) : VectorView(vec.data_ptr(), N) {}
+
+        template<size_t N>
+        VectorView(const Vector<value_type, N>& vec) requires std::is_const_v<T> : VectorView(vec.data_ptr(), N) {}
+
+        VectorView(DynamicVector<value_type>& vec) : VectorView(vec.data_ptr(), vec.size()) {}
+
+        VectorView(const DynamicVector<value_type>& vec) requires std::is_const_v<T> : VectorView(vec.data_ptr(), vec.size()) {}
+
+        // A mutable view converts to a read-only one
+        template<typename U>
+        VectorView(const VectorView<U>& other) requires (std::is_same_v<const U, T> && !std::is_same_v<U, T>)
+            : VectorView(other.data_ptr(), other.size(), other.stride()) {}
+
+        std::size_t size() const { return count; }
+        std::ptrdiff_t stride() const { return step; }
+        T* data_ptr() const { return data; }
+
+        // True if the elements are adjacent in memory, so raw-memory kernels apply
+        bool is_contiguous() const { return step == 1; }
+
+        T& operator[](std::size_t index) const { return data[static_cast<std::ptrdiff_t>(index) * step]; }
+
+        // count elements starting at first
+        VectorView segment(std::size_t first, std::size_t count) const;
+
+        // Owning copy of the viewed elements
+        DynamicVector<value_type> eval() const;
+
+    private:
+        T* data = nullptr;
+        std::size_t count = 0;
+        std::ptrdiff_t step = 1;
+    };
+
+    // Non-owning view of a rows x cols matrix whose element (i, j) lives at
+    // data[i * row_stride + j * col_stride]. Row-major storage with a padded leading dimension has
+    // col_stride 1, a transposed view swaps the strides. T may be const for a read-only view.
+    template<typename T>
+    class MatrixView {
+    public:
+        using value_type = std::remove_const_t<T>;
+
+        MatrixView() = default;
+
+        // Contiguous row-major block
+        MatrixView(T* data, std::size_t rows, std::size_t cols)
+            : MatrixView(data, rows, cols, static_cast<std::ptrdiff_t>(cols)) {}
+
+        MatrixView(T* data, std::size_t rows, std::size_t cols, std::ptrdiff_t row_stride, std::ptrdiff_t col_stride = 1)
+            : data(data), row_count(rows), col_count(cols), row_step(row_stride), col_step(col_stride) {}
+
+        template<int Rows, int Cols>
+        MatrixView(Matrix<value_type, Rows, Cols>& mat) : MatrixView(mat.data_ptr(), Rows, Cols) {}
+
+        template<int Rows, int Cols>
+        MatrixView(const Matrix<value_type, Rows, Cols>& mat) requires std::is_const_v<T> : MatrixView(mat.data_ptr(), Rows, Cols) {}
+
+        MatrixView(DynamicMatrix<value_type>& mat) : MatrixView(mat.data_ptr(), mat.rows(), mat.cols()) {}
+
+        MatrixView(const DynamicMatrix<value_type>& mat) requires std::is_const_v<T> : MatrixView(mat.data_ptr(), mat.rows(), mat.cols()) {}
+
+        template<typename U>
+        MatrixView(const MatrixView<U>& other) requires (std::is_same_v<const U, T> && !std::is_same_v<U, T>)
+            : MatrixView(other.data_ptr(), other.rows(), other.cols(), other.row_stride(), other.col_stride()) {}
+
+        std::size_t rows() const { return row_count; }
+        std::size_t cols() const { return col_count; }
+        std::ptrdiff_t row_stride() const { return row_step; }
+        std::ptrdiff_t col_stride() const { return col_step; }
+        T* data_ptr() const { return data; }
+
+        // True if each row is contiguous, so row_stride() is a leading dimension for the raw kernels
+        bool is_row_major() const { return col_step == 1; }
+
+        T& operator()(std::size_t row, std::size_t col) const {
+            return data[static_cast<std::ptrdiff_t>(row) * row_step + static_cast<std::ptrdiff_t>(col) * col_step];
+        }
+
+        // rows x cols sub-block with top-left corner (row, col)
+        MatrixView block(std::size_t row, std::size_t col, std::size_t rows, std::size_t cols) const;
+
+        // The same elements seen as the transpose, no data is moved
+        MatrixView transpose() const { return MatrixView(data, col_count, row_count, col_step, row_step); }
+
+        VectorView<T> row(std::size_t index) const;
+        VectorView<T> col(std::size_t index) const;
+
+        // Owning copy of the viewed elements
+        DynamicMatrix<value_type> eval() const;
+
+    private:
+        T* data = nullptr;
+        std::size_t row_count = 0;
+        std::size_t col_count = 0;
+        std::ptrdiff_t row_step = 0;
+        std::ptrdiff_t col_step = 1;
+    };
+
+    // VectorView
+    template<typename T>
+    VectorView<T> VectorView<T>::segment(std::size_t first, std::size_t count) const {
+        if (first + count > size()) {
+            throw std::invalid_argument("Segment exceeds the viewed vector");
+        }
+        return VectorView(data + static_cast<std::ptrdiff_t>(first) * step, count, step);
+    }
+
+    template<typename T>
+    DynamicVector<typename VectorView<T>::value_type> VectorView<T>::eval() const {
+        DynamicVector<value_type> result(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            result[i] = (*this)[i];
+        }
+        return result;
+    }
+
+    // MatrixView
+    template<typename T>
+    MatrixView<T> MatrixView<T>::block(std::size_t row, std::size_t col, std::size_t rows, std::size_t cols) const {
+        if (row + rows > row_count || col + cols > col_count) {
+            throw std::invalid_argument("Block exceeds the viewed matrix");
+        }
+        return MatrixView(&(*this)(row, col), rows, cols, row_step, col_step);
+    }
+
+    template<typename T>
+    VectorView<T> MatrixView<T>::row(std::size_t index) const {
+        if (index >= row_count) {
+            throw std::invalid_argument("Row index out of range");
+        }
+        return VectorView<T>(data + static_cast<std::ptrdiff_t>(index) * row_step, col_count, col_step);
+    }
+
+    template<typename T>
+    VectorView<T> MatrixView<T>::col(std::size_t index) const {
+        if (index >= col_count) {
+            throw std::invalid_argument("Column index out of range");
+        }
+        return VectorView<T>(data + static_cast<std::ptrdiff_t>(index) * col_step, row_count, row_step);
+    }
+
+    template<typename T>
+    DynamicMatrix<typename MatrixView<T>::value_type> MatrixView<T>::eval() const {
+        DynamicMatrix<value_type> result(row_count, col_count);
+        for (std::size_t i = 0; i < row_count; ++i) {
+            for (std::size_t j = 0; j < col_count; ++j) {
+                result(i, j) = (*this)(i, j);
+            }
+        }
+        return result;
+    }
+
+    namespace detail {
+
+        template<typename A, typename B>
+        void check_same_shape(const MatrixView<A>& a, const MatrixView<B>& b) {
+            if (a.rows() != b.rows() || a.cols() != b.cols()) {
+                throw std::invalid_argument("Matrix dimensions do not match");
+            }
+        }
+
+        template<typename A, typename B>
+        void check_same_shape(const VectorView<A>& a, const VectorView<B>& b) {
+            if (a.size() != b.size()) {
+                throw std::invalid_argument("Vector sizes do not match");
+            }
+        }
+
+        // dst(i, j) = op(a(i, j), b(i, j)); rows that are contiguous in all three views go through
+        // the SIMD kernels, anything else walks the strides
+        template<typename A, typename B, typename D, typename Op>
+        void view_binary(const MatrixView<A>& a, const MatrixView<B>& b, const MatrixView<D>& dst, Op op) {
+            check_same_shape(a, b);
+            check_same_shape(a, dst);
+            const bool rows_contiguous = a.is_row_major() && b.is_row_major() && dst.is_row_major();
+            for (std::size_t i = 0; i < dst.rows(); ++i) {
+                if (rows_contiguous) {
+                    simd::binary(&dst(i, 0), &a(i, 0), &b(i, 0), dst.cols(), op);
+                } else {
+                    for (std::size_t j = 0; j < dst.cols(); ++j) {
+                        dst(i, j) = op(a(i, j), b(i, j));
+                    }
+                }
+            }
+        }
+
+    }
+
+    // Operations on views. Destinations are written in place and must not overlap the sources
+    // unless noted; every element is read through the view, so nothing is copied.
+
+    // dst = src (the views may have different strides, e.g. copy(src.transpose(), dst))
+    template<typename S, typename D>
+    void copy(const MatrixView<S>& src, const MatrixView<D>& dst) {
+        detail::check_same_shape(src, dst);
+        if (src.row_stride() == 1 && src.rows() > 1 && dst.is_row_major()) {
+            // src is a transposed row-major block, use the tiled transpose kernel
+            detail::transpose(static_cast<int>(src.cols()), static_cast<int>(src.rows()), src.data_ptr(), src.col_stride(),
+                              dst.data_ptr(), dst.row_stride());
+            return;
+        }
+        for (std::size_t i = 0; i < dst.rows(); ++i) {
+            for (std::size_t j = 0; j < dst.cols(); ++j) {
+                dst(i, j) = src(i, j);
+            }
+        }
+    }
+
+    template<typename S, typename D>
+    void copy(const VectorView<S>& src, const VectorView<D>& dst) {
+        detail::check_same_shape(src, dst);
+        for (std::size_t i = 0; i < dst.size(); ++i) {
+            dst[i] = src[i];
+        }
+    }
+
+    // dst = a + b, dst = a - b (dst may be a or b)
+    template<typename A, typename B, typename D>
+    void add(const MatrixView<A>& a, const MatrixView<B>& b, const MatrixView<D>& dst) {
+        detail::view_binary(a, b, dst, detail::simd::add_op{});
+    }
+
+    template<typename A, typename B, typename D>
+    void subtract(const MatrixView<A>& a, const MatrixView<B>& b, const MatrixView<D>& dst) {
+        detail::view_binary(a, b, dst, detail::simd::sub_op{});
+    }
+
+    // dst = a * s (dst may be a)
+    template<typename A, typename D>
+    void scale(const MatrixView<A>& a, typename MatrixView<D>::value_type s, const MatrixView<D>& dst) {
+        detail::check_same_shape(a, dst);
+        for (std::size_t i = 0; i < dst.rows(); ++i) {
+            if (a.is_row_major() && dst.is_row_major()) {
+                detail::simd::scale(&dst(i, 0), &a(i, 0), s, dst.cols());
+            } else {
+                for (std::size_t j = 0; j < dst.cols(); ++j) {
+                    dst(i, j) = a(i, j) * s;
+                }
+            }
+        }
+    }
+
+    template<typename A, typename B>
+    typename VectorView<A>::value_type dot(const VectorView<A>& x, const VectorView<B>& y) {
+        detail::check_same_shape(x, y);
+        if (x.is_contiguous() && y.is_contiguous()) {
+            return detail::simd::dot(x.data_ptr(), y.data_ptr(), x.size());
+        }
+        typename VectorView<A>::value_type sum = 0;
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            sum += x[i] * y[i];
+        }
+        return sum;
+    }
+
+    // c = a * b. With a row-major c the packed GEMM kernel reads a and b through any strides, so
+    // transposed views (e.g. multiply(a.transpose(), b, c)) cost no copy; otherwise a loop over the strides.
+    template<typename A, typename B, typename C>
+    void multiply(const MatrixView<A>& a, const MatrixView<B>& b, const MatrixView<C>& c) {
+        if (a.cols() != b.rows() || c.rows() != a.rows() || c.cols() != b.cols()) {
+            throw std::invalid_argument("Number of columns in the first matrix must match the number of rows in the second matrix");
+        }
+        using T = typename MatrixView<C>::value_type;
+        for (std::size_t i = 0; i < c.rows(); ++i) {
+            for (std::size_t j = 0; j < c.cols(); ++j) {
+                c(i, j) = T();
+            }
+        }
+        if (c.is_row_major()) {
+            detail::gemm_strided(static_cast<int>(c.rows()), static_cast<int>(c.cols()), static_cast<int>(a.cols()),
+                                 a.data_ptr(), a.row_stride(), a.col_stride(), b.data_ptr(), b.row_stride(), b.col_stride(),
+                                 c.data_ptr(), c.row_stride());
+            return;
+        }
+        for (std::size_t i = 0; i < c.rows(); ++i) {
+            for (std::size_t p = 0; p < a.cols(); ++p) {
+                const T aip = a(i, p);
+                for (std::size_t j = 0; j < c.cols(); ++j) {
+                    c(i, j) += aip * b(p, j);
+                }
+            }
+        }
+    }
+
+    // y = a * x
+    template<typename A, typename X, typename Y>
+    void multiply(const MatrixView<A>& a, const VectorView<X>& x, const VectorView<Y>& y) {
+        if (a.cols() != x.size() || a.rows() != y.size()) {
+            throw std::invalid_argument("Number of columns in the matrix must match the size of the vector");
+        }
+        for (std::size_t i = 0; i < a.rows(); ++i) {
+            y[i] = dot(a.row(i), x);
+        }
+    }
+
+}
+
+#endif
@@ -1,3 +1,4 @@
+#include <array>
 #include <iostream>
 #include "../include/linear_algebra/auto_differentiation.hpp"
 
@@ -26,5 +27,12 @@ int main() {
     ADVariable<double> f = sum(a, b, c, d, e); // f = x + y + z + w + z = 2 + 3 + 5 + 4 + 5 = 19
     cout << "Test case 4: sum(a, b, c, d, e) = " << f.getValue() << ", df/da = df/db = df/dc = df/dd = df/de = " << f.getDerivative() << endl;
 
+    // Test case 5: Full Jacobian in one pass with two tangent lanes
+    // f(x, y) = (x * y, sin(x) + exp(y)), J = [[y, x], [cos(x), exp(y)]]
+    auto J = jacobian([](const array<ADVariable<double, 2>, 2>& in) {
+        return array<ADVariable<double, 2>, 2>{in[0] * in[1], sin(in[0]) + exp(in[1])};
+    }, array<double, 2>{1.0, 2.0});
+    cout << "Test case 5: Jacobian at (1, 2) = [[" << J[0][0] << ", " << J[0][1] << "], [" << J[1][0] << ", " << J[1][1] << "]]" << endl;
+
     return 0;
 }
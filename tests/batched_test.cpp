@@ -0,0 +1,60 @@
+#include <iostream>
+#include "../include/linear_algebra/batched.hpp"
+
+using namespace linear_algebra;
+
+int main() {
+    // A batch of three 3x3 matrices and 3-vectors in structure-of-arrays layout
+    const std::size_t count = 3;
+    MatrixBatch<double, 3, 3> a(count);
+    VectorBatch<double, 3> x(count);
+    for (std::size_t b = 0; b < count; ++b) {
+        const double s = static_cast<double>(b + 1);
+        a.set(b, Matrix<double, 3, 3>({{2.0 * s, 1.0, 0.0}, {1.0, 3.0, s}, {0.0, s, 4.0}}));
+        x.set(b, Vector<double, 3>({1.0, s, 2.0}));
+    }
+
+    // Batched results next to the one-at-a-time Matrix results
+    DynamicVector<double> det = determinant(a);
+    MatrixBatch<double, 3, 3> inv = inverse(a);
+    MatrixBatch<double, 3, 3> product = multiply(a, inv);
+    VectorBatch<double, 3> ax = multiply(a, x);
+    VectorBatch<double, 3> solved = solve(a, ax);
+    for (std::size_t b = 0; b < count; ++b) {
+        std::cout << "Entry " << b << ": det = " << det[b] << " (Matrix: " << a.get(b).determinant() << ")" << std::endl;
+        std::cout << "A * x = " << ax.get(b) << ", solve recovers x = " << solved.get(b) << std::endl;
+        std::cout << "A * A^-1:" << std::endl;
+        product.get(b).display();
+    }
+    std::cout << "\n";
+
+    // 4x4 closed-form inverse (expected the identity)
+    MatrixBatch<double, 4, 4> m4(2);
+    m4.set(0, Matrix<double, 4, 4>({{4.0, 1.0, 0.0, 2.0}, {1.0, 5.0, 1.0, 0.0}, {0.0, 1.0, 6.0, 1.0}, {2.0, 0.0, 1.0, 7.0}}));
+    m4.set(1, Matrix<double, 4, 4>({{1.0, 2.0, 3.0, 4.0}, {0.0, 1.0, 2.0, 3.0}, {0.0, 0.0, 1.0, 2.0}, {1.0, 0.0, 0.0, 1.0}}));
+    MatrixBatch<double, 4, 4> identity = multiply(m4, inverse(m4));
+    identity.get(0).display();
+    identity.get(1).display();
+    std::cout << "Determinants: " << determinant(m4) << " (Matrix: " << m4.get(0).determinant() << ", " << m4.get(1).determinant() << ")" << std::endl;
+    std::cout << "\n";
+
+    // Integer batches are inverted exactly, entry by entry (expected [[1, -1], [-1, 2]] and [[1, 0], [-3, 1]])
+    MatrixBatch<int, 2, 2> integers(2);
+    integers.set(0, Matrix<int, 2, 2>({{2, 1}, {1, 1}}));
+    integers.set(1, Matrix<int, 2, 2>({{1, 0}, {3, 1}}));
+    MatrixBatch<int, 2, 2> integer_inverses = inverse(integers);
+    integer_inverses.get(0).display();
+    integer_inverses.get(1).display();
+    std::cout << "\n";
+
+    // Batched cross products
+    VectorBatch<double, 3> u(2), v(2);
+    u.set(0, Vector<double, 3>({1.0, 0.0, 0.0}));
+    v.set(0, Vector<double, 3>({0.0, 1.0, 0.0}));
+    u.set(1, Vector<double, 3>({1.0, 2.0, 3.0}));
+    v.set(1, Vector<double, 3>({4.0, 5.0, 6.0}));
+    VectorBatch<double, 3> w = cross(u, v);
+    std::cout << "Cross products: " << w.get(0) << " " << w.get(1) << std::endl;
+
+    return 0;
+}
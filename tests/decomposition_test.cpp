@@ -0,0 +1,129 @@
+#include <iostream>
+#include "../include/linear_algebra/matrix.hpp"
+#include "../include/linear_algebra/dynamic_matrix.hpp"
+
+using namespace linear_algebra;
+
+int main() {
+    // LU factorization with partial pivoting
+    Matrix<double, 3, 3> a = {{2.0, 1.0, 1.0}, {4.0, -6.0, 0.0}, {-2.0, 7.0, 2.0}};
+    LU<double, 3> lu(a);
+
+    std::cout << "L:" << std::endl;
+    lu.lower().display();
+    std::cout << "U:" << std::endl;
+    lu.upper().display();
+    std::cout << "P:" << std::endl;
+    lu.permutation().display();
+    std::cout << "\n";
+
+    // P A should equal L U
+    std::cout << "P * A:" << std::endl;
+    (lu.permutation() * a).display();
+    std::cout << "L * U:" << std::endl;
+    (lu.lower() * lu.upper()).display();
+    std::cout << "\n";
+
+    // Determinant through the factorization (expected -16)
+    std::cout << "Determinant of a: " << a.determinant() << std::endl;
+    std::cout << "\n";
+
+    // Inverse reusing the same factors
+    std::cout << "Inverse of a:" << std::endl;
+    lu.inverse().display();
+    std::cout << "\n";
+
+    // Singular matrices report a zero determinant
+    Matrix<double, 3, 3> singular_mat = {{1.0, 2.0, 3.0}, {2.0, 4.0, 6.0}, {1.0, 0.0, 1.0}};
+    std::cout << "Singular: " << LU<double, 3>(singular_mat).is_singular()
+              << ", determinant: " << singular_mat.determinant() << std::endl;
+    std::cout << "\n";
+
+    // Larger sizes are now practical (expected determinant 2^20 = 1048576)
+    Matrix<double, 20, 20> big;
+    for (int i = 0; i < 20; ++i) {
+        big(i, i) = 2.0;
+        if (i + 1 < 20) {
+            big(i, i + 1) = 1.0;
+        }
+    }
+    std::cout << "Determinant of 20x20 upper bidiagonal: " << big.determinant() << std::endl;
+    std::cout << "\n";
+
+    // Factor once, solve many right-hand sides (expected (1, 1, 2) and (2, 0, 1))
+    Vector<double, 3> b1({5.0, -2.0, 9.0});
+    Vector<double, 3> b2({5.0, 8.0, -2.0});
+    std::cout << "LU solve b1: " << lu.solve(b1) << std::endl;
+    std::cout << "LU solve b2: " << lu.solve(b2) << std::endl;
+
+    // Whole block of right-hand sides at once (columns are b1 and b2)
+    Matrix<double, 3, 2> rhs = {{5.0, 5.0}, {-2.0, 8.0}, {9.0, -2.0}};
+    std::cout << "LU block solve:" << std::endl;
+    lu.solve(rhs).display();
+    std::cout << "\n";
+
+    // Cholesky for symmetric positive definite systems (expected (1, 1, 1))
+    Matrix<double, 3, 3> spd = {{4.0, 12.0, -16.0}, {12.0, 37.0, -43.0}, {-16.0, -43.0, 98.0}};
+    Cholesky<double, 3> chol(spd);
+    std::cout << "Cholesky L:" << std::endl;
+    chol.lower().display();
+    Vector<double, 3> b3({0.0, 6.0, 39.0});
+    std::cout << "Cholesky solve: " << chol.solve(b3) << std::endl;
+    std::cout << "Cholesky determinant: " << chol.determinant() << std::endl;
+    std::cout << "\n";
+
+    // QR least squares fit of y = c0 + c1 * t (expected (1, 2) for exact data)
+    Matrix<double, 4, 2> design = {{1.0, 0.0}, {1.0, 1.0}, {1.0, 2.0}, {1.0, 3.0}};
+    Vector<double, 4> observations({1.0, 3.0, 5.0, 7.0});
+    QR<double, 4, 2> qr(design);
+    std::cout << "QR R:" << std::endl;
+    qr.r().display();
+    std::cout << "Q * R:" << std::endl;
+    (qr.q() * qr.r()).display();
+    std::cout << "QR least squares: " << qr.solve(observations) << std::endl;
+    std::cout << "\n";
+
+    // Integer matrices past the closed-form sizes: exact determinant (expected 492) and inverse
+    Matrix<int, 5, 5> tridiagonal = {{2, 1, 0, 0, 0}, {1, 3, 1, 0, 0}, {0, 1, 4, 1, 0}, {0, 0, 1, 5, 1}, {0, 0, 0, 1, 6}};
+    std::cout << "Integer 5x5 determinant: " << tridiagonal.determinant()
+              << ", dynamic: " << DynamicMatrix<int>(tridiagonal).determinant()
+              << ", DynamicLU: " << DynamicLU<int>(DynamicMatrix<int>(tridiagonal)).determinant() << std::endl;
+    Matrix<int, 5, 5> unimodular = {{1, 2, 0, 1, 0}, {1, 3, 3, 1, 1}, {0, 2, 7, 2, 2}, {1, 2, 1, 4, 1}, {0, 1, 3, 2, 4}};
+    std::cout << "Integer 5x5 with determinant " << unimodular.determinant() << ", A * A^-1:" << std::endl;
+    (unimodular * unimodular.inverse()).display();
+    Vector<int, 5> integer_rhs = unimodular * Vector<int, 5>({1, -2, 3, -4, 5});
+    std::cout << "Integer LU solve (expected [1, -2, 3, -4, 5]): " << LU<int, 5>(unimodular).solve(integer_rhs) << std::endl;
+    // Inverse entries are rounded the same way on every path: 0.5 becomes 1
+    Matrix<int, 5, 5> twice_identity;
+    for (int i = 0; i < 5; ++i) {
+        twice_identity(i, i) = 2;
+    }
+    std::cout << "Inverse of 2I, (0, 0): exact " << twice_identity.inverse()(0, 0)
+              << ", LU " << LU<int, 5>(twice_identity).inverse()(0, 0) << std::endl;
+    // Minors past the range of long long fall back to floating point (expected 1e+30)
+    Matrix<int, 6, 6> large_diagonal;
+    for (int i = 0; i < 6; ++i) {
+        large_diagonal(i, i) = 100000;
+    }
+    std::cout << "Determinant of 1e5 I (6x6): " << large_diagonal.determinant() << std::endl;
+    std::cout << "\n";
+
+    // Derivatives through the decompositions with AD elements, A(x) = [[x, 1], [2, 3]] at x = 2
+    using Dual = ADVariable<double>;
+    Dual x = Dual::seed(2.0, 0);
+    Matrix<Dual, 2, 2> ad = {{x, Dual(1.0)}, {Dual(2.0), Dual(3.0)}};
+    Dual det = ad.determinant(); // 3x - 2, derivative 3
+    std::cout << "det A(x) = " << det.getValue() << ", d/dx = " << det.getDerivative() << std::endl;
+    Matrix<Dual, 2, 2> ad_inv = ad.inverse(); // (A^-1)(0, 0) = 3 / (3x - 2), derivative -9 / (3x - 2)^2
+    std::cout << "A^-1(0, 0) = " << ad_inv(0, 0).getValue() << ", d/dx = " << ad_inv(0, 0).getDerivative() << std::endl;
+    Vector<Dual, 2> ad_rhs({Dual(1.0), Dual(1.0)});
+    Vector<Dual, 2> ad_x = ad.solve_linear_equations(ad_rhs); // x0 = 2 / (3x - 2), derivative -6 / (3x - 2)^2
+    std::cout << "x0 = " << ad_x[0].getValue() << ", d/dx = " << ad_x[0].getDerivative() << std::endl;
+    ad.solve_in_place(ad_rhs);
+    std::cout << "In place: x0 = " << ad_rhs[0].getValue() << ", d/dx = " << ad_rhs[0].getDerivative() << std::endl;
+    std::cout << "||A(x)|| = " << ad.norm().getValue() << ", d/dx = " << ad.norm().getDerivative() << std::endl;
+    ad.invert_in_place();
+    std::cout << "In place: A^-1(0, 0) = " << ad(0, 0).getValue() << ", d/dx = " << ad(0, 0).getDerivative() << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,63 @@
+#include <iostream>
+#include "../include/linear_algebra/dynamic_matrix.hpp"
+
+using namespace linear_algebra;
+
+int main() {
+    // Runtime-sized vectors
+    DynamicVector<double> v1 = {1.0, 2.0, 3.0};
+    DynamicVector<double> v2(3, 2.0);
+    std::cout << "v1: " << v1 << std::endl;
+    std::cout << "v1 + v2: " << v1 + v2 << std::endl;
+    std::cout << "v1 - v2: " << v1 - v2 << std::endl;
+    std::cout << "v1 * 3: " << v1 * 3.0 << std::endl;
+    std::cout << "Dot product (v1.v2): " << v1.dot(v2) << std::endl;
+    std::cout << "Magnitude of v1: " << v1.magnitude() << std::endl;
+    std::cout << "Normalized v1: " << v1.normalize() << std::endl;
+    std::cout << "\n";
+
+    // Runtime-sized matrices
+    DynamicMatrix<double> a = {{1.0, 2.0}, {3.0, 4.0}};
+    DynamicMatrix<double> b = {{5.0, 6.0}, {7.0, 8.0}};
+    (a + b).display();
+    std::cout << "\n";
+    (a * b).display();
+    std::cout << "\n";
+    a.transpose().display();
+    std::cout << "\n";
+    a.inverse().display();
+    std::cout << "Determinant of a: " << a.determinant() << std::endl;
+    std::cout << "Frobenius norm of a: " << a.norm() << std::endl;
+    DynamicVector<double> rhs = {5.0, 11.0};
+    std::cout << "Solution of linear equations: " << a.solve_linear_equations(rhs) << std::endl;
+    std::cout << "\n";
+
+    // Interoperability with the fixed-size types
+    Matrix<double, 2, 3> fixed = {{1.0, 0.0, 2.0}, {0.0, 1.0, 3.0}};
+    DynamicMatrix<double> from_fixed(fixed);
+    (a * fixed).display();
+    std::cout << "\n";
+    Matrix<double, 2, 2> back = (a * b).to_fixed<2, 2>();
+    back.display();
+    std::cout << "\n";
+    Vector<double, 2> fixed_vec({1.0, 1.0});
+    std::cout << "a * fixed vector: " << a * fixed_vec << std::endl;
+    std::cout << "\n";
+
+    // Sizes that would not fit on the stack (expected a 1000 x 1000 identity with trace 1000)
+    const std::size_t n = 1000;
+    DynamicMatrix<double> big = DynamicMatrix<double>::identity(n) * 2.0;
+    DynamicMatrix<double> product = big * big.inverse();
+    double trace = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        trace += product(i, i);
+    }
+    std::cout << "Trace of 1000x1000 A * A^-1: " << trace << std::endl;
+
+    // Move semantics: the buffer is handed over, not copied
+    const double* buffer = big.data_ptr();
+    DynamicMatrix<double> moved = std::move(big);
+    std::cout << "Moved without copy: " << (moved.data_ptr() == buffer) << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,155 @@
+#include <iostream>
+#include "../include/linear_algebra/eigen.hpp"
+
+using namespace linear_algebra;
+
+// Largest absolute entry of A - B
+template<typename T, int Rows, int Cols>
+T max_difference(const Matrix<T, Rows, Cols>& a, const Matrix<T, Rows, Cols>& b) {
+    T difference = T(0);
+    for (int i = 0; i < Rows; ++i) {
+        for (int j = 0; j < Cols; ++j) {
+            difference = std::max(difference, std::abs(a(i, j) - b(i, j)));
+        }
+    }
+    return difference;
+}
+
+// 1D Laplacian with Dirichlet ends, eigenvalues 2 - 2 cos(k pi / (n + 1))
+CsrMatrix<double> laplacian(std::size_t n) {
+    CooMatrix<double> coo(n, n);
+    for (std::size_t i = 0; i < n; ++i) {
+        coo.add(i, i, 2.0);
+        if (i > 0) {
+            coo.add(i, i - 1, -1.0);
+        }
+        if (i + 1 < n) {
+            coo.add(i, i + 1, -1.0);
+        }
+    }
+    return CsrMatrix<double>(coo);
+}
+
+int main() {
+    // Symmetric eigendecomposition: A = Q diag(lambda) Q^T
+    Matrix<double, 4, 4> sym = {{4.0, 1.0, -2.0, 2.0},
+                                {1.0, 2.0, 0.0, 1.0},
+                                {-2.0, 0.0, 3.0, -2.0},
+                                {2.0, 1.0, -2.0, -1.0}};
+    SymmetricEigen<double, 4> sym_eigen(sym);
+    std::cout << "Symmetric eigenvalues:";
+    for (int i = 0; i < 4; ++i) {
+        std::cout << " " << sym_eigen.eigenvalues()[i];
+    }
+    std::cout << std::endl;
+    const Matrix<double, 4, 4>& q = sym_eigen.eigenvectors();
+    Matrix<double, 4, 4> scaled = q;
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            scaled(i, j) *= sym_eigen.eigenvalues()[j];
+        }
+    }
+    std::cout << "Reconstruction error: " << max_difference(Matrix<double, 4, 4>(scaled * q.transpose()), sym) << std::endl;
+    Matrix<double, 4, 4> identity;
+    for (int i = 0; i < 4; ++i) {
+        identity(i, i) = 1.0;
+    }
+    std::cout << "Orthogonality error: " << max_difference(Matrix<double, 4, 4>(q.transpose() * q), identity) << "\n\n";
+
+    // Nonsymmetric eigenvalues: a rotation-like block gives the complex pair 1 +- 2i
+    Matrix<double, 3, 3> nonsym = {{1.0, -2.0, 0.0},
+                                   {2.0, 1.0, 0.0},
+                                   {0.0, 0.0, 3.0}};
+    NonsymmetricEigen<double, 3> nonsym_eigen(nonsym);
+    std::cout << "Nonsymmetric eigenvalues (expected 1-2i, 1+2i, 3):";
+    for (int i = 0; i < 3; ++i) {
+        std::cout << " " << nonsym_eigen.eigenvalues()[i];
+    }
+    std::cout << std::endl;
+
+    // Companion matrix of (x - 1)(x - 2)(x - 3)(x - 4): stiff and far from normal
+    Matrix<double, 4, 4> companion = {{10.0, -35.0, 50.0, -24.0},
+                                      {1.0, 0.0, 0.0, 0.0},
+                                      {0.0, 1.0, 0.0, 0.0},
+                                      {0.0, 0.0, 1.0, 0.0}};
+    NonsymmetricEigen<double, 4> companion_eigen(companion);
+    std::cout << "Companion eigenvalues (expected 1, 2, 3, 4):";
+    for (int i = 0; i < 4; ++i) {
+        std::cout << " " << companion_eigen.eigenvalues()[i].real();
+    }
+    std::cout << "\nSpectral radius: " << companion_eigen.spectral_radius()
+              << ", spectral abscissa: " << companion_eigen.spectral_abscissa() << "\n\n";
+
+    // Thin SVD of a tall and a wide matrix, A = U diag(sigma) V^T
+    Matrix<double, 4, 3> tall = {{1.0, 2.0, 3.0},
+                                 {4.0, 5.0, 6.0},
+                                 {7.0, 8.0, 10.0},
+                                 {1.0, 0.0, 1.0}};
+    SVD<double, 4, 3> tall_svd(tall);
+    std::cout << "Singular values:";
+    for (int i = 0; i < 3; ++i) {
+        std::cout << " " << tall_svd.singular_values()[i];
+    }
+    Matrix<double, 4, 3> us = tall_svd.u();
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            us(i, j) *= tall_svd.singular_values()[j];
+        }
+    }
+    std::cout << "\nReconstruction error: " << max_difference(Matrix<double, 4, 3>(us * tall_svd.v().transpose()), tall)
+              << ", rank: " << tall_svd.rank() << ", condition number: " << tall_svd.condition_number() << std::endl;
+
+    // Rank one wide matrix: the pseudo-inverse satisfies A A+ A = A
+    Matrix<double, 2, 3> wide = {{1.0, 2.0, 3.0},
+                                 {2.0, 4.0, 6.0}};
+    SVD<double, 2, 3> wide_svd(wide);
+    Matrix<double, 3, 2> pinv = wide_svd.pseudo_inverse();
+    std::cout << "Wide rank: " << wide_svd.rank() << ", A A+ A error: "
+              << max_difference(Matrix<double, 2, 3>(wide * pinv * wide), wide) << "\n\n";
+
+    // Partial eigensolvers on a sparse operator, against the closed form
+    const std::size_t n = 400;
+    CsrMatrix<double> lap = laplacian(n);
+    const double pi = std::acos(-1.0);
+    auto exact = [&](std::size_t k) { return 2.0 - 2.0 * std::cos(static_cast<double>(n - k) * pi / static_cast<double>(n + 1)); };
+
+    PartialEigenResult<double> top = lanczos_eigen<double>(lap, n, 4);
+    std::cout << "Lanczos top 4 (converged = " << std::boolalpha << top.converged << ", " << top.iterations << " products):";
+    for (std::size_t i = 0; i < top.values.size(); ++i) {
+        std::cout << " " << top.values[i] << " (error " << std::abs(top.values[i] - exact(i)) << ")";
+    }
+    std::cout << std::endl;
+
+    // The smallest eigenvalue through a shifted callable operator: 4I - A has top eigenvalue 4 - lambda_min
+    auto shifted = [&](const DynamicVector<double>& x, DynamicVector<double>& y) {
+        lap.multiply(x.data_ptr(), y.data_ptr());
+        for (std::size_t i = 0; i < n; ++i) {
+            y[i] = 4.0 * x[i] - y[i];
+        }
+    };
+    PartialEigenOptions<double> loose;
+    loose.tolerance = 1e-6;
+    PartialEigenResult<double> smallest = lanczos_eigen<double>(shifted, n, 1, loose);
+    std::cout << "Smallest eigenvalue via shifted Lanczos: " << 4.0 - smallest.values[0]
+              << " (exact " << 2.0 - 2.0 * std::cos(pi / static_cast<double>(n + 1)) << ")" << std::endl;
+
+    Matrix<double, 3, 3> dominant_matrix = {{6.0, 2.0, 1.0},
+                                            {2.0, 3.0, 1.0},
+                                            {1.0, 1.0, 1.0}};
+    PartialEigenResult<double> dominant = power_iteration<double>(dominant_matrix, 3);
+    std::cout << "Power iteration: " << dominant.values[0] << " after " << dominant.iterations
+              << " products, full solver: " << SymmetricEigen<double, 3>(dominant_matrix).eigenvalues()[2] << "\n\n";
+
+    // Leading singular triplets of a dense matrix, compared with the full SVD
+    DynamicMatrix<double> data(4, 3);
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            data(i, j) = tall(i, j);
+        }
+    }
+    PartialSVDResult<double> leading = partial_svd<double>(data, 2);
+    std::cout << "Partial SVD top 2: " << leading.values[0] << " " << leading.values[1]
+              << " (full: " << tall_svd.singular_values()[0] << " " << tall_svd.singular_values()[1] << ")" << std::endl;
+
+    return 0;
+}
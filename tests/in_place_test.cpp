@@ -0,0 +1,142 @@
+#include <iostream>
+#include <utility>
+#include "../include/linear_algebra/dynamic_matrix.hpp"
+
+using namespace linear_algebra;
+
+template<int N>
+double max_difference(const Matrix<double, N, N>& a, const Matrix<double, N, N>& b) {
+    double difference = 0.0;
+    for (int i = 0; i < N; ++i) {
+        for (int j = 0; j < N; ++j) {
+            difference = std::max(difference, std::abs(a(i, j) - b(i, j)));
+        }
+    }
+    return difference;
+}
+
+double max_difference(const DynamicMatrix<double>& a, const DynamicMatrix<double>& b) {
+    double difference = 0.0;
+    for (std::size_t i = 0; i < a.rows(); ++i) {
+        for (std::size_t j = 0; j < a.cols(); ++j) {
+            difference = std::max(difference, std::abs(a(i, j) - b(i, j)));
+        }
+    }
+    return difference;
+}
+
+int main() {
+    // Compound assignment on fixed-size vectors
+    Vector<double, 4> v({1.0, 2.0, 3.0, 4.0});
+    Vector<double, 4> w({0.5, 0.5, 0.5, 0.5});
+    v += w;
+    std::cout << "v += w: " << v << std::endl;
+    v -= w * 2.0;
+    std::cout << "v -= 2w: " << v << std::endl;
+    v *= 2.0;
+    v /= 4.0;
+    std::cout << "v *= 2, v /= 4: " << v << std::endl;
+    v.normalize_in_place();
+    std::cout << "Normalized in place: " << v << ", magnitude " << v.magnitude() << "\n\n";
+
+    // Compound assignment, products and in-place transpose/inverse on fixed-size matrices
+    constexpr int n = 8;
+    Matrix<double, n, n> a;
+    Matrix<double, n, n> b;
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            a(i, j) = (i == j ? 4.0 : 0.0) + 0.1 * ((i * 3 + j * 5) % 7);
+            b(i, j) = 0.05 * ((2 * i + j) % 9);
+        }
+    }
+    Matrix<double, n, n> c = a;
+    c += b;
+    c -= b;
+    std::cout << "a + b - b vs a: " << max_difference(c, a) << std::endl;
+
+    Matrix<double, n, n> product;
+    multiply_into(product, a, b);
+    std::cout << "multiply_into vs a * b: " << max_difference(product, a * b) << std::endl;
+    c *= b;
+    std::cout << "c *= b vs a * b: " << max_difference(c, a * b) << std::endl;
+    c = a;
+    c *= c;
+    std::cout << "c *= c vs a * a: " << max_difference(c, a * a) << std::endl;
+
+    c = a;
+    c.transpose_in_place();
+    std::cout << "Transpose in place vs transpose(): " << max_difference(c, a.transpose()) << std::endl;
+    c = a;
+    c.invert_in_place();
+    std::cout << "Invert in place (Gauss-Jordan) vs inverse(): " << max_difference(c, a.inverse()) << std::endl;
+    Matrix<double, 3, 3> small({{2.0, 1.0, 0.0}, {1.0, 3.0, 1.0}, {0.0, 1.0, 4.0}});
+    Matrix<double, 3, 3> small_inverse = small;
+    small_inverse.invert_in_place();
+    std::cout << "Invert in place (3x3 closed form) vs inverse(): " << max_difference(small_inverse, small.inverse()) << std::endl;
+
+    Vector<double, n> x;
+    for (int i = 0; i < n; ++i) {
+        x[i] = 1.0 + i;
+    }
+    Vector<double, n> ax;
+    multiply_into(ax, a, x);
+    a.solve_in_place(ax);
+    double solve_error = 0.0;
+    for (int i = 0; i < n; ++i) {
+        solve_error = std::max(solve_error, std::abs(ax[i] - x[i]));
+    }
+    std::cout << "solve_in_place recovers x: max error " << solve_error << std::endl;
+
+    try {
+        multiply_into(product, product, b);
+    } catch (const std::invalid_argument& e) {
+        std::cout << "Aliased output: " << e.what() << "\n\n";
+    }
+
+    // Dynamic matrices: compound assignment and operands that lend their storage
+    DynamicMatrix<double> da(a);
+    DynamicMatrix<double> db(b);
+    DynamicMatrix<double> sum = da;
+    const double* storage = sum.data_ptr();
+    sum += db;
+    DynamicMatrix<double> moved = std::move(sum) * 2.0 - db;
+    std::cout << "(a + b) * 2 - b reused the storage of its first operand: " << std::boolalpha << (moved.data_ptr() == storage)
+              << ", error " << max_difference(moved, DynamicMatrix<double>(Matrix<double, n, n>(a * 2.0 + b))) << std::endl;
+
+    DynamicMatrix<double> inverse_copy = da;
+    storage = inverse_copy.data_ptr();
+    DynamicMatrix<double> inverse = std::move(inverse_copy).inverse();
+    std::cout << "std::move(a).inverse() reused the storage: " << (inverse.data_ptr() == storage)
+              << ", error " << max_difference(inverse, da.inverse()) << std::endl;
+
+    DynamicMatrix<double> wide(3, 5);
+    for (std::size_t i = 0; i < 3; ++i) {
+        for (std::size_t j = 0; j < 5; ++j) {
+            wide(i, j) = static_cast<double>(10 * i + j);
+        }
+    }
+    DynamicMatrix<double> tall = wide;
+    tall.transpose_in_place();
+    std::cout << "Non-square transpose in place: " << tall.rows() << "x" << tall.cols()
+              << ", error " << max_difference(tall, wide.transpose()) << std::endl;
+
+    // A hot loop with preallocated outputs: after the first pass no new storage is needed
+    DynamicVector<double> state(n, 1.0);
+    DynamicVector<double> next;
+    DynamicMatrix<double> step = DynamicMatrix<double>::identity(n) + db * 0.1;
+    multiply_into(next, step, state);
+    const double* next_storage = next.data_ptr();
+    for (int iteration = 0; iteration < 20; ++iteration) {
+        multiply_into(next, step, state);
+        std::swap(next, state);
+        state.normalize_in_place();
+    }
+    std::cout << "Power iteration kept its two buffers: "
+              << (next.data_ptr() == next_storage || state.data_ptr() == next_storage) << ", state " << state << std::endl;
+
+    DynamicLU<double> lu(da);
+    DynamicVector<double> rhs = da * DynamicVector<double>(x);
+    lu.solve_in_place(rhs);
+    std::cout << "DynamicLU::solve_in_place: " << rhs << std::endl;
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include <iostream>
+#include "../include/linear_algebra/iterative.hpp"
+
+using namespace linear_algebra;
+
+// 5-point convection-diffusion stencil on a g x g grid; symmetric positive definite for c = 0
+CsrMatrix<double> stencil(std::size_t g, double c) {
+    const std::size_t n = g * g;
+    CooMatrix<double> coo(n, n);
+    for (std::size_t i = 0; i < g; ++i) {
+        for (std::size_t j = 0; j < g; ++j) {
+            const std::size_t row = i * g + j;
+            coo.add(row, row, 4.0 + 0.1 * static_cast<double>(row % 3));
+            if (j > 0) {
+                coo.add(row, row - 1, -1.0 - c);
+            }
+            if (j + 1 < g) {
+                coo.add(row, row + 1, -1.0 + c);
+            }
+            if (i > 0) {
+                coo.add(row, row - g, -1.0);
+            }
+            if (i + 1 < g) {
+                coo.add(row, row + g, -1.0);
+            }
+        }
+    }
+    return CsrMatrix<double>(coo);
+}
+
+template<typename T>
+void report(const char* name, const IterativeResult<T>& result) {
+    std::cout << name << ": converged = " << std::boolalpha << result.converged << ", iterations = " << result.iterations
+              << ", relative residual = " << (result.residual < 1e-10 ? "< 1e-10" : "above tolerance") << std::endl;
+}
+
+int main() {
+    const std::size_t g = 30;
+    DynamicVector<double> b(g * g, 1.0);
+
+    // Symmetric positive definite system: CG with and without preconditioning
+    CsrMatrix<double> spd = stencil(g, 0.0);
+    report("CG", conjugate_gradient(spd, b));
+    report("CG + Jacobi", conjugate_gradient(spd, b, JacobiPreconditioner<double>(spd)));
+    report("CG + ILU(0)", conjugate_gradient(spd, b, ILU0Preconditioner<double>(spd)));
+    std::cout << "\n";
+
+    // Nonsymmetric system: BiCGSTAB and restarted GMRES
+    CsrMatrix<double> nonsym = stencil(g, 0.3);
+    report("BiCGSTAB", bicgstab(nonsym, b));
+    report("BiCGSTAB + ILU(0)", bicgstab(nonsym, b, ILU0Preconditioner<double>(nonsym)));
+    IterativeOptions<double> options;
+    options.restart = 20;
+    options.max_iterations = 2000;
+    report("GMRES(20)", gmres(nonsym, b, IdentityPreconditioner<double>(), options));
+    IterativeResult<double> preconditioned = gmres(nonsym, b, ILU0Preconditioner<double>(nonsym), options);
+    report("GMRES(20) + ILU(0)", preconditioned);
+    std::cout << "Residual history:";
+    for (double r : preconditioned.residual_history) {
+        std::cout << " " << r;
+    }
+    std::cout << std::endl;
+    std::cout << "\n";
+
+    // Any operator exposing only a matrix-vector product: a dense matrix and a matrix-free lambda
+    Matrix<double, 3, 3> dense = {{4.0, 1.0, 0.0}, {1.0, 3.0, 1.0}, {0.0, 1.0, 2.0}};
+    DynamicVector<double> b3 = {1.0, 2.0, 3.0};
+    std::cout << "CG on a dense Matrix: " << conjugate_gradient(dense, b3).x << std::endl;
+    auto laplacian = [](const DynamicVector<double>& x, DynamicVector<double>& y) {
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            y[i] = 2.0 * x[i] - (i > 0 ? x[i - 1] : 0.0) - (i + 1 < x.size() ? x[i + 1] : 0.0);
+        }
+    };
+    std::cout << "CG on a matrix-free operator: " << conjugate_gradient(laplacian, b3).x << std::endl;
+
+    // Iteration cap
+    IterativeOptions<double> capped;
+    capped.max_iterations = 5;
+    report("CG capped at 5 iterations", conjugate_gradient(spd, b, IdentityPreconditioner<double>(), capped));
+
+    return 0;
+}
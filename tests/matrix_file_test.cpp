@@ -0,0 +1,77 @@
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "../include/linear_algebra/matrix_file.hpp"
+
+using namespace linear_algebra;
+
+int main() {
+    const std::string path = (std::filesystem::temp_directory_path() / "linear_algebra_matrix_file_demo.bin").string();
+
+    // Save a Matrix and map it back; the view reads the file pages in place
+    Matrix<double, 3, 4> a = {{1.0, 2.0, 3.0, 4.0}, {5.0, 6.0, 7.0, 8.0}, {9.0, 10.0, 11.0, 12.0}};
+    save_matrix(path, MatrixView<const double>(a));
+    {
+        MappedMatrix<double> mapped(path);
+        std::cout << "Mapped " << mapped.rows() << "x" << mapped.cols() << ", checksum ok: " << mapped.verify() << std::endl;
+        mapped.view().eval().display();
+    }
+    std::cout << "\n";
+
+    // Stream a column-major file one column at a time, without the matrix in memory
+    {
+        MatrixFileWriter<double> writer(path, 3, 4, Layout::ColumnMajor);
+        for (std::size_t j = 0; j < 4; ++j) {
+            writer.write(MatrixView<const double>(a).col(j));
+        }
+        writer.close();
+    }
+    // Expected the same matrix as above, read through a strided view
+    DynamicMatrix<double> loaded = load_matrix<double>(path);
+    std::cout << "Loaded from a column-major file:" << std::endl;
+    loaded.display();
+    std::cout << "\n";
+
+    // Writable mapping: edit in place, refresh the checksum and reopen
+    {
+        MappedMatrix<double> created = MappedMatrix<double>::create(path, 2, 2);
+        std::cout << "Created zero file, checksum ok: " << created.verify() << std::endl;
+        MatrixView<double> view = created.mutable_view();
+        view(0, 0) = 3.0;
+        view(1, 1) = 4.0;
+        std::cout << "After editing, checksum ok: " << created.verify() << std::endl;
+        created.update_checksum();
+        created.sync();
+    }
+    MappedMatrix<double> reopened(path);
+    std::cout << "Reopened, checksum ok: " << reopened.verify() << std::endl;
+    reopened.view().eval().display();
+    std::cout << "\n";
+
+    // Mismatched element types are rejected when the header is read
+    try {
+        MappedMatrix<float> wrong(path);
+    } catch (const std::runtime_error& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+    }
+
+    // A crafted row count whose payload size wraps around to the real file length is rejected too
+    save_matrix(path, MatrixView<const double>(Matrix<double, 2, 2>({{1.0, 2.0}, {3.0, 4.0}})));
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        const std::uint64_t wrapping_rows = (std::uint64_t(1) << 62) + 2;
+        file.seekp(offsetof(MatrixFileHeader, rows));
+        file.write(reinterpret_cast<const char*>(&wrapping_rows), sizeof(wrapping_rows));
+    }
+    try {
+        MappedMatrix<double> crafted(path);
+    } catch (const std::runtime_error& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+    }
+
+    std::filesystem::remove(path);
+    return 0;
+}
@@ -26,6 +26,17 @@ int main() {
     mat_product.display();
         std::cout<<"\n";
 
+    // Test compound expression, fused into one pass
+    Matrix<double, 2, 2> mat_expr = mat_a + mat_b * 2.0 - mat_c / 2.0;
+    mat_expr.display();
+        std::cout<<"\n";
+
+    // Test expression with a temporary operand, evaluated before the temporary goes away
+    auto temporary_expr = mat_c.transpose() + mat_d;
+    Matrix<double, 2, 2> from_temporary = temporary_expr;
+    from_temporary.display();
+        std::cout<<"\n";
+
     // Test scalar multiplication
     auto scalar_result = mat_c * 2.0;
     scalar_result.display();
@@ -42,6 +53,18 @@ int main() {
     inversed_mat.display();
         std::cout<<"\n";
 
+    // Sizes up to 4x4 use closed-form kernels; compare with the LU route (expected the same matrix)
+    Matrix<double, 4, 4> mat_small = {{4.0, 1.0, 0.0, 2.0}, {1.0, 3.0, 1.0, 0.0}, {0.0, 1.0, 5.0, 1.0}, {2.0, 0.0, 1.0, 6.0}};
+    mat_small.inverse().display();
+    LU<double, 4>(mat_small).inverse().display();
+    std::cout << "Determinant of mat_small: " << mat_small.determinant() << " (LU: " << LU<double, 4>(mat_small).determinant() << ")" << std::endl;
+    try {
+        singular_mat.inverse();
+    } catch (const std::runtime_error& e) {
+        std::cout << "Singular: " << e.what() << std::endl;
+    }
+        std::cout<<"\n";
+
     // Test determinant
     double det = mat_c.determinant();
     std::cout << "Determinant of mat_c: " << det << std::endl;
@@ -59,5 +82,18 @@ int main() {
     std::cout<<solution;
         std::cout<<"\n";
 
+    // Compile-time evaluation: the transform, its inverse and the products below are computed by
+    // the compiler and baked into the binary
+    constexpr Matrix<double, 3, 3> rotation = {{0.0, -1.0, 0.0}, {1.0, 0.0, 0.0}, {0.0, 0.0, 2.0}};
+    constexpr Matrix<double, 3, 3> rotation_inverse = rotation.inverse();
+    constexpr Matrix<double, 3, 3> round_trip = rotation * rotation_inverse;
+    constexpr Vector<double, 3> axis = Vector<double, 3>({1.0, 0.0, 0.0}).cross(Vector<double, 3>({0.0, 1.0, 0.0}));
+    constexpr Vector<double, 3> rotated = rotation * Vector<double, 3>(axis + Vector<double, 3>({1.0, 0.0, 0.0}));
+    static_assert(rotation.determinant() == 2.0, "Determinant is evaluated at compile time");
+    static_assert(round_trip(0, 0) == 1.0 && round_trip(2, 2) == 1.0, "R * R^-1 is the identity");
+    std::cout << "constexpr R^-1:" << std::endl;
+    rotation_inverse.display();
+    std::cout << "constexpr R * (e1 x e2 + e1): " << rotated << std::endl;
+
     return 0;
 }
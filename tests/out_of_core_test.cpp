@@ -0,0 +1,59 @@
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include "../include/linear_algebra/out_of_core.hpp"
+
+using namespace linear_algebra;
+
+// Stream an m x n matrix with entry (i, j) = f(i, j) to a file, one row at a time
+template<typename Func>
+DynamicMatrix<double> write_matrix(const std::string& path, std::size_t m, std::size_t n, Func f) {
+    DynamicMatrix<double> reference(m, n);
+    MatrixFileWriter<double> writer(path, m, n);
+    std::vector<double> row(n);
+    for (std::size_t i = 0; i < m; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            row[j] = f(i, j);
+            reference(i, j) = row[j];
+        }
+        writer.write(row.data(), n);
+    }
+    writer.close();
+    return reference;
+}
+
+int main() {
+    const auto dir = std::filesystem::temp_directory_path();
+    const std::string a_path = (dir / "linear_algebra_ooc_a.bin").string();
+    const std::string b_path = (dir / "linear_algebra_ooc_b.bin").string();
+    const std::string c_path = (dir / "linear_algebra_ooc_c.bin").string();
+
+    DynamicMatrix<double> a = write_matrix(a_path, 300, 200, [](std::size_t i, std::size_t j) { return std::sin(0.1 * i + 0.3 * j); });
+    DynamicMatrix<double> b = write_matrix(b_path, 200, 250, [](std::size_t i, std::size_t j) { return std::cos(0.2 * i - 0.1 * j); });
+    DynamicMatrix<double> expected = a * b;
+
+    // A budget of 160 KiB forces 64 x 64 tiles: 5 x 4 x 4 tile steps
+    for (bool prefetch : {false, true}) {
+        OutOfCoreOptions options;
+        options.memory_budget = 160 * 1024;
+        options.prefetch = prefetch;
+        OutOfCoreStats stats = multiply_out_of_core<double>(a_path, b_path, c_path, options);
+
+        MappedMatrix<double> c(c_path);
+        double max_error = 0.0;
+        for (std::size_t i = 0; i < c.rows(); ++i) {
+            for (std::size_t j = 0; j < c.cols(); ++j) {
+                max_error = std::max(max_error, std::abs(c.view()(i, j) - expected(i, j)));
+            }
+        }
+        std::cout << (prefetch ? "With prefetch" : "Without prefetch") << ": tile " << stats.tile << ", tile loads "
+                  << stats.tile_loads << ", checksum ok " << c.verify() << ", max error " << (max_error < 1e-10 ? "< 1e-10" : "too large")
+                  << std::endl;
+    }
+
+    std::filesystem::remove(a_path);
+    std::filesystem::remove(b_path);
+    std::filesystem::remove(c_path);
+    return 0;
+}
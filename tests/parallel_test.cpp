@@ -0,0 +1,113 @@
+#include <iostream>
+#include <thread>
+#include "../include/linear_algebra/dynamic_matrix.hpp"
+
+using namespace linear_algebra;
+
+// Deterministic, well-conditioned test matrix
+DynamicMatrix<double> make_matrix(std::size_t n) {
+    DynamicMatrix<double> m(n, n);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            m(i, j) = static_cast<double>((i * 7 + j * 13) % 17) / 17.0;
+        }
+        m(i, i) += static_cast<double>(n);
+    }
+    return m;
+}
+
+bool same(const DynamicMatrix<double>& a, const DynamicMatrix<double>& b) {
+    for (std::size_t i = 0; i < a.rows(); ++i) {
+        for (std::size_t j = 0; j < a.cols(); ++j) {
+            if (a(i, j) != b(i, j)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main() {
+    const std::size_t n = 400;
+    DynamicMatrix<double> a = make_matrix(n);
+    DynamicMatrix<double> b = make_matrix(n).transpose();
+    DynamicVector<double> x(n, 1.0);
+
+    // Serial reference results
+    set_num_threads(1);
+    DynamicMatrix<double> product = a * b;
+    DynamicMatrix<double> transposed = a.transpose();
+    DynamicMatrix<double> inverse = a.inverse();
+    DynamicVector<double> image = a * x;
+
+    // Same operations on the thread pool, with the threshold lowered so every operation is split
+    set_num_threads(4);
+    set_parallel_threshold(0);
+    std::cout << "Threads in use: " << get_num_threads() << std::endl;
+    std::cout << "Product identical: " << std::boolalpha << same(product, a * b) << std::endl;
+    std::cout << "Transpose identical: " << same(transposed, a.transpose()) << std::endl;
+    std::cout << "Inverse identical: " << same(inverse, a.inverse()) << std::endl;
+    DynamicVector<double> parallel_image = a * x;
+    bool image_same = true;
+    for (std::size_t i = 0; i < n; ++i) {
+        image_same = image_same && parallel_image[i] == image[i];
+    }
+    std::cout << "Matrix-vector product identical: " << image_same << std::endl;
+
+    // Fixed-size matrix-vector products are split by rows the same way
+    static Matrix<double, 600, 16> tall;
+    Vector<double, 16> ones;
+    for (int i = 0; i < 600; ++i) {
+        for (int j = 0; j < 16; ++j) {
+            tall(i, j) = static_cast<double>((i * 7 + j * 13) % 17) / 17.0;
+        }
+    }
+    for (int j = 0; j < 16; ++j) {
+        ones[j] = 1.0;
+    }
+    const Vector<double, 600> parallel_tall = tall * ones;
+    set_num_threads(1);
+    const Vector<double, 600> serial_tall = tall * ones;
+    set_num_threads(4);
+    bool tall_same = true;
+    for (int i = 0; i < 600; ++i) {
+        tall_same = tall_same && parallel_tall[i] == serial_tall[i];
+    }
+    std::cout << "Fixed-size matrix-vector product identical: " << tall_same << std::endl;
+
+    // Operations called from inside a parallel loop run inline on whichever thread picked up the block
+    const DynamicMatrix<double> small_a = make_matrix(200);
+    const DynamicMatrix<double> small_b = make_matrix(200).transpose();
+    set_num_threads(1);
+    const DynamicMatrix<double> small_product = small_a * small_b;
+    set_num_threads(4);
+    std::vector<DynamicMatrix<double>> products(16);
+    std::size_t wrong = 0;
+    for (int repeat = 0; repeat < 20; ++repeat) {
+        parallel_for(0, products.size(), 1, 0.0, [&](std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; ++i) {
+                products[i] = small_a * small_b;
+            }
+        });
+        for (const auto& p : products) {
+            wrong += same(p, small_product) ? 0 : 1;
+        }
+    }
+    std::cout << "Nested products differing from serial: " << wrong << " of " << 20 * products.size() << std::endl;
+
+    // Loops of your own can use the same pool
+    std::vector<double> squares(10);
+    parallel_for(0, squares.size(), 2, 0.0, [&](std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; ++i) {
+            squares[i] = static_cast<double>(i * i);
+        }
+    });
+    std::cout << "Squares:";
+    for (double s : squares) {
+        std::cout << " " << s;
+    }
+    std::cout << std::endl;
+
+    set_num_threads(1);
+    return 0;
+}
@@ -0,0 +1,65 @@
+// Profiling is opt-in and has to be switched on before the library headers are included
+#define LINEAR_ALGEBRA_PROFILE
+
+#include <fstream>
+#include <iostream>
+#include "../include/linear_algebra/matrix.hpp"
+#include "../include/linear_algebra/auto_differentiation.hpp"
+
+using namespace linear_algebra;
+
+int main() {
+    Profiler& profiler = Profiler::instance();
+    profiler.set_trace_enabled(true);
+
+    // A small pipeline: transform a batch of points and normalize the result
+    Matrix<double, 64, 64> a;
+    Matrix<double, 64, 64> b;
+    for (int i = 0; i < 64; ++i) {
+        for (int j = 0; j < 64; ++j) {
+            a(i, j) = (i == j ? 3.0 : 0.0) + 0.01 * ((i * 7 + j * 3) % 11);
+            b(i, j) = 0.02 * ((i + 2 * j) % 5);
+        }
+    }
+    Matrix<double, 64, 64> c = a * b + a;
+    Matrix<double, 64, 64> a_inv = a.inverse();
+    Vector<double, 64> x;
+    for (int i = 0; i < 64; ++i) {
+        x[i] = 1.0 + i;
+    }
+    for (int step = 0; step < 10; ++step) {
+        x = Vector<double, 64>(a_inv * x);
+        Vector<double, 64> y = x * 2.0;
+        std::cout << (step == 0 ? "Norms:" : "") << " " << y.magnitude();
+    }
+    // The trace is unchanged by transposing, which puts a transpose in the profile as well
+    const Matrix<double, 64, 64> product = (a_inv * c).transpose();
+    double trace = 0.0;
+    for (int i = 0; i < 64; ++i) {
+        trace += product(i, i);
+    }
+    std::cout << "\nTrace of a^-1 c: " << trace << std::endl;
+
+    // Forward-mode AD: f(x, y) = sin(x) * y + exp(x / y)
+    auto f = [](const std::array<ADVariable<double, 2>, 2>& v) {
+        return std::array<ADVariable<double, 2>, 1>{sin(v[0]) * v[1] + exp(v[0] / v[1])};
+    };
+    const auto jac = jacobian<double, 2>(f, {0.5, 2.0});
+    std::cout << "Jacobian: " << jac[0][0] << " " << jac[0][1] << "\n\n";
+
+    // Per-operation totals; copying the table into a bug report is usually enough to see where time went
+    profiler.write_summary(std::cout);
+
+    // The same calls as a timeline, for chrome://tracing or Perfetto
+    std::ofstream trace_file("./bin/profile_trace.json");
+    if (!trace_file) {
+        std::cerr << "\nCould not open ./bin/profile_trace.json (run from the repository root after make)" << std::endl;
+        return 1;
+    }
+    profiler.write_chrome_trace(trace_file);
+    std::cout << "\nTrace events written to ./bin/profile_trace.json" << std::endl;
+
+    profiler.reset();
+    std::cout << "Operations after reset: " << profiler.summary().size() << std::endl;
+    return 0;
+}
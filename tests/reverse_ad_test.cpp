@@ -0,0 +1,45 @@
+#include <iostream>
+#include <vector>
+#include "../include/linear_algebra/reverse_differentiation.hpp"
+
+using namespace std;
+using namespace linear_algebra;
+
+int main() {
+    Tape<double> tape;
+
+    // Test case 1: One backward sweep gives both partial derivatives
+    ReverseVariable<double> x = tape.variable(2.0);
+    ReverseVariable<double> y = tape.variable(3.0);
+    ReverseVariable<double> f = x * y + sin(x); // df/dx = y + cos(x), df/dy = x
+    vector<double> grad = tape.gradient(f);
+    cout << "Test case 1: f = " << f.getValue() << ", df/dx = " << x.getAdjoint(grad) << ", df/dy = " << y.getAdjoint(grad) << endl;
+
+    // Test case 2: Elementary functions and constants
+    ReverseVariable<double> g = exp(x) / y - 2.0 * log(y); // dg/dx = e^x / y, dg/dy = -e^x / y^2 - 2 / y
+    grad = tape.gradient(g);
+    cout << "Test case 2: g = " << g.getValue() << ", dg/dx = " << x.getAdjoint(grad) << ", dg/dy = " << y.getAdjoint(grad) << endl;
+
+    // Test case 3: Gradient of a function of many inputs, f(w) = sum(w_i^2) / 2 has gradient w
+    tape.clear();
+    const size_t n = 1000;
+    vector<ReverseVariable<double>> w;
+    for (size_t i = 0; i < n; ++i) {
+        w.push_back(tape.variable(0.001 * static_cast<double>(i)));
+    }
+    ReverseVariable<double> loss = dot(w, w) * 0.5;
+    grad = tape.gradient(loss);
+    cout << "Test case 3: loss = " << loss.getValue() << ", dloss/dw[10] = " << w[10].getAdjoint(grad)
+         << ", dloss/dw[999] = " << w[999].getAdjoint(grad) << ", tape nodes = " << tape.size() << endl;
+
+    // Test case 4: n-ary sum recorded as a single node
+    tape.clear();
+    ReverseVariable<double> a = tape.variable(1.0);
+    ReverseVariable<double> b = tape.variable(2.0);
+    ReverseVariable<double> c = a * b;
+    ReverseVariable<double> s = sum(a, b, c); // ds/da = 1 + b, ds/db = 1 + a
+    grad = tape.gradient(s);
+    cout << "Test case 4: sum(a, b, a * b) = " << s.getValue() << ", ds/da = " << a.getAdjoint(grad) << ", ds/db = " << b.getAdjoint(grad) << endl;
+
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include <iostream>
+#include "../include/linear_algebra/sparse.hpp"
+
+using namespace linear_algebra;
+
+int main() {
+    // Assembly in coordinate format; the two entries at (0, 0) are summed
+    CooMatrix<double> coo(3, 4);
+    coo.add(2, 3, 5.0);
+    coo.add(0, 0, 1.0);
+    coo.add(1, 2, 3.0);
+    coo.add(0, 0, 1.0);
+    coo.add(2, 1, 4.0);
+    CsrMatrix<double> a(coo);
+    std::cout << "CSR matrix with " << a.nonzeros() << " nonzeros:" << std::endl;
+    a.display();
+    a.to_dense().display();
+    std::cout << "\n";
+
+    // Sparse matrix-vector products (expected (2, 9, 28))
+    Vector<double, 4> x({1.0, 2.0, 3.0, 4.0});
+    std::cout << "CSR * x: " << a * x << std::endl;
+    CscMatrix<double> a_csc(a);
+    std::cout << "CSC * x: " << a_csc * DynamicVector<double>(x) << std::endl;
+    std::cout << "\n";
+
+    // Transpose and sparse-sparse product, compared with the dense path
+    CsrMatrix<double> at = a.transpose();
+    std::cout << "Transpose:" << std::endl;
+    at.to_dense().display();
+    std::cout << "A * A^T (sparse):" << std::endl;
+    (a * at).to_dense().display();
+    std::cout << "A * A^T (dense):" << std::endl;
+    (a.to_dense() * at.to_dense()).display();
+    std::cout << "\n";
+
+    // Conversion from a fixed-size dense matrix drops the zeros
+    Matrix<double, 2, 3> dense = {{0.0, 7.0, 0.0}, {8.0, 0.0, 9.0}};
+    CsrMatrix<double> from_dense(dense);
+    std::cout << "Nonzeros kept from dense: " << from_dense.nonzeros() << ", entry (1, 2) = " << from_dense(1, 2) << std::endl;
+
+    // Raw CSR arrays are validated up front
+    try {
+        CsrMatrix<double> bad(2, 2, {0, 1, 2}, {0, 5}, {1.0, 2.0});
+    } catch (const std::invalid_argument& e) {
+        std::cout << "Column index out of range: " << e.what() << std::endl;
+    }
+    try {
+        CsrMatrix<double> bad(2, 2, {0, 2, 1}, {0}, {1.0});
+    } catch (const std::invalid_argument& e) {
+        std::cout << "Decreasing row pointers: " << e.what() << std::endl;
+    }
+    try {
+        CsrMatrix<double> bad(1, 3, {0, 2}, {2, 0}, {1.0, 2.0});
+    } catch (const std::invalid_argument& e) {
+        std::cout << "Unsorted columns: " << e.what() << std::endl;
+    }
+    try {
+        from_dense(2, 0);
+    } catch (const std::out_of_range& e) {
+        std::cout << "Entry (2, 0) of a 2x3 matrix: " << e.what() << std::endl;
+    }
+
+    return 0;
+}
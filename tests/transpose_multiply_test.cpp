@@ -0,0 +1,86 @@
+#include <iostream>
+#include "../include/linear_algebra/view.hpp"
+
+using namespace linear_algebra;
+
+DynamicMatrix<double> filled(std::size_t rows, std::size_t cols, double seed) {
+    DynamicMatrix<double> m(rows, cols);
+    for (std::size_t i = 0; i < rows; ++i) {
+        for (std::size_t j = 0; j < cols; ++j) {
+            m(i, j) = std::sin(seed + static_cast<double>(i * cols + j));
+        }
+    }
+    return m;
+}
+
+double max_difference(const DynamicMatrix<double>& a, const DynamicMatrix<double>& b) {
+    if (a.rows() != b.rows() || a.cols() != b.cols()) {
+        return -1.0;
+    }
+    double difference = 0.0;
+    for (std::size_t i = 0; i < a.rows(); ++i) {
+        for (std::size_t j = 0; j < a.cols(); ++j) {
+            difference = std::max(difference, std::abs(a(i, j) - b(i, j)));
+        }
+    }
+    return difference;
+}
+
+int main() {
+    // Fixed-size: A^T B and A B^T against the products of explicit transposes
+    constexpr Matrix<double, 3, 2> a = {{1.0, 2.0}, {3.0, 4.0}, {5.0, 6.0}};
+    constexpr Matrix<double, 3, 2> b = {{1.0, 0.0}, {0.0, 1.0}, {1.0, 1.0}};
+    constexpr Matrix<double, 2, 2> gram = transpose_multiply(a, a);
+    static_assert(gram(0, 0) == 35.0 && gram(0, 1) == 44.0 && gram(1, 1) == 56.0, "A^T A is evaluated at compile time");
+    std::cout << "A^T B:" << std::endl;
+    transpose_multiply(a, b).display();
+    std::cout << "A B^T:" << std::endl;
+    multiply_transpose(a, b).display();
+    const Matrix<double, 3, 3> explicit_product = a * b.transpose();
+    std::cout << "A B^T vs explicit transpose: "
+              << max_difference(DynamicMatrix<double>(multiply_transpose(a, b)), DynamicMatrix<double>(explicit_product)) << "\n\n";
+
+    // Dynamic: every flag combination, large enough to take the packed kernel
+    const DynamicMatrix<double> x = filled(150, 200, 0.0);
+    const DynamicMatrix<double> y = filled(200, 170, 1.0);
+    const DynamicMatrix<double> xt = x.transpose();
+    const DynamicMatrix<double> yt = y.transpose();
+    const DynamicMatrix<double> reference = x * y;
+    DynamicMatrix<double> c;
+    multiply_into(c, x, y);
+    std::cout << "op(A) = A,   op(B) = B:   " << max_difference(c, reference) << std::endl;
+    multiply_into(c, xt, y, Transpose::Yes, Transpose::No);
+    std::cout << "op(A) = A^T, op(B) = B:   " << max_difference(c, reference) << std::endl;
+    multiply_into(c, x, yt, Transpose::No, Transpose::Yes);
+    std::cout << "op(A) = A,   op(B) = B^T: " << max_difference(c, reference) << std::endl;
+    multiply_into(c, xt, yt, Transpose::Yes, Transpose::Yes);
+    std::cout << "op(A) = A^T, op(B) = B^T: " << max_difference(c, reference) << std::endl;
+    std::cout << "transpose_multiply(X, X) vs X^T X: " << max_difference(transpose_multiply(x, x), xt * x) << std::endl;
+    std::cout << "multiply_transpose(X, X) vs X X^T: " << max_difference(multiply_transpose(x, x), x * xt) << std::endl;
+    try {
+        multiply_into(c, x, y, Transpose::Yes, Transpose::No);
+    } catch (const std::invalid_argument& e) {
+        std::cout << "Mismatched op(A) op(B): " << e.what() << std::endl;
+    }
+
+    // Transposed views go through the same kernel
+    DynamicMatrix<double> view_result(200, 200);
+    multiply(MatrixView<const double>(x).transpose(), MatrixView<const double>(x), MatrixView<double>(view_result));
+    std::cout << "View product X^T X: " << max_difference(view_result, xt * x) << "\n\n";
+
+    // Cache-oblivious transpose on awkward shapes, against an element loop
+    for (auto [rows, cols] : {std::pair<std::size_t, std::size_t>{1000, 37}, {129, 257}, {1, 300}, {513, 513}}) {
+        const DynamicMatrix<double> m = filled(rows, cols, 2.0);
+        DynamicMatrix<double> expected(cols, rows);
+        for (std::size_t i = 0; i < rows; ++i) {
+            for (std::size_t j = 0; j < cols; ++j) {
+                expected(j, i) = m(i, j);
+            }
+        }
+        DynamicMatrix<double> in_place = m;
+        in_place.transpose_in_place();
+        std::cout << rows << "x" << cols << " transpose: " << max_difference(m.transpose(), expected)
+                  << ", in place: " << max_difference(in_place, expected) << std::endl;
+    }
+    return 0;
+}
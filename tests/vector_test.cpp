@@ -55,5 +55,12 @@ int main() {
     std::cout << "v11 (v1 squared element-wise): " << v11 << std::endl;
     std::cout << "v12 (v1 cubed element-wise): " << v12 << std::endl;
 
+    // Compound expressions are evaluated lazily in a single pass
+    Vector<float, 3> v13 = v1 + v3 * 2.0f - v5;
+    std::cout << "v13 (v1 + v3 * 2 - v5): " << v13 << std::endl;
+    std::cout << "Unevaluated (v1 - v3) * 0.5: " << (v1 - v3) * 0.5f << std::endl;
+    auto with_temporary = v1.square() - v3;
+    std::cout << "v1 squared - v3, kept with auto: " << Vector<float, 3>(with_temporary) << std::endl;
+
     return 0;
 }
\ No newline at end of file
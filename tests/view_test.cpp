@@ -0,0 +1,55 @@
+#include <iostream>
+#include <vector>
+#include "../include/linear_algebra/view.hpp"
+
+using namespace linear_algebra;
+
+int main() {
+    // A 3 x 4 matrix living in an external buffer with a padded leading dimension of 6
+    std::vector<double> buffer(3 * 6, -1.0);
+    MatrixView<double> a(buffer.data(), 3, 4, 6);
+    for (std::size_t i = 0; i < a.rows(); ++i) {
+        for (std::size_t j = 0; j < a.cols(); ++j) {
+            a(i, j) = static_cast<double>(i * 4 + j);
+        }
+    }
+    std::cout << "View over an external buffer:" << std::endl;
+    a.eval().display();
+    std::cout << "\n";
+
+    // Sub-block, transpose and column views share the same memory
+    MatrixView<double> inner = a.block(1, 1, 2, 2);
+    std::cout << "Block (1, 1) 2x2:" << std::endl;
+    inner.eval().display();
+    std::cout << "Transposed view:" << std::endl;
+    a.transpose().eval().display();
+    std::cout << "Column 2: " << a.col(2).eval() << std::endl;
+    inner(0, 0) = 50.0;
+    std::cout << "After writing through the block, a(1, 1) = " << a(1, 1) << std::endl;
+    std::cout << "\n";
+
+    // A^T A computed from the views without copying (expected symmetric)
+    Matrix<double, 4, 4> gram;
+    multiply(MatrixView<const double>(a).transpose(), MatrixView<const double>(a), MatrixView<double>(gram));
+    std::cout << "A^T A:" << std::endl;
+    gram.display();
+    std::cout << "\n";
+
+    // Strided dot product and matrix-vector product into a Vector (expected 116 and (5, 17, 29))
+    Vector<double, 4> x({1.0, 0.0, 1.0, 1.0});
+    Vector<double, 3> y;
+    multiply(MatrixView<const double>(a), VectorView<const double>(x), VectorView<double>(y));
+    std::cout << "Column 0 . column 3: " << dot(a.col(0), a.col(3)) << std::endl;
+    std::cout << "A * x: " << y << std::endl;
+    std::cout << "\n";
+
+    // Copy a transposed view into a fixed-size matrix, then add it back in place
+    Matrix<double, 4, 3> at;
+    copy(a.transpose(), MatrixView<double>(at));
+    add(MatrixView<const double>(at).transpose(), MatrixView<const double>(a), a);
+    std::cout << "A + (A^T)^T:" << std::endl;
+    a.eval().display();
+    std::cout << "Padding untouched: " << buffer[4] << ", " << buffer[5] << std::endl;
+
+    return 0;
+}
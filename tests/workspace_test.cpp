@@ -0,0 +1,100 @@
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include "../include/linear_algebra/dynamic_matrix.hpp"
+
+using namespace linear_algebra;
+
+// Count every trip to the system allocator so the demo can show where they go away
+static std::size_t heap_allocations = 0;
+
+void* operator new(std::size_t bytes) {
+    ++heap_allocations;
+    if (void* p = std::malloc(bytes ? bytes : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t bytes, std::align_val_t alignment) {
+    ++heap_allocations;
+    const std::size_t a = static_cast<std::size_t>(alignment);
+    if (void* p = std::aligned_alloc(a, (bytes + a - 1) / a * a)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+// One gradient-descent step of least squares, w -= rate * X^T (X w - y) / n, written with
+// ordinary operators, plus a small LU solve to exercise a factorization
+void step(const DynamicMatrix<double>& x, const DynamicMatrix<double>& y, DynamicMatrix<double>& w, double rate) {
+    DynamicMatrix<double> residual = x * w - y;
+    DynamicMatrix<double> gradient = x.transpose() * residual * (1.0 / static_cast<double>(x.rows()));
+    w = w - gradient * rate;
+    DynamicMatrix<double> gram = x.transpose() * x;
+    DynamicVector<double> rhs(gram.rows(), 1.0);
+    DynamicVector<double> solution = gram.solve_linear_equations(rhs);
+    if (solution.size() != w.rows()) {
+        std::cout << "unexpected solution size" << std::endl;
+    }
+}
+
+int main() {
+    const std::size_t samples = 256;
+    const std::size_t features = 16;
+    DynamicMatrix<double> x(samples, features);
+    DynamicMatrix<double> y(samples, 1);
+    for (std::size_t i = 0; i < samples; ++i) {
+        for (std::size_t j = 0; j < features; ++j) {
+            x(i, j) = std::sin(static_cast<double>(i * features + j));
+            y(i, 0) += x(i, j) * static_cast<double>(j + 1);
+        }
+    }
+
+    // Without a workspace every temporary is a heap allocation
+    const int steps = 200;
+    DynamicMatrix<double> reference(features, 1);
+    std::size_t before = heap_allocations;
+    for (int iteration = 0; iteration < steps; ++iteration) {
+        step(x, y, reference, 0.2);
+    }
+    std::cout << "Heap allocations per step without a workspace: " << (heap_allocations - before) / steps << std::endl;
+
+    // With one scope per iteration the temporaries come from the arena, which is reset in O(1)
+    Workspace workspace(4096);
+    DynamicMatrix<double> w(features, 1);
+    for (int iteration = 0; iteration < steps; ++iteration) {
+        before = heap_allocations;
+        {
+            WorkspaceScope scope(workspace);
+            step(x, y, w, 0.2);
+        }
+        if (iteration < 3 || iteration == steps - 1) {
+            std::cout << "Step " << iteration << ": heap allocations = " << heap_allocations - before
+                      << ", workspace capacity = " << workspace.capacity() << " bytes" << std::endl;
+        }
+    }
+    std::cout << "Workspace high water: " << workspace.high_water() << " bytes, blocks requested: "
+              << workspace.system_allocations() << std::endl;
+
+    // w lives outside the scopes, so it holds the same weights as the heap-only run
+    double difference = 0.0;
+    for (std::size_t i = 0; i < features; ++i) {
+        difference = std::max(difference, std::abs(w(i, 0) - reference(i, 0)));
+    }
+    std::cout << "Largest weight difference to the heap-only run: " << difference << std::endl;
+
+    // Assigning to a container created outside the scope copies the result into heap storage
+    DynamicMatrix<double> kept;
+    {
+        WorkspaceScope scope(workspace);
+        kept = x.transpose() * x;
+    }
+    std::cout << "Kept Gram matrix diagonal entry: " << kept(0, 0) << std::endl;
+    return 0;
+}